@@ -0,0 +1,317 @@
+#include "BlockCompression.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+/// <summary>
+/// Packs a colour into 5:6:5 bits, rounding to the nearest.
+/// </summary>
+static unsigned short PackColour(const float colour[3])
+{
+	int r = (int)(colour[0] * 31.0f / 255.0f + 0.5f);
+	int g = (int)(colour[1] * 63.0f / 255.0f + 0.5f);
+	int b = (int)(colour[2] * 31.0f / 255.0f + 0.5f);
+	r = r < 0 ? 0 : r > 31 ? 31 : r;
+	g = g < 0 ? 0 : g > 63 ? 63 : g;
+	b = b < 0 ? 0 : b > 31 ? 31 : b;
+	return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+/// <summary>
+/// Expands a 5:6:5 colour back to 8 bits per channel.
+/// </summary>
+static void UnpackColour(unsigned short packed, int colour[3])
+{
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+	colour[0] = (r << 3) | (r >> 2);
+	colour[1] = (g << 2) | (g >> 4);
+	colour[2] = (b << 3) | (b >> 2);
+}
+
+/// <summary>
+/// Returns the 4 colours a colour block can pick from. With the first endpoint not above the second, BC1 has
+/// 3 colours and a transparent black instead.
+/// </summary>
+static void GetPalette(unsigned short colour0, unsigned short colour1, bool fourColours, int palette[4][4])
+{
+	UnpackColour(colour0, palette[0]);
+	UnpackColour(colour1, palette[1]);
+	palette[0][3] = 255;
+	palette[1][3] = 255;
+	for (int c = 0; c < 3; c++)
+	{
+		if (fourColours)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		else
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = fourColours ? 255 : 0;
+}
+
+/// <summary>
+/// Compresses the colours of a block of 16 pixels into 8 bytes, always in the 4 colours mode.
+/// </summary>
+static void EncodeColourBlock(const unsigned char pixels[64], unsigned char* output)
+{
+	// The principal axis of the colours, found by a few power iterations on their covariance.
+	float mean[3] = { 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+			mean[c] += pixels[i * 4 + c];
+	}
+	for (int c = 0; c < 3; c++)
+		mean[c] /= 16.0f;
+
+	float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }; // rr, rg, rb, gg, gb, bb
+	for (int i = 0; i < 16; i++)
+	{
+		float r = pixels[i * 4] - mean[0];
+		float g = pixels[i * 4 + 1] - mean[1];
+		float b = pixels[i * 4 + 2] - mean[2];
+		covariance[0] += r * r;
+		covariance[1] += r * g;
+		covariance[2] += r * b;
+		covariance[3] += g * g;
+		covariance[4] += g * b;
+		covariance[5] += b * b;
+	}
+
+	float axis[3] = { 1.0f, 1.0f, 1.0f };
+	for (int iteration = 0; iteration < 4; iteration++)
+	{
+		float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+		float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+		float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+		float length = std::sqrt(x * x + y * y + z * z);
+		if (length < 1e-6f)
+			break;
+		axis[0] = x / length;
+		axis[1] = y / length;
+		axis[2] = z / length;
+	}
+
+	// The endpoints are the extreme colours along the axis.
+	float lowest = 1e30f, highest = -1e30f;
+	for (int i = 0; i < 16; i++)
+	{
+		float projection = (pixels[i * 4] - mean[0]) * axis[0] + (pixels[i * 4 + 1] - mean[1]) * axis[1] + (pixels[i * 4 + 2] - mean[2]) * axis[2];
+		lowest = projection < lowest ? projection : lowest;
+		highest = projection > highest ? projection : highest;
+	}
+	float end0[3], end1[3];
+	for (int c = 0; c < 3; c++)
+	{
+		end0[c] = mean[c] + axis[c] * highest;
+		end1[c] = mean[c] + axis[c] * lowest;
+	}
+
+	unsigned short colour0 = PackColour(end0);
+	unsigned short colour1 = PackColour(end1);
+	if (colour0 < colour1)
+	{
+		unsigned short swap = colour0;
+		colour0 = colour1;
+		colour1 = swap;
+	}
+
+	// Equal endpoints would be read in the 3 colours mode, every pixel uses the first endpoint then.
+	unsigned int indices = 0;
+	if (colour0 != colour1)
+	{
+		int palette[4][4];
+		GetPalette(colour0, colour1, true, palette);
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 0;
+			int bestDistance = 0x7fffffff;
+			for (int p = 0; p < 4; p++)
+			{
+				int r = pixels[i * 4] - palette[p][0];
+				int g = pixels[i * 4 + 1] - palette[p][1];
+				int b = pixels[i * 4 + 2] - palette[p][2];
+				int distance = r * r + g * g + b * b;
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = p;
+				}
+			}
+			indices |= (unsigned int)best << (i * 2);
+		}
+	}
+
+	output[0] = (unsigned char)(colour0 & 0xff);
+	output[1] = (unsigned char)(colour0 >> 8);
+	output[2] = (unsigned char)(colour1 & 0xff);
+	output[3] = (unsigned char)(colour1 >> 8);
+	output[4] = (unsigned char)(indices & 0xff);
+	output[5] = (unsigned char)((indices >> 8) & 0xff);
+	output[6] = (unsigned char)((indices >> 16) & 0xff);
+	output[7] = (unsigned char)(indices >> 24);
+}
+
+/// <summary>
+/// Returns the 8 alphas an alpha block can pick from, in the 8 alphas mode used by the encoder.
+/// </summary>
+static void GetAlphaPalette(int alpha0, int alpha1, int palette[8])
+{
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+	if (alpha0 > alpha1)
+	{
+		for (int i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+	}
+	else
+	{
+		for (int i = 1; i < 5; i++)
+			palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+/// <summary>
+/// Compresses the alphas of a block of 16 pixels into 8 bytes.
+/// </summary>
+static void EncodeAlphaBlock(const unsigned char pixels[64], unsigned char* output)
+{
+	int alpha0 = 0, alpha1 = 255;
+	for (int i = 0; i < 16; i++)
+	{
+		int alpha = pixels[i * 4 + 3];
+		alpha0 = alpha > alpha0 ? alpha : alpha0;
+		alpha1 = alpha < alpha1 ? alpha : alpha1;
+	}
+
+	unsigned long long indices = 0;
+	if (alpha0 != alpha1)
+	{
+		int palette[8];
+		GetAlphaPalette(alpha0, alpha1, palette);
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 0;
+			int bestDistance = 256;
+			for (int p = 0; p < 8; p++)
+			{
+				int distance = std::abs(pixels[i * 4 + 3] - palette[p]);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = p;
+				}
+			}
+			indices |= (unsigned long long)best << (i * 3);
+		}
+	}
+
+	output[0] = (unsigned char)alpha0;
+	output[1] = (unsigned char)alpha1;
+	for (int i = 0; i < 6; i++)
+		output[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xff);
+}
+
+/// <summary>
+/// Copies the 4x4 block at a block position, repeating the edge pixels past the image.
+/// </summary>
+static void GetBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY, unsigned char pixels[64])
+{
+	for (int y = 0; y < 4; y++)
+	{
+		int sourceY = blockY * 4 + y;
+		sourceY = sourceY < height ? sourceY : height - 1;
+		for (int x = 0; x < 4; x++)
+		{
+			int sourceX = blockX * 4 + x;
+			sourceX = sourceX < width ? sourceX : width - 1;
+			memcpy(&pixels[(y * 4 + x) * 4], &rgba[((size_t)sourceY * width + sourceX) * 4], 4);
+		}
+	}
+}
+
+size_t BlockCompression::GetCompressedSize(int width, int height, bool alpha)
+{
+	size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+	return blocks * (alpha ? 16 : 8);
+}
+
+void BlockCompression::Encode(const unsigned char* rgba, int width, int height, bool alpha, unsigned char* output)
+{
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+	unsigned char pixels[64];
+	for (int blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksX; blockX++)
+		{
+			GetBlock(rgba, width, height, blockX, blockY, pixels);
+			if (alpha)
+			{
+				EncodeAlphaBlock(pixels, output);
+				output += 8;
+			}
+			EncodeColourBlock(pixels, output);
+			output += 8;
+		}
+	}
+}
+
+void BlockCompression::Decode(const unsigned char* data, int width, int height, bool alpha, unsigned char* output)
+{
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+	for (int blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksX; blockX++)
+		{
+			int alphas[8];
+			unsigned long long alphaIndices = 0;
+			if (alpha)
+			{
+				GetAlphaPalette(data[0], data[1], alphas);
+				for (int i = 0; i < 6; i++)
+					alphaIndices |= (unsigned long long)data[2 + i] << (i * 8);
+				data += 8;
+			}
+
+			// BC3 colours are always in the 4 colours mode.
+			unsigned short colour0 = (unsigned short)(data[0] | (data[1] << 8));
+			unsigned short colour1 = (unsigned short)(data[2] | (data[3] << 8));
+			unsigned int indices = data[4] | (data[5] << 8) | (data[6] << 16) | ((unsigned int)data[7] << 24);
+			int palette[4][4];
+			GetPalette(colour0, colour1, alpha || colour0 > colour1, palette);
+			data += 8;
+
+			for (int y = 0; y < 4; y++)
+			{
+				int pixelY = blockY * 4 + y;
+				if (pixelY >= height)
+					break;
+				for (int x = 0; x < 4; x++)
+				{
+					int pixelX = blockX * 4 + x;
+					if (pixelX >= width)
+						break;
+					int i = y * 4 + x;
+					const int* colour = palette[(indices >> (i * 2)) & 3];
+					unsigned char* pixel = &output[((size_t)pixelY * width + pixelX) * 4];
+					pixel[0] = (unsigned char)colour[0];
+					pixel[1] = (unsigned char)colour[1];
+					pixel[2] = (unsigned char)colour[2];
+					pixel[3] = (unsigned char)(alpha ? alphas[(alphaIndices >> (i * 3)) & 7] : colour[3]);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+
+/// <summary>
+/// BC1 and BC3 (DXT1 and DXT5) block compression of RGBA8 images, the formats of GL_EXT_texture_compression_s3tc.
+/// An image is cut into blocks of 4x4 pixels, each stored as two endpoint colours and a 2 bit index per pixel picking
+/// one of 4 colours between them (8 bytes), BC3 adding an alpha block with two endpoints and 3 bit indices (16 bytes).
+/// The encoder fits the endpoints along the principal axis of the colours of each block. The decoder is there for
+/// drivers without the extension, which get the decoded pixels instead.
+/// </summary>
+class BlockCompression
+{
+	public:
+		/// <summary>
+		/// Returns the size of an image once compressed. Edge blocks are whole blocks, padded by repeating the edge pixels.
+		/// </summary>
+		/// <param name="alpha">True for BC3, false for BC1.</param>
+		static size_t GetCompressedSize(int width, int height, bool alpha);
+
+		/// <summary>
+		/// Compresses an image, BC1 ignoring the alpha, or BC3 keeping it.
+		/// </summary>
+		/// <param name="rgba">The pixels, 4 bytes each, row after row.</param>
+		/// <param name="output">Receives GetCompressedSize bytes.</param>
+		static void Encode(const unsigned char* rgba, int width, int height, bool alpha, unsigned char* output);
+
+		/// <summary>
+		/// Decompresses an image written by Encode, or any BC1 or BC3 data.
+		/// </summary>
+		/// <param name="output">Receives the pixels, 4 bytes each, row after row.</param>
+		static void Decode(const unsigned char* data, int width, int height, bool alpha, unsigned char* output);
+};
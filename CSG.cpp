@@ -0,0 +1,387 @@
+#include "CSG.h"
+#include <cmath>
+#include <unordered_set>
+#include <algorithm>
+
+// Tolerance used to decide if a point is on a plane.
+static const float PLANE_EPSILON = 1e-5f;
+
+// Polygons are only ever cut into convex pieces, each cut adds at most one vertex.
+static const int MAX_POLYGON_VERTICES = 64;
+
+// Tolerance used when welding the output vertices back together.
+static const float WELD_EPSILON = 1e-4f;
+
+struct CSGPlane
+{
+	glm::vec3 normal;
+	float w;
+
+	float Distance(const glm::vec3& point) const
+	{
+		return glm::dot(normal, point) - w;
+	}
+};
+
+/// <summary>
+/// A convex solid, described by the planes of its faces (normals pointing outwards) and its bounding box.
+/// </summary>
+struct ConvexSolid
+{
+	std::vector<CSGPlane> planes;
+	glm::vec3 min, max;
+};
+
+typedef std::vector<glm::vec3> CSGPolygon;
+
+enum
+{
+	COPLANAR = 0,
+	FRONT = 1,
+	BACK = 2,
+	SPANNING = 3
+};
+
+/// <summary>
+/// Builds the plane set of a closed convex mesh. Coplanar triangles (the two halves of a quad) share a single plane.
+/// </summary>
+static ConvexSolid ToConvexSolid(const MeshData& mesh)
+{
+	ConvexSolid solid;
+	solid.min = glm::vec3(1e30f);
+	solid.max = glm::vec3(-1e30f);
+
+	for (unsigned int i = 0; i < mesh.VertexCount(); i++)
+	{
+		solid.min = glm::min(solid.min, mesh.GetVertex(i));
+		solid.max = glm::max(solid.max, mesh.GetVertex(i));
+	}
+
+	std::unordered_set<long long> seen;
+	for (int i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		glm::vec3 a = mesh.GetVertex(mesh.indices[i]);
+		glm::vec3 n = glm::cross(mesh.GetVertex(mesh.indices[i + 1]) - a, mesh.GetVertex(mesh.indices[i + 2]) - a);
+		float area = glm::length(n);
+		if (area < 1e-10f)
+			continue;
+
+		CSGPlane plane;
+		plane.normal = n / area;
+		plane.w = glm::dot(plane.normal, a);
+
+		// Quantized key, so the second triangle of a quad does not add the same plane again.
+		long long key = (long long)std::floor(plane.normal.x * 1e4f) * 73856093LL
+			^ (long long)std::floor(plane.normal.y * 1e4f) * 19349663LL
+			^ (long long)std::floor(plane.normal.z * 1e4f) * 83492791LL
+			^ (long long)std::floor(plane.w * 1e4f) * 2654435761LL;
+		if (!seen.insert(key).second)
+			continue;
+
+		solid.planes.push_back(plane);
+	}
+
+	return solid;
+}
+
+/// <summary>
+/// Returns which side(s) of a plane a polygon lies on.
+/// </summary>
+static int ClassifyPolygon(const CSGPlane& plane, const CSGPolygon& polygon, int* types)
+{
+	int polygonType = 0;
+
+	for (int i = 0; i < polygon.size(); i++)
+	{
+		float t = plane.Distance(polygon[i]);
+		types[i] = (t < -PLANE_EPSILON) ? BACK : (t > PLANE_EPSILON) ? FRONT : COPLANAR;
+		polygonType |= types[i];
+	}
+
+	return polygonType;
+}
+
+/// <summary>
+/// Splits a polygon by a plane. Returns which side(s) of the plane the polygon lies on, the pieces are only filled when it spans both.
+/// </summary>
+static int SplitPolygon(const CSGPlane& plane, const CSGPolygon& polygon, CSGPolygon& front, CSGPolygon& back)
+{
+	int types[MAX_POLYGON_VERTICES + 1];
+	int count = (int)polygon.size();
+	int polygonType = ClassifyPolygon(plane, polygon, types);
+
+	if (polygonType != SPANNING)
+		return polygonType;
+
+	front.clear();
+	back.clear();
+	for (int i = 0; i < count; i++)
+	{
+		int j = (i + 1) % count;
+		const glm::vec3& vi = polygon[i];
+		const glm::vec3& vj = polygon[j];
+
+		if (types[i] != BACK) front.push_back(vi);
+		if (types[i] != FRONT) back.push_back(vi);
+
+		// The edge crosses the plane, so both pieces get the intersection point.
+		if ((types[i] | types[j]) == SPANNING)
+		{
+			float t = -plane.Distance(vi) / glm::dot(plane.normal, vj - vi);
+			glm::vec3 v = glm::mix(vi, vj, t);
+			front.push_back(v);
+			back.push_back(v);
+		}
+	}
+
+	return SPANNING;
+}
+
+/// <summary>
+/// Clips a polygon to the back of a plane, tagging the new edge with the plane that created it.
+/// tags[i] is the plane that produced the edge going from vertex i to vertex i + 1, or -1 for an original edge.
+/// </summary>
+static void ClipBehind(const CSGPlane& plane, int planeIndex, CSGPolygon& polygon, std::vector<int>& tags)
+{
+	CSGPolygon clipped;
+	std::vector<int> clippedTags;
+	int count = (int)polygon.size();
+
+	for (int i = 0; i < count; i++)
+	{
+		int j = (i + 1) % count;
+		float di = plane.Distance(polygon[i]);
+		float dj = plane.Distance(polygon[j]);
+		bool iBehind = di <= PLANE_EPSILON;
+		bool jBehind = dj <= PLANE_EPSILON;
+
+		if (iBehind)
+		{
+			clipped.push_back(polygon[i]);
+			clippedTags.push_back(tags[i]);
+		}
+
+		if (iBehind != jBehind)
+		{
+			// The edge crosses the plane. Leaving the back side, the rest of the edge is replaced by the plane's own edge.
+			float t = di / (di - dj);
+			clipped.push_back(glm::mix(polygon[i], polygon[j], t));
+			clippedTags.push_back(iBehind ? planeIndex : tags[i]);
+		}
+	}
+
+	polygon.swap(clipped);
+	tags.swap(clippedTags);
+}
+
+/// <summary>
+/// Removes the part of a polygon that lies inside a convex solid, adding the pieces left outside to the output.
+/// </summary>
+/// <param name="polygon">Polygon to clip, from a face whose outward normal is polygonNormal.</param>
+/// <param name="solid">The solid to cut away.</param>
+/// <param name="keepShared">Whether a face lying on a same-facing face of the solid is kept or dropped.</param>
+/// <param name="output">The pieces outside of the solid.</param>
+static void ClipOutside(const CSGPolygon& polygon, const glm::vec3& polygonNormal, const ConvexSolid& solid, bool keepShared, std::vector<CSGPolygon>& output)
+{
+	// First find the inside part: what is behind every plane of the solid.
+	CSGPolygon inside = polygon;
+	std::vector<int> tags(polygon.size(), -1);
+	CSGPolygon front, back;
+	int types[MAX_POLYGON_VERTICES + 1];
+
+	for (int i = 0; i < solid.planes.size(); i++)
+	{
+		if (inside.size() >= MAX_POLYGON_VERTICES)
+		{
+			// Should not happen with sane meshes. Keeping the polygon is safe, it is only hidden overdraw.
+			output.push_back(polygon);
+			return;
+		}
+
+		int type = ClassifyPolygon(solid.planes[i], inside, types);
+
+		if (type == FRONT || (type == COPLANAR && keepShared && glm::dot(solid.planes[i].normal, polygonNormal) > 0))
+		{
+			// Separated from the solid by this plane, nothing to remove.
+			output.push_back(polygon);
+			return;
+		}
+
+		if (type == SPANNING)
+		{
+			ClipBehind(solid.planes[i], i, inside, tags);
+		}
+	}
+
+	// Only the planes bordering the final inside part matter. Cutting by every plane that crossed the polygon on
+	// the way would chop it along lines that stop being relevant further down, and shred it for nothing.
+	std::vector<int> borders;
+	for (int i = 0; i < tags.size(); i++)
+	{
+		if (tags[i] >= 0 && std::find(borders.begin(), borders.end(), tags[i]) == borders.end())
+			borders.push_back(tags[i]);
+	}
+
+	// Peel the outside pieces off one bordering plane at a time, what is left at the end is the inside part and is dropped.
+	CSGPolygon current = polygon;
+	for (int i = 0; i < borders.size(); i++)
+	{
+		if (current.size() >= MAX_POLYGON_VERTICES)
+		{
+			// Should not happen with sane meshes. Keeping the piece is safe, it is only hidden overdraw.
+			output.push_back(current);
+			return;
+		}
+
+		if (SplitPolygon(solid.planes[borders[i]], current, front, back) == SPANNING)
+		{
+			output.push_back(front);
+			current.swap(back);
+		}
+	}
+}
+
+static bool BoundsOverlap(const glm::vec3& minA, const glm::vec3& maxA, const glm::vec3& minB, const glm::vec3& maxB)
+{
+	return minA.x <= maxB.x + PLANE_EPSILON && maxA.x + PLANE_EPSILON >= minB.x
+		&& minA.y <= maxB.y + PLANE_EPSILON && maxA.y + PLANE_EPSILON >= minB.y
+		&& minA.z <= maxB.z + PLANE_EPSILON && maxA.z + PLANE_EPSILON >= minB.z;
+}
+
+/// <summary>
+/// Splits the edges that pass through a vertex of another triangle. A cut leaves its new vertices on the edges of the
+/// neighbouring pieces, and such T-junctions crack under rasterization: the edge and the two edges meeting at the vertex
+/// are not rasterized from the same endpoints. Every triangle is split at those vertices until no edge has any.
+/// </summary>
+static void SplitTJunctions(MeshData& mesh)
+{
+	// Vertices sorted by X, so only the ones within the X range of an edge are tested.
+	std::vector<unsigned int> byX(mesh.VertexCount());
+	for (unsigned int i = 0; i < byX.size(); i++)
+		byX[i] = i;
+	std::sort(byX.begin(), byX.end(), [&](unsigned int a, unsigned int b) { return mesh.vertices[a * 3] < mesh.vertices[b * 3]; });
+	std::vector<float> sortedX(byX.size());
+	for (unsigned int i = 0; i < byX.size(); i++)
+		sortedX[i] = mesh.vertices[byX[i] * 3];
+
+	std::vector<unsigned int> pending(mesh.indices.rbegin(), mesh.indices.rend());
+	std::vector<unsigned int> split;
+	split.reserve(mesh.indices.size());
+	while (pending.size() >= 3)
+	{
+		unsigned int triangle[3];
+		for (int i = 0; i < 3; i++)
+		{
+			triangle[i] = pending.back();
+			pending.pop_back();
+		}
+
+		bool splitTriangle = false;
+		for (int e = 0; e < 3 && !splitTriangle; e++)
+		{
+			unsigned int p = triangle[e], q = triangle[(e + 1) % 3], r = triangle[(e + 2) % 3];
+			glm::vec3 start = mesh.GetVertex(p);
+			glm::vec3 edge = mesh.GetVertex(q) - start;
+			float length = glm::length(edge);
+			if (length <= 2.0f * WELD_EPSILON)
+				continue;
+			glm::vec3 direction = edge / length;
+
+			float minX = std::min(start.x, start.x + edge.x) - WELD_EPSILON;
+			float maxX = std::max(start.x, start.x + edge.x) + WELD_EPSILON;
+			for (size_t i = std::lower_bound(sortedX.begin(), sortedX.end(), minX) - sortedX.begin(); i < sortedX.size() && sortedX[i] <= maxX; i++)
+			{
+				unsigned int v = byX[i];
+				if (v == p || v == q || v == r)
+					continue;
+				glm::vec3 offset = mesh.GetVertex(v) - start;
+				float along = glm::dot(offset, direction);
+				if (along <= WELD_EPSILON || along >= length - WELD_EPSILON || glm::length(offset - direction * along) > WELD_EPSILON)
+					continue;
+
+				// p v r and v q r keep the winding of p q r. Both go back on the list, their edges may hold more vertices.
+				unsigned int halves[6] = { p, v, r, v, q, r };
+				for (int h = 5; h >= 0; h--)
+					pending.push_back(halves[h]);
+				splitTriangle = true;
+				break;
+			}
+		}
+
+		if (!splitTriangle)
+			split.insert(split.end(), triangle, triangle + 3);
+	}
+	mesh.indices.swap(split);
+}
+
+MeshData CSG::Union(const std::vector<MeshData>& solids)
+{
+	std::vector<ConvexSolid> convexSolids;
+	for (int i = 0; i < solids.size(); i++)
+	{
+		convexSolids.push_back(ToConvexSolid(solids[i]));
+	}
+
+	MeshData result;
+	std::vector<CSGPolygon> pieces, clipped;
+
+	for (int i = 0; i < solids.size(); i++)
+	{
+		const MeshData& mesh = solids[i];
+
+		for (int t = 0; t + 2 < mesh.indices.size(); t += 3)
+		{
+			CSGPolygon triangle;
+			triangle.push_back(mesh.GetVertex(mesh.indices[t]));
+			triangle.push_back(mesh.GetVertex(mesh.indices[t + 1]));
+			triangle.push_back(mesh.GetVertex(mesh.indices[t + 2]));
+
+			glm::vec3 n = glm::cross(triangle[1] - triangle[0], triangle[2] - triangle[0]);
+			if (glm::length(n) < 1e-10f)
+				continue;
+			n = glm::normalize(n);
+
+			glm::vec3 triangleMin = glm::min(glm::min(triangle[0], triangle[1]), triangle[2]);
+			glm::vec3 triangleMax = glm::max(glm::max(triangle[0], triangle[1]), triangle[2]);
+
+			// Cut the triangle by every other solid it could touch.
+			pieces.clear();
+			pieces.push_back(triangle);
+			for (int j = 0; j < solids.size() && !pieces.empty(); j++)
+			{
+				if (j == i || !BoundsOverlap(triangleMin, triangleMax, convexSolids[j].min, convexSolids[j].max))
+					continue;
+
+				clipped.clear();
+				for (int p = 0; p < pieces.size(); p++)
+				{
+					// Shared faces are kept on the first solid only.
+					ClipOutside(pieces[p], n, convexSolids[j], i < j, clipped);
+				}
+				pieces.swap(clipped);
+			}
+
+			// Fan the remaining convex pieces back into triangles.
+			for (int p = 0; p < pieces.size(); p++)
+			{
+				unsigned int first = result.VertexCount();
+				for (int v = 0; v < pieces[p].size(); v++)
+				{
+					result.vertices.push_back(pieces[p][v].x);
+					result.vertices.push_back(pieces[p][v].y);
+					result.vertices.push_back(pieces[p][v].z);
+				}
+				for (int v = 2; v < pieces[p].size(); v++)
+				{
+					result.indices.push_back(first);
+					result.indices.push_back(first + v - 1);
+					result.indices.push_back(first + v);
+				}
+			}
+		}
+	}
+
+	result.Weld(WELD_EPSILON);
+	SplitTJunctions(result);
+	return result;
+}
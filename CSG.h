@@ -0,0 +1,21 @@
+#pragma once
+#include "MeshData.h"
+#include <vector>
+
+/// <summary>
+/// Constructive solid geometry on closed triangle meshes.
+/// Used to bake the overlapping cubes and spheres of a letter into a single shell, so the
+/// triangles buried inside other primitives are never uploaded or rasterized.
+/// </summary>
+class CSG
+{
+	public:
+		/// <summary>
+		/// Computes the union of closed convex meshes (cubes, spheres, cylinders, transformed in any way).
+		/// Every surface lying inside another mesh is discarded and surfaces crossing another mesh are cut along the intersection.
+		/// Faces shared by two meshes are kept once if they face the same way, and dropped if they touch back to back.
+		/// </summary>
+		/// <param name="solids">The closed convex meshes to merge.</param>
+		/// <returns>The outer shell of all the meshes, with welded vertices and edges split wherever a vertex lies on them, so it is watertight.</returns>
+		static MeshData Union(const std::vector<MeshData>& solids);
+};
@@ -1,9 +1,11 @@
 #include "Camera.h"
+#include "Redraw.h"
 
 
 Camera::Camera(glm::vec3 position, glm::vec3 up, GLfloat yaw, GLfloat pitch, GLfloat movementSpeed, GLfloat turnSpeed){
 
 	this->position = position;
+	this->previousPosition = position;
 	this->worldUp = up;
 	this->yaw = yaw;
 	this->pitch = pitch;
@@ -26,10 +28,14 @@ void Camera::update() {
 	right = glm::normalize(glm::cross(front, worldUp)); // Find the right vector by getting cross product between front and up
 	up = glm::normalize(glm::cross(right, front)); // Find the up vector by getting cross product between right and front
 
+	Redraw::Request();
+
 }
 
 void Camera::movementFromKeyboard(bool* keys) { // Configure IJKL key movement
 
+	glm::vec3 before = position;
+
 	if (keys[GLFW_KEY_I] && keys[GLFW_KEY_LEFT_SHIFT]) {
 		position += front * movementSpeed; // Go forward
 	}
@@ -46,11 +52,14 @@ void Camera::movementFromKeyboard(bool* keys) { // Configure IJKL key movement
 		position += right * movementSpeed; // Go right
 	}
 
+	if (position != before) Redraw::Request();
+
 }
 
 void Camera::movementFromKeyboard(bool* keys, GLfloat deltatime) { // Configure IJKL key movement
 
 	GLfloat velocity = movementSpeed * deltatime;
+	glm::vec3 before = position;
 
 	if (keys[GLFW_KEY_I] && keys[GLFW_KEY_LEFT_SHIFT]) {
 		position += front * velocity; // Go forward
@@ -68,6 +77,8 @@ void Camera::movementFromKeyboard(bool* keys, GLfloat deltatime) { // Configure
 		position += right * velocity; // Go right
 	}
 
+	if (position != before) Redraw::Request();
+
 }
 
 
@@ -106,6 +117,7 @@ void Camera::magnify(bool* keys, GLfloat z) { // When the down button is pressed
 	if (keys[GLFW_MOUSE_BUTTON_LEFT]) {
 		z *= turnSpeed * 0.01;
 		position += front * z; // Go forward
+		previousPosition += front * z; // Mouse moves are not stepped, they are not drawn between steps either
 
 		update();
 	}
@@ -116,6 +128,15 @@ glm::mat4 Camera::calculateViewMatrix() {
 	return glm::lookAt(position, position + front, up);
 }
 
+glm::mat4 Camera::calculateViewMatrix(GLfloat alpha) {
+	glm::vec3 eye = glm::mix(previousPosition, position, alpha);
+	return glm::lookAt(eye, eye + front, up);
+}
+
+void Camera::beginStep() {
+	previousPosition = position;
+}
+
 glm::mat4 Camera::calculateViewMatrix(glm::vec3 eye, glm::vec3 target, glm::vec3 up) {
 	return glm::lookAt(eye, target, up);
 }
@@ -46,6 +46,16 @@ public:
 	/// <returns>A 4x4 matrix</returns>
 	glm::mat4 calculateViewMatrix();
 	/// <summary>
+	/// Calculates the view matrix between the position before the last simulation step and the current one
+	/// </summary>
+	/// <param name="alpha">How far between the two positions, from 0 to 1</param>
+	/// <returns>A 4x4 matrix</returns>
+	glm::mat4 calculateViewMatrix(GLfloat alpha);
+	/// <summary>
+	/// Remembers the position before a simulation step moves the camera, to draw between the two
+	/// </summary>
+	void beginStep();
+	/// <summary>
 	/// Produces a view matrix based on given parameters
 	/// </summary>
 	/// <param name="eye">The initial position of the camera</param>
@@ -65,6 +75,10 @@ private:
 	/// </summary>
 	glm::vec3 position;
 	/// <summary>
+	/// The position before the last simulation step
+	/// </summary>
+	glm::vec3 previousPosition;
+	/// <summary>
 	/// Defines where the front direction is situated in 3D space
 	/// </summary>
 	glm::vec3 front;
@@ -0,0 +1,126 @@
+#include "CameraBuffer.h"
+#include <GLFW/glfw3.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <cstdio>
+#include <cstring>
+
+CameraBuffer::CameraBuffer()
+{
+	frameIndex = 0;
+	clockOffset = 0.0;
+	for (int i = 0; i < StreamBuffer::FRAME_COUNT; i++)
+	{
+		queries[i] = 0;
+		pending[i] = false;
+		inputTimes[i] = -1.0;
+		latchTimes[i] = 0.0;
+	}
+
+	samples = 0;
+	missed = 0;
+	inputToLatch = 0.0;
+	latchToDrawn = 0.0;
+	inputToDrawn = 0.0;
+	maxInputToDrawn = 0.0;
+}
+
+CameraBuffer::~CameraBuffer()
+{
+	Destroy();
+}
+
+void CameraBuffer::Create()
+{
+	Destroy();
+	stream.Create(sizeof(glm::mat4) * 2);
+	glGenQueries(StreamBuffer::FRAME_COUNT, queries);
+
+	GLint64 gpuTime = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+	clockOffset = glfwGetTime() - gpuTime * 1e-9;
+}
+
+void CameraBuffer::Destroy()
+{
+	stream.Destroy();
+	if (queries[0] != 0)
+	{
+		glDeleteQueries(StreamBuffer::FRAME_COUNT, queries);
+		for (int i = 0; i < StreamBuffer::FRAME_COUNT; i++)
+		{
+			queries[i] = 0;
+			pending[i] = false;
+		}
+	}
+}
+
+void CameraBuffer::BeginFrame()
+{
+	stream.BeginFrame();
+	frameIndex = (frameIndex + 1) % StreamBuffer::FRAME_COUNT;
+	if (pending[frameIndex])
+		ReadLatency(frameIndex);
+}
+
+void CameraBuffer::Latch(const glm::mat4& projection, const glm::mat4& view, double inputTime)
+{
+	StreamSpan span = stream.Allocate(sizeof(glm::mat4) * 2);
+	if (span.data == NULL)
+		return;
+
+	// Laid out as the std140 block, a mat4 is 4 columns of vec4.
+	memcpy(span.data, glm::value_ptr(projection), sizeof(glm::mat4));
+	memcpy((unsigned char*)span.data + sizeof(glm::mat4), glm::value_ptr(view), sizeof(glm::mat4));
+	stream.Commit(span);
+	glBindBufferRange(GL_UNIFORM_BUFFER, BINDING, span.buffer, span.offset, span.size);
+
+	inputTimes[frameIndex] = inputTime;
+	latchTimes[frameIndex] = glfwGetTime();
+}
+
+void CameraBuffer::EndFrame()
+{
+	if (queries[frameIndex] != 0)
+	{
+		glQueryCounter(queries[frameIndex], GL_TIMESTAMP);
+		pending[frameIndex] = true;
+	}
+	stream.EndFrame(); // Its fence comes after the query, the query is done when the region is reused
+}
+
+void CameraBuffer::ReadLatency(int frame)
+{
+	pending[frame] = false;
+
+	// The stream buffer orphans rather than wait when it is not persistent, the query may still be running then.
+	GLint available = 0;
+	glGetQueryObjectiv(queries[frame], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+	{
+		missed++;
+		return;
+	}
+
+	GLuint64 gpuTime = 0;
+	glGetQueryObjectui64v(queries[frame], GL_QUERY_RESULT, &gpuTime);
+	if (inputTimes[frame] < 0.0)
+		return;
+
+	double drawn = gpuTime * 1e-9 + clockOffset;
+	inputToLatch += latchTimes[frame] - inputTimes[frame];
+	latchToDrawn += drawn - latchTimes[frame];
+	inputToDrawn += drawn - inputTimes[frame];
+	maxInputToDrawn = drawn - inputTimes[frame] > maxInputToDrawn ? drawn - inputTimes[frame] : maxInputToDrawn;
+	samples++;
+}
+
+void CameraBuffer::PrintStatistics()
+{
+	if (samples == 0)
+	{
+		printf("Camera latency: no mouse move measured (%d frames not read back)\n", missed);
+		return;
+	}
+	printf("Camera latency: %d mouse moves, %.2f ms to the latch + %.2f ms to drawn = %.2f ms on average, %.2f ms at most (%d frames not read back)\n",
+		samples, inputToLatch * 1000.0 / samples, latchToDrawn * 1000.0 / samples, inputToDrawn * 1000.0 / samples, maxInputToDrawn * 1000.0, missed);
+}
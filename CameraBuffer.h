@@ -0,0 +1,77 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "StreamBuffer.h"
+
+/// <summary>
+/// The CameraBlock uniform block of the shaders (see transform.glsl): the projection and view matrices of a frame.
+/// The block is written by Latch, once the frame has done all its other CPU work, from the last camera the main thread
+/// published (see RenderThread), so the camera drawn is as recent as the frame can make it. It lives in a StreamBuffer,
+/// persistently mapped when the driver allows it: latching is a copy of two matrices, nothing waits.
+/// The time from the mouse move a frame latched to the GPU finishing the frame is measured with timestamp queries,
+/// read back FRAME_COUNT frames later when the GPU is done with them. Scan-out adds to that, it cannot be measured.
+/// </summary>
+class CameraBuffer
+{
+	public:
+		CameraBuffer();
+		~CameraBuffer();
+
+		/// <summary>
+		/// Creates the buffer and the queries, and matches the GPU clock to glfwGetTime.
+		/// </summary>
+		void Create();
+
+		/// <summary>
+		/// Deletes the buffer and the queries, without waiting for the GPU.
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Starts the frame, reading the latency of the frame that last used its region of the buffer.
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Writes the camera of the frame and binds it to BINDING. Called after the last input is read, before the
+		/// first draw.
+		/// </summary>
+		/// <param name="inputTime">The glfwGetTime of the last mouse move the view includes, negative if there was none.</param>
+		void Latch(const glm::mat4& projection, const glm::mat4& view, double inputTime);
+
+		/// <summary>
+		/// Ends the frame. Called after the last draw, before the swap.
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>
+		/// Prints the latency from mouse moves to their camera being drawn.
+		/// </summary>
+		void PrintStatistics();
+
+		static const GLuint BINDING = 1; // The GlyphParts block of TextRenderer is on 0
+
+	private:
+		/// <summary>
+		/// Adds the latency of a finished frame to the statistics.
+		/// </summary>
+		void ReadLatency(int frame);
+
+		// Camera buffers cannot be copied, the copy would delete the queries of the original.
+		CameraBuffer(const CameraBuffer&);
+		CameraBuffer& operator=(const CameraBuffer&);
+
+		StreamBuffer stream;
+		int frameIndex; // Follows the regions of stream
+		double clockOffset; // glfwGetTime minus the GPU timestamp, in seconds
+
+		// Of the frames in flight, by region
+		GLuint queries[StreamBuffer::FRAME_COUNT];
+		bool pending[StreamBuffer::FRAME_COUNT];
+		double inputTimes[StreamBuffer::FRAME_COUNT];
+		double latchTimes[StreamBuffer::FRAME_COUNT];
+
+		// Statistics, in seconds
+		int samples, missed;
+		double inputToLatch, latchToDrawn, inputToDrawn, maxInputToDrawn;
+};
@@ -0,0 +1,192 @@
+#include "CommandBuffer.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <cstring>
+
+// Every command starts with its type and is a multiple of 8 bytes, so each one sits aligned in the block.
+struct alignas(8) BindProgramCommand { CommandType type; GLuint program; };
+struct alignas(8) BindVertexArrayCommand { CommandType type; GLuint vertexArray; GLuint indexBuffer; };
+struct alignas(8) BindUniformBufferCommand { CommandType type; GLuint binding; GLuint buffer; GLintptr offset; GLsizeiptr size; };
+struct alignas(8) SetFloatCommand { CommandType type; GLint location; GLfloat value; };
+struct alignas(8) SetIntCommand { CommandType type; GLint location; GLint value; };
+struct alignas(8) SetMatrixCommand { CommandType type; GLint location; GLfloat matrix[16]; };
+struct alignas(8) SetVertexAttributeCommand { CommandType type; GLuint index; GLfloat value; };
+struct alignas(8) DrawElementsCommand { CommandType type; GLenum mode; GLsizei count; GLenum indexType; const void* offset; };
+struct alignas(8) CallCommand { CommandType type; CommandBuffer::Callback function; void* data; };
+
+CommandBuffer::CommandBuffer()
+{
+	Clear();
+}
+
+void CommandBuffer::Clear()
+{
+	commands.clear();
+	commandCount = 0;
+	drawCount = 0;
+	boundProgram = 0;
+	boundVertexArray = 0;
+	boundIndexBuffer = 0;
+	programBound = false;
+	vertexArrayBound = false;
+}
+
+template <typename T>
+void CommandBuffer::Append(const T& command)
+{
+	size_t size = commands.size();
+	commands.resize(size + sizeof(T));
+	memcpy(&commands[size], &command, sizeof(T));
+	commandCount++;
+}
+
+void CommandBuffer::BindProgram(GLuint program)
+{
+	if (programBound && boundProgram == program)
+		return;
+	BindProgramCommand command = { COMMAND_BIND_PROGRAM, program };
+	Append(command);
+	boundProgram = program;
+	programBound = true;
+}
+
+void CommandBuffer::BindVertexArray(GLuint vertexArray, GLuint indexBuffer)
+{
+	// Meshes sharing the buffers of a whole scene follow each other with the same pair.
+	if (vertexArrayBound && boundVertexArray == vertexArray && boundIndexBuffer == indexBuffer)
+		return;
+	BindVertexArrayCommand command = { COMMAND_BIND_VERTEX_ARRAY, vertexArray, indexBuffer };
+	Append(command);
+	boundVertexArray = vertexArray;
+	boundIndexBuffer = indexBuffer;
+	vertexArrayBound = true;
+}
+
+void CommandBuffer::BindUniformBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	BindUniformBufferCommand command = { COMMAND_BIND_UNIFORM_BUFFER, binding, buffer, offset, size };
+	Append(command);
+}
+
+void CommandBuffer::SetFloat(GLint location, GLfloat value)
+{
+	SetFloatCommand command = { COMMAND_SET_FLOAT, location, value };
+	Append(command);
+}
+
+void CommandBuffer::SetInt(GLint location, GLint value)
+{
+	SetIntCommand command = { COMMAND_SET_INT, location, value };
+	Append(command);
+}
+
+void CommandBuffer::SetMatrix(GLint location, const glm::mat4& matrix)
+{
+	SetMatrixCommand command;
+	command.type = COMMAND_SET_MATRIX;
+	command.location = location;
+	memcpy(command.matrix, glm::value_ptr(matrix), sizeof(command.matrix));
+	Append(command);
+}
+
+void CommandBuffer::SetVertexAttribute(GLuint index, GLfloat value)
+{
+	SetVertexAttributeCommand command = { COMMAND_SET_VERTEX_ATTRIBUTE, index, value };
+	Append(command);
+}
+
+void CommandBuffer::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* offset)
+{
+	DrawElementsCommand command = { COMMAND_DRAW_ELEMENTS, mode, count, type, offset };
+	Append(command);
+	drawCount++;
+}
+
+void CommandBuffer::Call(Callback function, void* data)
+{
+	CallCommand command = { COMMAND_CALL, function, data };
+	Append(command);
+
+	// The function may bind anything, nothing can be assumed still bound after it.
+	programBound = false;
+	vertexArrayBound = false;
+}
+
+void CommandBuffer::Replay() const
+{
+	const unsigned char* position = commands.data();
+	const unsigned char* end = position + commands.size();
+	while (position < end)
+	{
+		switch (*(const CommandType*)position)
+		{
+			case COMMAND_BIND_PROGRAM:
+			{
+				const BindProgramCommand* command = (const BindProgramCommand*)position;
+				glUseProgram(command->program);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_BIND_VERTEX_ARRAY:
+			{
+				const BindVertexArrayCommand* command = (const BindVertexArrayCommand*)position;
+				glBindVertexArray(command->vertexArray);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, command->indexBuffer);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_BIND_UNIFORM_BUFFER:
+			{
+				const BindUniformBufferCommand* command = (const BindUniformBufferCommand*)position;
+				glBindBufferRange(GL_UNIFORM_BUFFER, command->binding, command->buffer, command->offset, command->size);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_SET_FLOAT:
+			{
+				const SetFloatCommand* command = (const SetFloatCommand*)position;
+				glUniform1f(command->location, command->value);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_SET_INT:
+			{
+				const SetIntCommand* command = (const SetIntCommand*)position;
+				glUniform1i(command->location, command->value);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_SET_MATRIX:
+			{
+				const SetMatrixCommand* command = (const SetMatrixCommand*)position;
+				glUniformMatrix4fv(command->location, 1, GL_FALSE, command->matrix);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_SET_VERTEX_ATTRIBUTE:
+			{
+				const SetVertexAttributeCommand* command = (const SetVertexAttributeCommand*)position;
+				glVertexAttrib1f(command->index, command->value);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_DRAW_ELEMENTS:
+			{
+				const DrawElementsCommand* command = (const DrawElementsCommand*)position;
+				glDrawElements(command->mode, command->count, command->indexType, command->offset);
+				position += sizeof(*command);
+				break;
+			}
+			case COMMAND_CALL:
+			{
+				const CallCommand* command = (const CallCommand*)position;
+				command->function(command->data);
+				position += sizeof(*command);
+				break;
+			}
+		}
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glUseProgram(0);
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/// <summary>
+/// The commands a CommandBuffer records.
+/// </summary>
+enum CommandType
+{
+	COMMAND_BIND_PROGRAM,
+	COMMAND_BIND_VERTEX_ARRAY,
+	COMMAND_BIND_UNIFORM_BUFFER,
+	COMMAND_SET_FLOAT,
+	COMMAND_SET_INT,
+	COMMAND_SET_MATRIX,
+	COMMAND_SET_VERTEX_ATTRIBUTE,
+	COMMAND_DRAW_ELEMENTS,
+	COMMAND_CALL
+};
+
+/// <summary>
+/// List of draws and the state they need, recorded on any thread and replayed later on the thread owning the GL
+/// context. Recording only appends plain values to a block of memory, it makes no GL call, so many buffers can be
+/// recorded at once (see ParallelRecorder). Replay is the only part speaking GL: it walks the block in one tight loop.
+/// A buffer starts from no state, so it binds everything its draws use. Binding again the program or vertex array
+/// already bound is dropped while recording.
+/// Work only the GL thread can do, such as loading a texture on first use, is recorded as a call made during replay.
+/// </summary>
+class CommandBuffer
+{
+	public:
+		/// <summary>
+		/// A function called during replay, on the GL thread.
+		/// </summary>
+		typedef void (*Callback)(void* data);
+
+		CommandBuffer();
+
+		/// <summary>
+		/// Empties the buffer, keeping its memory.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Reserves memory for a number of bytes of commands, so recording that much does not allocate.
+		/// </summary>
+		void Reserve(size_t bytes) { commands.reserve(bytes); }
+
+		/// <summary>
+		/// Uses a program for the next draws, 0 for none.
+		/// </summary>
+		void BindProgram(GLuint program);
+
+		/// <summary>
+		/// Uses a vertex array and an index buffer for the next draws.
+		/// </summary>
+		void BindVertexArray(GLuint vertexArray, GLuint indexBuffer);
+
+		/// <summary>
+		/// Binds a range of a buffer to a uniform block binding point, as glBindBufferRange.
+		/// </summary>
+		void BindUniformBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+		/// <summary>
+		/// Sets a float uniform of the program bound.
+		/// </summary>
+		void SetFloat(GLint location, GLfloat value);
+
+		/// <summary>
+		/// Sets an integer or sampler uniform of the program bound.
+		/// </summary>
+		void SetInt(GLint location, GLint value);
+
+		/// <summary>
+		/// Sets a 4x4 matrix uniform of the program bound.
+		/// </summary>
+		void SetMatrix(GLint location, const glm::mat4& matrix);
+
+		/// <summary>
+		/// Sets the constant value of a vertex attribute no buffer feeds.
+		/// </summary>
+		void SetVertexAttribute(GLuint index, GLfloat value);
+
+		/// <summary>
+		/// Draws indices of the vertex array bound, as glDrawElements.
+		/// </summary>
+		void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* offset);
+
+		/// <summary>
+		/// Calls a function during replay, for work that needs the GL context.
+		/// </summary>
+		void Call(Callback function, void* data);
+
+		/// <summary>
+		/// Makes the recorded commands, then unbinds the program and the vertex array. GL thread only.
+		/// </summary>
+		void Replay() const;
+
+		/// <summary>
+		/// Returns the number of commands recorded.
+		/// </summary>
+		int GetCommandCount() const { return commandCount; }
+
+		/// <summary>
+		/// Returns the number of draws recorded.
+		/// </summary>
+		int GetDrawCount() const { return drawCount; }
+
+		/// <summary>
+		/// Returns the bytes recorded.
+		/// </summary>
+		size_t GetSize() const { return commands.size(); }
+
+	private:
+		/// <summary>
+		/// Appends a command, the type being the first member of every command.
+		/// </summary>
+		template <typename T>
+		void Append(const T& command);
+
+		std::vector<unsigned char> commands;
+		int commandCount, drawCount;
+
+		// Last state recorded, to drop binds changing nothing
+		GLuint boundProgram, boundVertexArray, boundIndexBuffer;
+		bool programBound, vertexArrayBound;
+};
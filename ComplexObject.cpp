@@ -1,11 +1,21 @@
 #include "ComplexObject.h"
+#include "IndependentMesh.h"
+#include "CSG.h"
+#include "TextureArray.h"
+#include "Redraw.h"
+#include "RenderSnapshot.h"
 
 
-ComplexObject::ComplexObject()
+ComplexObject::ComplexObject() : ComplexObject(true)
+{
+}
+
+ComplexObject::ComplexObject(bool ownsChildren)
 {
 	meshList = std::vector<Mesh*>();
 	uniformObjectModelLocation = 0;
-	objectModelMatrix = new glm::mat4(1.0f);
+	objectModelMatrix = glm::mat4(1.0f);
+	this->ownsChildren = ownsChildren;
 
 	objectList = std::vector<ComplexObject*>();
 
@@ -17,40 +27,26 @@ ComplexObject::ComplexObject()
 	blue = 0.55f;
 
 	textureHasBeenSet = false;
+	textureLoadTried = false;
+	textureLayer = -1;
 	colourHasBeenSet = false;
 }
 
 ComplexObject::~ComplexObject()
 {
-	// Clears the objectlist
-	for (int i = 0; i < objectList.size(); i++)
-	{
-		objectList[i]->ClearObject();
-	}
+	// Children owned by an arena are destroyed by the arena, all at once.
+	if (!ownsChildren)
+		return;
 
-	// Clean up the meshlist.
+	// Clean up the meshlist. Deleting a mesh clears it from the GPU.
 	for (int i = 0; i < meshList.size(); i++)
 	{
-		meshList[i]->~Mesh();
 		delete meshList[i];
 	}
 
-	if (hasModelMatrix)
-	{
-		// If we have set the model matrix, clean it up.
-		ResetModelMatrix();
-	}
-	else
-	{
-		// If not, just clean the pointer.
-		delete objectModelMatrix;
-		objectModelMatrix = NULL;
-	}
-
 	// Destroy the object list.
 	for (int i = 0; i < objectList.size(); i++)
 	{
-		objectList[i]->~ComplexObject();
 		delete objectList[i];
 	}
 }
@@ -63,12 +59,12 @@ void ComplexObject::RenderObject()
 		// ... we apply it to our children, rendering them with it.
 		for (int i = 0; i < meshList.size(); i++)
 		{
-			meshList[i]->RenderMesh(*objectModelMatrix, uniformObjectModelLocation);
+			meshList[i]->RenderMesh(objectModelMatrix, uniformObjectModelLocation);
 		}
 
 		for (int i = 0; i < objectList.size(); i++)
 		{
-			objectList[i]->RenderObject(*objectModelMatrix, uniformObjectModelLocation);
+			objectList[i]->RenderObject(objectModelMatrix, uniformObjectModelLocation);
 		}
 	}
 	else
@@ -86,16 +82,14 @@ void ComplexObject::RenderObject()
 	}
 }
 
-void ComplexObject::RenderObject(Shader shader)
+void ComplexObject::RenderObject(Shader& shader)
 {
 	shader.setFloat("r", red); // Red
 	shader.setFloat("rg", green); // Green
 	shader.setFloat("rgb", blue); // Blue
 
-	if (textureHasBeenSet) {
-		tex.loadTexture();
-		tex.useTexture();
-		glUniform1i(uniformTextureLocation, 0);
+	if (textureHasBeenSet || textureLayer >= 0) {
+		BindTexture();
 	}
 
 	// If we have a custom transformation...
@@ -104,12 +98,12 @@ void ComplexObject::RenderObject(Shader shader)
 		// ... we apply it to our children, rendering them with it.
 		for (int i = 0; i < meshList.size(); i++)
 		{
-			meshList[i]->RenderMesh(*objectModelMatrix, uniformObjectModelLocation);
+			meshList[i]->RenderMesh(objectModelMatrix, uniformObjectModelLocation);
 		}
 
 		for (int i = 0; i < objectList.size(); i++)
 		{
-			objectList[i]->RenderObject(*objectModelMatrix, uniformObjectModelLocation, shader);
+			objectList[i]->RenderObject(objectModelMatrix, uniformObjectModelLocation, shader);
 		}
 	}
 	else
@@ -133,16 +127,14 @@ void ComplexObject::RenderObject(glm::mat4& modelMatrix, GLuint uniformModel)
 {
 	glm::mat4 model(1.0f);
 
-	if (textureHasBeenSet) {
-		tex.loadTexture();
-		tex.useTexture();
-		glUniform1i(uniformTextureLocation, 0);
+	if (textureHasBeenSet || textureLayer >= 0) {
+		BindTexture();
 	}
 
 	if (hasModelMatrix)
 	{
 		// If we have a custom transformation, we combine it with the provided transformation.
-		model = modelMatrix * *objectModelMatrix;
+		model = modelMatrix * objectModelMatrix;
 	}
 	else
 	{
@@ -163,16 +155,14 @@ void ComplexObject::RenderObject(glm::mat4& modelMatrix, GLuint uniformModel)
 	
 }
 
-void ComplexObject::RenderObject(glm::mat4& modelMatrix, GLuint uniformModel, Shader shader)
+void ComplexObject::RenderObject(glm::mat4& modelMatrix, GLuint uniformModel, Shader& shader)
 {
 	shader.setFloat("r", red); // Red
 	shader.setFloat("rg", green); // Green
 	shader.setFloat("rgb", blue); // Blue
 
-	if (textureHasBeenSet) {
-		tex.loadTexture();
-		tex.useTexture();
-		glUniform1i(uniformTextureLocation, 0);
+	if (textureHasBeenSet || textureLayer >= 0) {
+		BindTexture();
 	}
 
 	glm::mat4 model(1.0f);
@@ -180,7 +170,7 @@ void ComplexObject::RenderObject(glm::mat4& modelMatrix, GLuint uniformModel, Sh
 	if (hasModelMatrix)
 	{
 		// If we have a custom transformation, we combine it with the provided transformation.
-		model = modelMatrix * *objectModelMatrix;
+		model = modelMatrix * objectModelMatrix;
 	}
 	else
 	{
@@ -202,12 +192,45 @@ void ComplexObject::RenderObject(glm::mat4& modelMatrix, GLuint uniformModel, Sh
 }
 
 
+void ComplexObject::CollectDraws(RenderSnapshot& snapshot, Shader& shader, const glm::mat4& modelMatrix)
+{
+	CollectDraws(snapshot, shader, modelMatrix, false, NULL);
+}
+
+void ComplexObject::CollectDraws(RenderSnapshot& snapshot, Shader& shader, const glm::mat4& modelMatrix, bool fromParent, ComplexObject* textured)
+{
+	// Same matrices as RenderObject: our transformation starts a chain, or extends the one of our parent.
+	glm::mat4 model = modelMatrix;
+	bool meshesFromParent = fromParent;
+	if (hasModelMatrix)
+	{
+		model = fromParent ? modelMatrix * objectModelMatrix : objectModelMatrix;
+		meshesFromParent = true;
+	}
+
+	if (textureHasBeenSet || textureLayer >= 0)
+	{
+		textured = this;
+	}
+
+	glm::vec3 colour(red, green, blue);
+	for (int i = 0; i < meshList.size(); i++)
+	{
+		snapshot.AddDraw(meshList[i], &shader, textured, meshList[i]->GetDrawMatrix(model, meshesFromParent), colour);
+	}
+
+	for (int i = 0; i < objectList.size(); i++)
+	{
+		objectList[i]->CollectDraws(snapshot, shader, model, meshesFromParent, textured);
+	}
+}
 
 void ComplexObject::SetColour(GLfloat r, GLfloat g, GLfloat b) {
 
 	red = r;
 	green = g;
 	blue = b;
+	Redraw::Request();
 
 	if (!colourHasBeenSet) {
 		initialR = red;
@@ -224,6 +247,7 @@ void ComplexObject::SetColour(int hex) {
 	red = rgb[0];
 	green = rgb[1];
 	blue = rgb[2];
+	Redraw::Request();
 
 	if (!colourHasBeenSet) {
 		initialR = red;
@@ -237,6 +261,35 @@ void ComplexObject::SetTexture(Texture tex, GLuint textureLocation) {
 	this->tex = tex;
 	uniformTextureLocation = textureLocation;
 	textureHasBeenSet = true;
+	textureLoadTried = false;
+	Redraw::Request();
+}
+
+void ComplexObject::SetTextureLayer(int layer)
+{
+	textureLayer = layer;
+	Redraw::Request();
+}
+
+void ComplexObject::BindTexture()
+{
+	// A layer of the texture array is a constant vertex attribute, it takes no bind.
+	if (textureLayer >= 0)
+	{
+		glVertexAttrib1f(TextureArray::LAYER_ATTRIBUTE, (GLfloat)textureLayer);
+		if (!textureHasBeenSet)
+			return;
+	}
+
+	// Textures given by path only are loaded when first drawn, textures already loaded are just bound.
+	if (tex.getTextureID() == 0 && !textureLoadTried)
+	{
+		tex.loadTexture();
+		textureLoadTried = true;
+	}
+
+	tex.useTexture();
+	glUniform1i(uniformTextureLocation, 0);
 }
 
 void ComplexObject::ClearObject()
@@ -254,43 +307,126 @@ void ComplexObject::ClearObject()
 	}	
 }
 
-void ComplexObject::SetModelMatrix(glm::mat4& matrix, GLuint uniformModelLocation)
+MeshData ComplexObject::UnionMeshes() const
+{
+	std::vector<MeshData> parts;
+
+	// Gather the geometry of every bakeable mesh, placed where the mesh draws it.
+	for (int i = 0; i < meshList.size(); i++)
+	{
+		MeshData* source = meshList[i]->GetSourceData();
+		if (source == NULL)
+			continue;
+
+		glm::mat4 partModel(1.0f);
+		IndependentMesh* independentMesh = dynamic_cast<IndependentMesh*>(meshList[i]);
+		if (independentMesh != NULL)
+		{
+			partModel = independentMesh->GetModelMatrix();
+		}
+
+		MeshData part;
+		part.Append(*source, partModel);
+		parts.push_back(part);
+	}
+
+	return CSG::Union(parts);
+}
+
+int ComplexObject::BakeMeshes(GLuint uniformModelLocation, const MeshData* baked)
 {
-	if (hasModelMatrix) {
-		// Removing the model matrix from gpu
-		glUniform1f((*this).uniformObjectModelLocation, 0.0f);
+	std::vector<Mesh*> remaining;
+	int partCount = 0;
+	int trianglesBefore = 0;
+
+	for (int i = 0; i < meshList.size(); i++)
+	{
+		if (meshList[i]->GetSourceData() == NULL)
+		{
+			remaining.push_back(meshList[i]);
+			continue;
+		}
+
+		partCount++;
+		trianglesBefore += meshList[i]->GetTriangleCount();
 	}
 
-	*objectModelMatrix = matrix;
+	// Nothing to merge.
+	if (partCount < 2)
+		return 0;
+
+	MeshData* bakedData = baked != NULL ? new MeshData(*baked) : new MeshData(UnionMeshes());
+	int trianglesRemoved = trianglesBefore - (int)bakedData->TriangleCount();
+
+	// The baked geometry is already placed, so it is drawn with an identity matrix.
+	glm::mat4 identity(1.0f);
+	IndependentMesh* bakedMesh = new IndependentMesh();
+	bakedMesh->CreateMesh(bakedData);
+	bakedMesh->SetModelMatrix(identity, uniformModelLocation);
+
+	// Clean up the meshes that were baked. Meshes of an arena stay until the arena is released.
+	for (int i = 0; i < meshList.size(); i++)
+	{
+		if (meshList[i]->GetSourceData() != NULL && ownsChildren)
+		{
+			delete meshList[i];
+		}
+	}
+
+	meshList = remaining;
+	meshList.push_back(bakedMesh);
+
+	return trianglesRemoved;
+}
+
+void ComplexObject::SetModelMatrix(glm::mat4& matrix, GLuint uniformModelLocation)
+{
+	// Only kept on the CPU, the draws carry it to the GPU (see CollectDraws)
+	objectModelMatrix = matrix;
 	uniformObjectModelLocation = uniformModelLocation;
 
 	hasModelMatrix = true;
+	Redraw::Request();
 }
 
 void ComplexObject::ResetModelMatrix()
 {
 	hasModelMatrix = false;
-
-	// Removing the model matrix from gpu
-	glUniform1f((*this).uniformObjectModelLocation, 0.0f);
-
 	uniformObjectModelLocation = 0;
 
-	delete objectModelMatrix;
-	objectModelMatrix = NULL;
+	objectModelMatrix = glm::mat4(1.0f);
+	Redraw::Request();
 }
 
 glm::mat4& ComplexObject::GetModelMatrix()
 {
-	if (hasModelMatrix)
-		return *objectModelMatrix;
-	else
-	{
-		// If no matrix has been set for this object, we return a generic identity matrix.
-		// Could throw an exception too, because if someone tries to modify that generic matrix, it wont change this object's matrix.
-		glm::mat4 model = glm::mat4(1.0f);
-		return model;
-	}
+	// The identity while no matrix has been set for this object. Changing it does not set one, see SetModelMatrix.
+	return objectModelMatrix;
+}
+
+bool ComplexObject::HasModelMatrix()
+{
+	return hasModelMatrix;
+}
+
+bool ComplexObject::HasColour()
+{
+	return colourHasBeenSet;
+}
+
+glm::vec3 ComplexObject::GetColour()
+{
+	return glm::vec3(red, green, blue);
+}
+
+bool ComplexObject::HasTexture()
+{
+	return textureHasBeenSet;
+}
+
+Texture& ComplexObject::GetTexture()
+{
+	return tex;
 }
 
 void ComplexObject::TranslateModel(GLfloat x, GLfloat y, GLfloat z)
@@ -379,6 +515,10 @@ void ComplexObject::Transform(bool* keys)
 		green = initialG;
 		blue = initialB;
 	}
+
+	if (keys[GLFW_KEY_7] || keys[GLFW_KEY_8] || keys[GLFW_KEY_9] || keys[GLFW_KEY_0]) {
+		Redraw::Request();
+	}
 }
 
 float* ComplexObject::hexToRGB(int hexValue) {
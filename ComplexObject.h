@@ -5,6 +5,8 @@
 #include <vector>
 #include <GLFW/glfw3.h>
 
+struct RenderSnapshot;
+
 class ComplexObject
 {
 	public:
@@ -13,6 +15,11 @@ class ComplexObject
 		/// It can also have its own transformations, held in a model matrix.
 		/// </summary>
 		ComplexObject();
+		/// <summary>
+		/// Creates a ComplexObject whose children may belong to someone else, such as a SceneArena.
+		/// </summary>
+		/// <param name="ownsChildren">False if deleting the object must leave its meshes and objects alone.</param>
+		ComplexObject(bool ownsChildren);
 		~ComplexObject();
 
 		/// <summary>
@@ -31,7 +38,7 @@ class ComplexObject
 		/// Renders the complex object on screen, applying the specified Model Matrix to it.
 		/// </summary>
 		/// <param name="shader">The chosen shader.</param>
-		void RenderObject(Shader shader);
+		void RenderObject(Shader& shader);
 
 		/// <summary>
 		/// Renders the complex object on screen, applying the specified Model Matrix to it.
@@ -39,13 +46,42 @@ class ComplexObject
 		/// <param name="modelMatrix">The model matrix value.</param>
 		/// <param name="uniformModel">The location of the uniform variable the Model Matrix is tied to.</param>
 		/// <param name="shader">The chosen shader.</param>
-		void RenderObject(glm::mat4& modelMatrix, GLuint uniformModel, Shader shader);
+		void RenderObject(glm::mat4& modelMatrix, GLuint uniformModel, Shader& shader);
+
+		/// <summary>
+		/// Records the draws RenderObject(shader) would make into a snapshot, for the render thread to make them.
+		/// </summary>
+		/// <param name="snapshot">Receives the draws.</param>
+		/// <param name="shader">The chosen shader.</param>
+		/// <param name="modelMatrix">The model matrix in use, the one meshes without a transformation are drawn with.</param>
+		void CollectDraws(RenderSnapshot& snapshot, Shader& shader, const glm::mat4& modelMatrix);
+
+		/// <summary>
+		/// Binds the texture of this object, loading it the first time if it has not been loaded yet, and selects its texture array layer.
+		/// </summary>
+		void BindTexture();
 
 		/// <summary>
 		/// Clears the object from the GPU.
 		/// </summary>
 		void ClearObject();
 
+		/// <summary>
+		/// Bakes the meshes of this object into a single mesh, merging them with a CSG union.
+		/// The parts of the meshes hidden inside other meshes are removed, which lowers the triangle count and the overdraw
+		/// while keeping the same silhouette. The meshes must be closed and convex (cubes, spheres, cylinders),
+		/// and must have kept their source data (see Mesh::CreateMesh(MeshData*)). Other meshes are left untouched.
+		/// </summary>
+		/// <param name="uniformModelLocation">The location of the uniform variable the Model Matrix of the baked mesh is tied to.</param>
+		/// <param name="baked">The union of the meshes baked before (see UnionMeshes), or NULL to bake it now.</param>
+		/// <returns>The number of triangles removed by the bake.</returns>
+		int BakeMeshes(GLuint uniformModelLocation, const MeshData* baked = NULL);
+
+		/// <summary>
+		/// Returns the CSG union of the meshes BakeMeshes would bake, placed where they are drawn.
+		/// </summary>
+		MeshData UnionMeshes() const;
+
 		/// <summary>
 		/// The list of meshes inside this object.
 		/// </summary>
@@ -73,6 +109,31 @@ class ComplexObject
 		/// <returns>A reference to the mat4 of values corresponding to the model matrix</returns>
 		glm::mat4& GetModelMatrix();
 
+		/// <summary>
+		/// Returns true if a model matrix has been set on this object.
+		/// </summary>
+		bool HasModelMatrix();
+
+		/// <summary>
+		/// Returns true if a colour has been set on this object, otherwise it is drawn in the default grey.
+		/// </summary>
+		bool HasColour();
+
+		/// <summary>
+		/// Returns the colour the object is drawn with.
+		/// </summary>
+		glm::vec3 GetColour();
+
+		/// <summary>
+		/// Returns true if a texture has been set on this object.
+		/// </summary>
+		bool HasTexture();
+
+		/// <summary>
+		/// Returns the texture the object is drawn with, only meaningful if HasTexture is true.
+		/// </summary>
+		Texture& GetTexture();
+
 
 		/// <summary>
 		/// Sets the colour of the object.
@@ -94,6 +155,12 @@ class ComplexObject
 		/// <param name="hex">Sets the RGB value from a hex colour.</param>
 		void SetTexture(Texture tex, GLuint textureLocation);
 
+		/// <summary>
+		/// Sets the layer of the bound TextureArray the object is drawn with. Nothing gets bound when drawing it.
+		/// </summary>
+		/// <param name="layer">The layer, as given by TextureArray::AddLayer.</param>
+		void SetTextureLayer(int layer);
+
         /// <summary>
         // Translates model.
         // </summary>
@@ -134,9 +201,17 @@ class ComplexObject
 
 	private:
 		/// <summary>
-		/// The model matrix of this object.
+		/// Records the draws of this object and its children.
 		/// </summary>
-		glm::mat4* objectModelMatrix;
+		/// <param name="modelMatrix">The model matrix of the parent, or the one in use if there is no parent.</param>
+		/// <param name="fromParent">True if modelMatrix is the parent's.</param>
+		/// <param name="textured">The closest object above with a texture, NULL if none.</param>
+		void CollectDraws(RenderSnapshot& snapshot, Shader& shader, const glm::mat4& modelMatrix, bool fromParent, ComplexObject* textured);
+
+		/// <summary>
+		/// The model matrix of this object, the identity while none is set.
+		/// </summary>
+		glm::mat4 objectModelMatrix;
 		/// <summary>
 		/// The location of the uniform variable tied to this object's model matrix.
 		/// </summary>
@@ -146,10 +221,16 @@ class ComplexObject
 		/// Determines if this object has a model matrix tied to it currently. True if yes, false otherwise.
 		/// </summary>
 		bool hasModelMatrix;
+		/// <summary>
+		/// True if the meshes and objects inside this object are deleted along with it.
+		/// </summary>
+		bool ownsChildren;
 
 		GLfloat red, green, blue;
 		float initialR, initialG, initialB;
 		bool colourHasBeenSet, textureHasBeenSet;
+		bool textureLoadTried; // A texture set by path is only loaded once, even if the file is missing
+		int textureLayer; // Layer of the texture array, -1 if none
 
 		Texture tex;
 };
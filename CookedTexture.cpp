@@ -0,0 +1,148 @@
+#include "CookedTexture.h"
+#include "BlockCompression.h"
+#include <cstring>
+
+CookedTexture::CookedTexture()
+{
+	header = NULL;
+	levels = NULL;
+}
+
+bool CookedTexture::Open(const std::string& path)
+{
+	Close();
+	if (!file.Open(path))
+		return false;
+
+	const unsigned char* data = file.GetData();
+	size_t size = file.GetSize();
+	const CookedTextureHeader* fileHeader = (const CookedTextureHeader*)data;
+	if (size < sizeof(CookedTextureHeader) || memcmp(fileHeader->magic, "CTEX", 4) != 0 || fileHeader->version != VERSION
+		|| fileHeader->format > COOKED_BC3 || fileHeader->levelCount == 0 || fileHeader->levelCount > MAX_LEVELS
+		|| size < sizeof(CookedTextureHeader) + fileHeader->levelCount * sizeof(CookedTextureLevel))
+	{
+		file.Close();
+		return false;
+	}
+
+	const CookedTextureLevel* fileLevels = (const CookedTextureLevel*)(data + sizeof(CookedTextureHeader));
+	for (unsigned int i = 0; i < fileHeader->levelCount; i++)
+	{
+		const CookedTextureLevel& level = fileLevels[i];
+		size_t expected = fileHeader->format == COOKED_RGBA8 ? (size_t)level.width * level.height * 4
+			: BlockCompression::GetCompressedSize(level.width, level.height, fileHeader->format == COOKED_BC3);
+		if (level.width == 0 || level.height == 0 || level.size != expected || level.offset > size || size - level.offset < level.size)
+		{
+			file.Close();
+			return false;
+		}
+	}
+
+	header = fileHeader;
+	levels = fileLevels;
+
+	// Room for decoding the largest level up front, uploads of a streamed texture then take no allocation.
+	if (header->format != COOKED_RGBA8 && !UploadsCompressed())
+		decoded.reserve((size_t)levels[0].width * levels[0].height * 4);
+	return true;
+}
+
+void CookedTexture::Close()
+{
+	file.Close();
+	header = NULL;
+	levels = NULL;
+	std::vector<unsigned char>().swap(decoded);
+}
+
+bool CookedTexture::UploadsCompressed()
+{
+	return header->format != COOKED_RGBA8 && GLEW_EXT_texture_compression_s3tc;
+}
+
+GLenum CookedTexture::GetInternalFormat()
+{
+	if (!UploadsCompressed())
+		return GL_RGBA8;
+	return header->format == COOKED_BC1 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+const unsigned char* CookedTexture::GetPixels(int level)
+{
+	const unsigned char* data = file.GetData() + levels[level].offset;
+	if (header->format == COOKED_RGBA8)
+		return data;
+
+	decoded.resize((size_t)levels[level].width * levels[level].height * 4);
+	BlockCompression::Decode(data, levels[level].width, levels[level].height, header->format == COOKED_BC3, decoded.data());
+	return decoded.data();
+}
+
+size_t CookedTexture::GetResidentSize(int level)
+{
+	return UploadsCompressed() ? levels[level].size : (size_t)levels[level].width * levels[level].height * 4;
+}
+
+bool CookedTexture::Upload(int firstLevel)
+{
+	if (header == NULL)
+		return false;
+
+	// Every level is in the file, the texture must not expect more.
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)header->levelCount - 1 - firstLevel);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	bool compressed = UploadsCompressed();
+	GLenum internalFormat = GetInternalFormat();
+	for (int i = firstLevel; i < (int)header->levelCount; i++)
+	{
+		const CookedTextureLevel& level = levels[i];
+		if (compressed)
+			glCompressedTexImage2D(GL_TEXTURE_2D, i - firstLevel, internalFormat, level.width, level.height, 0, level.size, file.GetData() + level.offset);
+		else
+			glTexImage2D(GL_TEXTURE_2D, i - firstLevel, internalFormat, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, GetPixels(i));
+	}
+	return true;
+}
+
+void CookedTexture::AllocateArray(int layerCount, int firstLevel)
+{
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (GLint)header->levelCount - 1 - firstLevel);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	bool compressed = UploadsCompressed();
+	GLenum internalFormat = GetInternalFormat();
+	for (int i = firstLevel; i < (int)header->levelCount; i++)
+	{
+		const CookedTextureLevel& level = levels[i];
+		if (compressed)
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, i - firstLevel, internalFormat, level.width, level.height, layerCount, 0, (GLsizei)(level.size * layerCount), NULL);
+		else
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, i - firstLevel, internalFormat, level.width, level.height, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	}
+}
+
+void CookedTexture::UploadLayer(int layer, int firstLevel)
+{
+	bool compressed = UploadsCompressed();
+	GLenum internalFormat = GetInternalFormat();
+	for (int i = firstLevel; i < (int)header->levelCount; i++)
+	{
+		const CookedTextureLevel& level = levels[i];
+		if (compressed)
+			glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, i - firstLevel, 0, 0, layer, level.width, level.height, 1, internalFormat, level.size, file.GetData() + level.offset);
+		else
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, i - firstLevel, 0, 0, layer, level.width, level.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, GetPixels(i));
+	}
+}
+
+std::string CookedTexture::GetCookedPath(const std::string& imagePath)
+{
+	size_t dot = imagePath.find_last_of('.');
+	size_t slash = imagePath.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		return imagePath + ".ctex";
+	return imagePath.substr(0, dot) + ".ctex";
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+/// <summary>
+/// Pixel formats of cooked textures.
+/// </summary>
+enum CookedFormat { COOKED_RGBA8, COOKED_BC1, COOKED_BC3 };
+
+/// <summary>
+/// Start of a cooked texture file, followed by the level table, then the levels, each starting on a 16 byte boundary.
+/// </summary>
+struct CookedTextureHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int format; // A CookedFormat
+	unsigned int width;
+	unsigned int height;
+	unsigned int levelCount;
+	unsigned int reserved[2];
+};
+
+/// <summary>
+/// One mipmap level of a cooked texture, largest first.
+/// </summary>
+struct CookedTextureLevel
+{
+	unsigned int offset; // From the start of the file
+	unsigned int size;
+	unsigned int width;
+	unsigned int height;
+};
+
+/// <summary>
+/// Texture cooked offline by TextureCooker: the whole mipmap chain, already built and possibly block compressed,
+/// in a file laid out like KTX. The file is mapped and every level is uploaded straight from the mapping, so loading
+/// decodes no image and generates no mipmap. Compressed levels are decoded on the CPU for drivers without
+/// GL_EXT_texture_compression_s3tc.
+/// </summary>
+class CookedTexture
+{
+	public:
+		CookedTexture();
+
+		/// <summary>
+		/// Maps a cooked texture and checks its tables.
+		/// </summary>
+		/// <returns>False if the file is missing, damaged or from another version.</returns>
+		bool Open(const std::string& path);
+
+		/// <summary>
+		/// Unmaps the file.
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Uploads every level into the texture bound to GL_TEXTURE_2D.
+		/// </summary>
+		/// <param name="firstLevel">The level uploaded as level 0, the larger ones are left out.</param>
+		/// <returns>False if nothing is open.</returns>
+		bool Upload(int firstLevel = 0);
+
+		/// <summary>
+		/// Allocates every level of the texture array bound to GL_TEXTURE_2D_ARRAY, in the format Upload would use.
+		/// </summary>
+		/// <param name="layerCount">The number of layers of the array.</param>
+		/// <param name="firstLevel">The level allocated as level 0, the larger ones are left out.</param>
+		void AllocateArray(int layerCount, int firstLevel = 0);
+
+		/// <summary>
+		/// Uploads every level into a layer of the texture array bound to GL_TEXTURE_2D_ARRAY, allocated by AllocateArray
+		/// of a texture with the same size and format.
+		/// </summary>
+		void UploadLayer(int layer, int firstLevel = 0);
+
+		/// <summary>
+		/// Returns the bytes a level takes on the GPU, once uploaded.
+		/// </summary>
+		size_t GetResidentSize(int level);
+
+		CookedFormat GetFormat() { return (CookedFormat)header->format; }
+		int GetWidth() { return (int)header->width; }
+		int GetHeight() { return (int)header->height; }
+		int GetLevelCount() { return (int)header->levelCount; }
+
+		/// <summary>
+		/// Returns the path of the cooked version of an image, next to it: Textures/stone.jpg gives Textures/stone.ctex.
+		/// </summary>
+		static std::string GetCookedPath(const std::string& imagePath);
+
+		static const unsigned int VERSION = 1;
+		static const int MAX_LEVELS = 16;
+
+	private:
+		/// <summary>
+		/// Returns true if the levels go to the GPU compressed, false if they are decoded to RGBA first.
+		/// </summary>
+		bool UploadsCompressed();
+
+		/// <summary>
+		/// Returns the internal format of the texture on the GPU.
+		/// </summary>
+		GLenum GetInternalFormat();
+
+		/// <summary>
+		/// Returns the pixels of a level as RGBA, decoding them into the buffer if they are compressed.
+		/// </summary>
+		const unsigned char* GetPixels(int level);
+
+		MappedFile file;
+		const CookedTextureHeader* header;
+		const CookedTextureLevel* levels;
+		std::vector<unsigned char> decoded; // Pixels of the level being uploaded, when compressed levels are decoded
+};
@@ -0,0 +1,249 @@
+#include "DefaultScene.h"
+#include "IndependentMesh.h"
+#include "MeshData.h"
+#include "PrimitiveTables.h"
+
+//////////////////////////////////////////////////////////////////////////////////////
+// References used:																	//
+// - Cylinder http://www.songho.ca/opengl/gl_cylinder.html#example_cylinder			//
+// - Sphere http://www.songho.ca/opengl/gl_sphere.html								//
+//////////////////////////////////////////////////////////////////////////////////////
+
+PrimitiveLibrary primitives; // Geometry shared by every glyph
+GlyphLibrary glyphs; // Table of every glyph that can be drawn
+GlyphMeshCache glyphMeshes; // Extruded stroke font glyphs
+StringMeshCache stringMeshes(&glyphMeshes); // Baked strings, kept on disk between runs
+
+// Merge the overlapping primitives of each letter into a single shell when creating them
+const bool BAKE_LETTERS = true;
+// Changed along with the glyph table, the primitives or the CSG, so letters baked by an older one are baked again
+const int LETTER_BAKE_VERSION = 1;
+// Draw the letters with the extruded stroke font instead of the glyphs of spheres and cubes. Off by default, the
+// scene keeps its look; stroke letters skip the bake above, they come out of the font as a single shell already.
+const bool STROKE_LETTERS = false;
+const ExtrudeStyle LETTER_STYLE = { 0.5f, 0.1f, 2 }; // Depth, bevel, quality
+
+// Shape creation method, the tessellation is a template parameter so the geometry comes from a constexpr table
+template<int SectorCount> ComplexObject* CreateCylinder(float height, float radius);
+
+void CreateDefaultScene(GLuint modelLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects)
+{
+	meshes.push_back(CreateGrid(128));
+
+	// Creating all 6 letters, positioned at the back of the grid
+	ComplexObject* letters = CreateLetters(modelLocation);
+	glm::mat4 model(1.0f);
+	model = glm::translate(model, glm::vec3(0.0f, 0.1f, -10.0f));
+	model = glm::scale(model, glm::vec3(0.1f, 0.1f, 0.1f));
+	letters->SetModelMatrix(model, 0);
+	objects.push_back(letters);
+
+	// Create the axes
+	objects.push_back(CreateAxes());
+}
+
+Mesh* CreateGrid(int squareCount)
+{
+	MeshData* grid = new MeshData();
+	std::vector<float>& vertices = grid->vertices;
+	std::vector<unsigned int>& indices = grid->indices;
+
+	// Loops through each row, then for each column it creates a point clamped between 0 to 1
+	for (int i = 0; i <= squareCount; i++) {
+		for (int j = 0; j <= squareCount; j++) {
+			float x = (float)j / (float)squareCount;
+			float y = 0;
+			float z = (float)i / (float)squareCount;
+
+			vertices.push_back(x);
+			vertices.push_back(y);
+			vertices.push_back(z);
+		}
+	}
+
+	// A double loop to connect all the vertices with the appropriate indices.
+	// First it top left to top right vertex, then top right with bottom right, then bottom right with bottom left and finally bottom left with top right. 
+	for (int i = 0; i < squareCount; i++) {
+		for (int j = 0; j < squareCount; j++) {
+			int top = i * (1 + squareCount);
+			int bottom = (i + 1) * (1 + squareCount);
+
+			// Top line
+			indices.push_back(top + j);
+			indices.push_back(top + j + 1);
+			// Right line
+			indices.push_back(top + j + 1);
+			indices.push_back(bottom + j + 1);
+			// Bottom line
+			indices.push_back(bottom + j + 1);
+			indices.push_back(bottom + j);
+			// Left line
+			indices.push_back(bottom + j);
+			indices.push_back(top + j);
+		}
+	}
+
+	// Keeping the geometry on the mesh, so the scene can be baked into a blob
+	Mesh* gridObj = new Mesh();
+	gridObj->CreateMesh(grid);
+	return gridObj;
+}
+
+// Create cylinder
+template<int SectorCount>
+ComplexObject* CreateCylinder(float height, float radius) {
+
+	// The unit cylinder of the table, sized by the matrix of the mesh rather than by scaling a copy of it
+	glm::mat4 sizeMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(radius, radius, height));
+
+	IndependentMesh* m = new IndependentMesh();
+	m->CreateStaticMesh(PrimitiveTables::CylinderTable<SectorCount>::Get());
+	m->SetModelMatrix(sizeMatrix, 0);
+	ComplexObject* cylinder = new ComplexObject();
+	cylinder->meshList.push_back(m);
+
+	return cylinder;
+
+}
+
+ComplexObject* CreateLetters(GLuint modelLocation) {
+
+	/////////////////////////////////////////////
+	// Creating name object with all 6 letters //
+	/////////////////////////////////////////////
+
+	ComplexObject *letterS, *letterA, *letterN, *letterI, *letterR, *letterO;
+	if (STROKE_LETTERS)
+	{
+		// Loaded from the mesh cache on disk, only generated on the very first run
+		letterS = stringMeshes.CreateStringObject("S", LETTER_STYLE, modelLocation);
+		letterA = stringMeshes.CreateStringObject("A", LETTER_STYLE, modelLocation);
+		letterN = stringMeshes.CreateStringObject("N", LETTER_STYLE, modelLocation);
+		letterI = stringMeshes.CreateStringObject("I", LETTER_STYLE, modelLocation);
+		letterR = stringMeshes.CreateStringObject("R", LETTER_STYLE, modelLocation);
+		letterO = stringMeshes.CreateStringObject("O", LETTER_STYLE, modelLocation);
+		printf("Letters: %d from disk, %d generated\n", stringMeshes.diskHits, stringMeshes.misses);
+	}
+	else
+	{
+		// Loading the glyph table and the primitives it uses, only this path draws them
+		glyphs.Load(&primitives);
+		letterS = glyphs.CreateGlyphObject('S', modelLocation);
+		letterA = glyphs.CreateGlyphObject('A', modelLocation);
+		letterN = glyphs.CreateGlyphObject('N', modelLocation);
+		letterI = glyphs.CreateGlyphObject('I', modelLocation);
+		letterR = glyphs.CreateGlyphObject('R', modelLocation);
+		letterO = glyphs.CreateGlyphObject('O', modelLocation);
+	}
+	 
+	glm::mat4 model(1.0f);
+
+	// Transform and set colours for letters
+
+	model = glm::translate(model, glm::vec3(0.5f, 28.5f, 0.0f));
+	letterS->SetModelMatrix(model, modelLocation);
+	letterS->SetColour(0x46065e); // Set colour to dark purple using a hex code
+	
+   	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(0.6f, 23.5f, 0.0f));
+	model = glm::scale(model, glm::vec3(0.7f, 0.7f, 0.7f));
+	letterA->SetModelMatrix(model, modelLocation);
+	letterA->SetColour(0x65076c); // Purple
+	
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(-0.9f, 17.5f, 0.0f));
+	model = glm::scale(model, glm::vec3(0.97f, 0.97f, 0.97f));
+	letterN->SetModelMatrix(model, modelLocation);
+	letterN->SetColour(0x860877); // Magenta
+	
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(0.5f, 11.25f, 0.0f));
+	letterI->SetModelMatrix(model, modelLocation);
+	letterI->SetColour(0xa70b81); // Pink
+	
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(-0.75f, 5.75f, 0.0f));
+	letterR->SetModelMatrix(model, modelLocation);
+	letterR->SetColour(0xe32d6a); // Light red
+
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(-1.0f, 0.0f, 0.0f));
+	model = glm::scale(model, glm::vec3(0.9f, 0.9f, 0.9f));
+	letterO->SetModelMatrix(model, modelLocation);
+	letterO->SetColour(0xc81126); // Red
+
+	if (BAKE_LETTERS && !STROKE_LETTERS) // Stroke letters are already a single shell
+	{
+		// Removing the triangles buried inside other primitives of the same letter
+		// Kept in the mesh store like the strings, so only the first run pays for the unions
+		ComplexObject* letters[] = { letterS, letterA, letterN, letterI, letterR, letterO };
+		const char names[] = "SANIRO";
+		int diskHitsBefore = stringMeshes.diskHits;
+		int trianglesRemoved = 0;
+		for (int i = 0; i < 6; i++)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "letter %c v%d", names[i], LETTER_BAKE_VERSION);
+			const MeshData* baked = stringMeshes.GetBaked(name, [&]() { return letters[i]->UnionMeshes(); });
+			trianglesRemoved += letters[i]->BakeMeshes(modelLocation, baked);
+		}
+		printf("Baked letters, %d hidden triangles removed, %d of 6 read from disk\n", trianglesRemoved,
+			stringMeshes.diskHits - diskHitsBefore);
+	}
+	
+	ComplexObject* SaffiaNameAndID = new ComplexObject();
+
+	SaffiaNameAndID->objectList.push_back(letterS);
+	SaffiaNameAndID->objectList.push_back(letterA);
+	SaffiaNameAndID->objectList.push_back(letterN);
+	SaffiaNameAndID->objectList.push_back(letterI);
+	SaffiaNameAndID->objectList.push_back(letterR);
+	SaffiaNameAndID->objectList.push_back(letterO);
+	
+	return SaffiaNameAndID;
+
+}
+
+
+ComplexObject* CreateAxes()
+{
+
+	ComplexObject *axes = new ComplexObject();
+
+	// Create 3 cylinders, one for each axis, with length 2.5 and diameter 0.25
+	ComplexObject *x = CreateCylinder<12>(2.5f, 0.125f);
+	ComplexObject *y = CreateCylinder<12>(2.5f, 0.125f);
+	ComplexObject *z = CreateCylinder<12>(2.5f, 0.125f);
+
+	// Add them to the complex object of the entire axis
+	axes->objectList.push_back(x);
+	axes->objectList.push_back(y);
+	axes->objectList.push_back(z);
+
+	glm::mat4 model(1.0f);
+	model = glm::scale(model, glm::vec3(0.16f, 0.16f, 0.16f));
+	axes->SetModelMatrix(model, 0);
+
+	// X-axis
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(1.25f, 0.0f, 0.0f));
+	model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	x->SetColour(1.0f, 0.0f, 0.0f); // Red
+	x->SetModelMatrix(model, 0);
+
+	// Y-axis
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(0.0f, 1.25f, 0.0f));
+	model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+	y->SetColour(0.0f, 1.0f, 0.0f); // Green
+	y->SetModelMatrix(model, 0);
+
+	// Z-axis
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(0.0f, 0.0f, 1.25f));
+	z->SetColour(0.0f, 0.0f, 1.0f); // Blue
+	z->SetModelMatrix(model, 0);
+
+	return axes;
+
+}
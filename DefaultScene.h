@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+
+#include "Mesh.h"
+#include "ComplexObject.h"
+#include "Primitives.h"
+#include "GlyphLibrary.h"
+#include "GlyphMeshCache.h"
+#include "StringMeshCache.h"
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Builders of the default scene: the world grid, the name letters and the axes.	//
+// Shared by the application and by the offline scene baker (tools/SceneBaker.cpp).//
+//////////////////////////////////////////////////////////////////////////////////////
+
+extern PrimitiveLibrary primitives; // Geometry shared by every glyph
+extern GlyphLibrary glyphs; // Table of every glyph that can be drawn
+extern GlyphMeshCache glyphMeshes; // Extruded stroke font glyphs
+extern StringMeshCache stringMeshes; // Baked strings, kept on disk between runs
+
+/// <summary>
+/// Builds the whole default scene: the grid goes in meshes (drawn with GL_LINES), then the letters and the axes go in objects.
+/// </summary>
+/// <param name="modelLocation">The location of the Model Matrix on the GPU</param>
+/// <param name="meshes">Receives the loose meshes of the scene.</param>
+/// <param name="objects">Receives the objects of the scene.</param>
+void CreateDefaultScene(GLuint modelLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects);
+
+/// <summary>
+/// Creates a square grid by creating vertices for the given amount of squares (basically a 2d array).
+/// Links all the vertices with 2-pair indices that can be used with GL_LINES to draw the triangle.
+/// </summary>
+/// <param name="squareCount">Integer describing amount of squares user wishes to be created. </param>
+Mesh* CreateGrid(int squareCount);
+
+/// <summary>
+/// Creates characters representing the first and last letter of each team member's name, and the first and last digit of their student ID.
+/// </summary>
+/// <param name="modelLocation">The location of the Model Matrix on the GPU</param>
+/// <returns>The object holding the 6 letters.</returns>
+ComplexObject* CreateLetters(GLuint modelLocation);
+
+/// <summary>
+/// Creates the X (red), Y (green) and Z (blue) axes.
+/// </summary>
+ComplexObject* CreateAxes();
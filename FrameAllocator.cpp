@@ -0,0 +1,134 @@
+#include "FrameAllocator.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifndef NDEBUG
+// Debug builds count every allocation of the general heap, so EndFrame can tell if the frame made any. Each thread
+// counts its own, the render thread and the workers allocating do not break the frame of the main thread.
+// operator new[] and the nothrow versions go through this one.
+static thread_local unsigned long long heapAllocationCount = 0;
+
+void* operator new(size_t size)
+{
+	heapAllocationCount++;
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+#endif
+
+unsigned long long GetHeapAllocationCount()
+{
+#ifndef NDEBUG
+	return heapAllocationCount;
+#else
+	return 0;
+#endif
+}
+
+/// <summary>
+/// Returns the first address from an address that is a multiple of the alignment, a power of two.
+/// </summary>
+static uintptr_t AlignUp(uintptr_t address, size_t alignment)
+{
+	return (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+}
+
+FrameAllocator::FrameAllocator(size_t capacity)
+{
+	this->capacity = capacity > 0 ? capacity : 1;
+	block = new unsigned char[this->capacity];
+	used = 0;
+	overflowBytes = 0;
+	allocationsAtFrameStart = 0;
+	overflowAllocations = 0;
+}
+
+FrameAllocator::~FrameAllocator()
+{
+	for (int i = 0; i < overflow.size(); i++)
+	{
+		delete[] overflow[i];
+	}
+	delete[] block;
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+	assert((owner == std::thread::id() || owner == std::this_thread::get_id()) && "frame memory is allocated by the thread of the frame");
+
+	uintptr_t base = (uintptr_t)block;
+	size_t offset = (size_t)(AlignUp(base + used, alignment) - base);
+	if (offset + size <= capacity)
+	{
+		used = offset + size;
+		return block + offset;
+	}
+
+	// Does not fit, the frame gets an extra block and the main one grows when the next frame begins.
+	unsigned long long allocations = GetHeapAllocationCount();
+	unsigned char* extra = new unsigned char[size + alignment];
+	overflow.push_back(extra);
+	overflowBytes += size + alignment;
+	overflowAllocations += GetHeapAllocationCount() - allocations;
+	return (void*)AlignUp((uintptr_t)extra, alignment);
+}
+
+void FrameAllocator::BeginFrame()
+{
+	if (!overflow.empty())
+	{
+		// Room for the whole frame in one block from now on, with some margin.
+		size_t needed = used + overflowBytes;
+		for (int i = 0; i < overflow.size(); i++)
+		{
+			delete[] overflow[i];
+		}
+		overflow.clear();
+		overflowBytes = 0;
+
+		delete[] block;
+		printf("Frame memory of %zu bytes was too small for a frame of %zu bytes, grown to %zu\n", capacity, needed, needed + needed / 2);
+		capacity = needed + needed / 2;
+		block = new unsigned char[capacity];
+	}
+	used = 0;
+	overflowAllocations = 0;
+
+	owner = std::this_thread::get_id();
+	allocationsAtFrameStart = GetHeapAllocationCount();
+}
+
+void FrameAllocator::EndFrame()
+{
+	assert(owner == std::this_thread::get_id() && "a frame ends on the thread it began on");
+	unsigned long long allocations = GetHeapAllocationCount() - allocationsAtFrameStart - overflowAllocations;
+	owner = std::thread::id();
+
+	assert(allocations == 0 && "the frame loop allocated from the general heap");
+	(void)allocations;
+}
+
+void FrameAllocator::Reserve(size_t size)
+{
+	if (size <= capacity || used > 0 || !overflow.empty())
+		return;
+
+	delete[] block;
+	capacity = size;
+	block = new unsigned char[capacity];
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// Bump allocator for the data of one frame.
+/// Allocating moves a cursor along a single block, and the whole block is freed at once when the next frame begins, so
+/// the frame loop never goes through the general heap and the data stays valid after the frame is built, while it is
+/// drawn. A frame needing more than the block is served by extra blocks, and the block grows to fit it when the next
+/// frame begins, so that only happens until the peak usage is known.
+/// An allocator belongs to the thread calling BeginFrame, the only one allocating from it until the frame ends. In
+/// debug builds, EndFrame checks that this thread did not call operator new since BeginFrame; other threads are free to.
+/// Extra blocks are not counted, a frame outgrowing the block is reported when the block grows instead.
+/// </summary>
+class FrameAllocator
+{
+	public:
+		/// <summary>
+		/// Creates an allocator, allocating its block up front.
+		/// </summary>
+		/// <param name="capacity">Size of the block in bytes.</param>
+		FrameAllocator(size_t capacity = DEFAULT_CAPACITY);
+		~FrameAllocator();
+
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+		/// <summary>
+		/// Returns uninitialized memory valid until the end of the frame.
+		/// </summary>
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/// <summary>
+		/// Returns an uninitialized array valid until the end of the frame. Nothing is destroyed when the frame ends,
+		/// so only types without a destructor can be allocated.
+		/// </summary>
+		template <typename T>
+		T* AllocateArray(size_t count)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "frame memory is released without destroying anything");
+			return (T*)Allocate(sizeof(T) * count, alignof(T));
+		}
+
+		/// <summary>
+		/// Releases everything allocated during the previous frame, which nothing may read anymore, and starts a new
+		/// one on the calling thread.
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Marks the end of the frame, checking in debug builds that its thread did not allocate from the general heap.
+		/// What the frame allocated stays valid until the next BeginFrame.
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>
+		/// Grows the block to at least a number of bytes, outside of a frame, before the first one uses it.
+		/// </summary>
+		void Reserve(size_t size);
+
+		/// <summary>
+		/// Returns the number of bytes allocated since the start of the frame.
+		/// </summary>
+		size_t GetUsed() const { return used + overflowBytes; }
+
+		/// <summary>
+		/// Returns the size of the block.
+		/// </summary>
+		size_t GetCapacity() const { return capacity; }
+
+		static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+	private:
+		unsigned char* block;
+		size_t capacity;
+		size_t used; // Bytes of the block handed out this frame
+		std::vector<unsigned char*> overflow; // Extra blocks of a frame that did not fit
+		size_t overflowBytes;
+		unsigned long long allocationsAtFrameStart;
+		unsigned long long overflowAllocations; // Made by Allocate for the extra blocks of the frame
+		std::thread::id owner; // Thread of the current frame
+};
+
+/// <summary>
+/// Returns how many times the calling thread called operator new since it started. Only counted in debug builds,
+/// where operator new is replaced to count; always 0 when NDEBUG is defined.
+/// </summary>
+unsigned long long GetHeapAllocationCount();
@@ -0,0 +1,512 @@
+#include "FrameGraph.h"
+#include <cstdio>
+
+static bool IsDepthFormat(GLenum internalFormat)
+{
+	return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32F
+		|| internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+static bool HasStencil(GLenum internalFormat)
+{
+	return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+static int GetBytesPerPixel(GLenum internalFormat)
+{
+	switch (internalFormat)
+	{
+		case GL_R8: return 1;
+		case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16: return 2;
+		case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8: return 8;
+		case GL_RGBA32F: return 16;
+		default: return 4;
+	}
+}
+
+FrameGraph::FrameGraph()
+{
+	canInvalidate = false;
+}
+
+FrameGraph::~FrameGraph()
+{
+	DeleteObjects();
+}
+
+int FrameGraph::CreateTexture(const char* name, GLsizei width, GLsizei height, GLenum internalFormat)
+{
+	Resource resource = { name, width, height, internalFormat, 0, { 0.0f, 0.0f, 0.0f, 0.0f }, -1, -1, -1 };
+	resources.push_back(resource);
+	return (int)resources.size() - 1;
+}
+
+int FrameGraph::ImportBackbuffer(GLenum buffer)
+{
+	Resource resource = { buffer == GL_DEPTH ? "Window depth" : "Window colour", 0, 0,
+		buffer == GL_DEPTH ? (GLenum)GL_DEPTH_COMPONENT24 : (GLenum)GL_RGBA8, buffer, { 0.0f, 0.0f, 0.0f, 0.0f }, -1, -1, -1 };
+	resources.push_back(resource);
+	return (int)resources.size() - 1;
+}
+
+void FrameGraph::SetClearColour(int texture, GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+	GLfloat* colour = resources[texture].clearColour;
+	colour[0] = r;
+	colour[1] = g;
+	colour[2] = b;
+	colour[3] = a;
+}
+
+int FrameGraph::AddPass(const char* name, ExecuteFunction execute, void* context)
+{
+	Pass pass;
+	pass.name = name;
+	pass.execute = execute;
+	pass.context = context;
+	pass.kept = false;
+	pass.framebuffer = 0;
+	pass.width = 0;
+	pass.height = 0;
+	passes.push_back(pass);
+	return (int)passes.size() - 1;
+}
+
+void FrameGraph::Read(int pass, int texture)
+{
+	Access access = { texture, false };
+	passes[pass].reads.push_back(access);
+}
+
+void FrameGraph::Write(int pass, int texture, bool coversAll)
+{
+	Access access = { texture, coversAll };
+	passes[pass].writes.push_back(access);
+}
+
+bool FrameGraph::DependsOn(int pass, int other)
+{
+	if (pass == other)
+		return false;
+
+	// Readers come after every writer, writers after the writers added before them
+	for (const Access& read : passes[pass].reads)
+	{
+		for (const Access& write : passes[other].writes)
+		{
+			if (write.resource == read.resource)
+				return true;
+		}
+	}
+	if (other < pass)
+	{
+		for (const Access& write : passes[pass].writes)
+		{
+			for (const Access& otherWrite : passes[other].writes)
+			{
+				if (otherWrite.resource == write.resource)
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+void FrameGraph::Cull()
+{
+	for (Pass& pass : passes)
+	{
+		pass.kept = false;
+		for (const Access& write : pass.writes)
+		{
+			if (resources[write.resource].backbuffer == GL_COLOR)
+				pass.kept = true;
+		}
+	}
+
+	// Keeping what the kept passes need, until nothing changes. A write covering every pixel does not need what the
+	// writers before it left, so they can go if nothing else reads it.
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (int i = 0; i < (int)passes.size(); i++)
+		{
+			if (!passes[i].kept)
+				continue;
+			for (int j = 0; j < (int)passes.size(); j++)
+			{
+				if (passes[j].kept || j == i)
+					continue;
+				bool needed = false;
+				for (const Access& read : passes[i].reads)
+				{
+					for (const Access& write : passes[j].writes)
+						needed = needed || write.resource == read.resource;
+				}
+				if (j < i)
+				{
+					for (const Access& write : passes[i].writes)
+					{
+						for (const Access& otherWrite : passes[j].writes)
+							needed = needed || (otherWrite.resource == write.resource && !write.coversAll);
+					}
+				}
+				if (needed)
+				{
+					passes[j].kept = true;
+					changed = true;
+				}
+			}
+		}
+	}
+}
+
+bool FrameGraph::Sort()
+{
+	order.clear();
+	std::vector<bool> placed(passes.size(), false);
+	int keptCount = 0;
+	for (const Pass& pass : passes)
+	{
+		if (pass.kept)
+			keptCount++;
+	}
+
+	// Taking the first pass added whose dependencies have all run, so independent passes keep the order they were added in
+	while ((int)order.size() < keptCount)
+	{
+		int next = -1;
+		for (int i = 0; i < (int)passes.size() && next < 0; i++)
+		{
+			if (!passes[i].kept || placed[i])
+				continue;
+			bool ready = true;
+			for (int j = 0; j < (int)passes.size() && ready; j++)
+			{
+				if (passes[j].kept && !placed[j] && DependsOn(i, j))
+					ready = false;
+			}
+			if (ready)
+				next = i;
+		}
+
+		if (next < 0)
+		{
+			for (int i = 0; i < (int)passes.size(); i++)
+			{
+				if (passes[i].kept && !placed[i])
+				{
+					printf("Frame graph: the pass %s depends on itself through other passes\n", passes[i].name);
+					order.push_back(i);
+					placed[i] = true;
+				}
+			}
+			return false;
+		}
+		order.push_back(next);
+		placed[next] = true;
+	}
+	return true;
+}
+
+void FrameGraph::Alias()
+{
+	for (Resource& resource : resources)
+	{
+		resource.physical = -1;
+		resource.firstUse = -1;
+		resource.lastUse = -1;
+	}
+	for (int position = 0; position < (int)order.size(); position++)
+	{
+		const Pass& pass = passes[order[position]];
+		for (int list = 0; list < 2; list++)
+		{
+			for (const Access& access : list == 0 ? pass.reads : pass.writes)
+			{
+				Resource& resource = resources[access.resource];
+				if (resource.firstUse < 0)
+					resource.firstUse = position;
+				resource.lastUse = position;
+			}
+		}
+	}
+
+	// Handing out the textures in order, one is free again once the last pass of its resource is done
+	for (int position = 0; position < (int)order.size(); position++)
+	{
+		for (int i = 0; i < (int)resources.size(); i++)
+		{
+			Resource& resource = resources[i];
+			if (resource.backbuffer != 0 || resource.firstUse != position)
+				continue;
+
+			for (int j = 0; j < (int)physicals.size() && resource.physical < 0; j++)
+			{
+				Physical& physical = physicals[j];
+				if (physical.busyUntil < position && physical.width == resource.width && physical.height == resource.height
+					&& physical.internalFormat == resource.internalFormat)
+				{
+					resource.physical = j;
+					physical.busyUntil = resource.lastUse;
+				}
+			}
+			if (resource.physical >= 0)
+				continue;
+
+			// Floats are accepted for every format read as floats, no data is given anyway
+			Physical physical = { 0, resource.width, resource.height, resource.internalFormat, resource.lastUse };
+			GLenum format = GL_RGBA, type = GL_FLOAT;
+			if (HasStencil(resource.internalFormat))
+			{
+				format = GL_DEPTH_STENCIL;
+				type = resource.internalFormat == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 : GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+			}
+			else if (IsDepthFormat(resource.internalFormat))
+				format = GL_DEPTH_COMPONENT;
+
+			glGenTextures(1, &physical.texture);
+			glBindTexture(GL_TEXTURE_2D, physical.texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, resource.internalFormat, resource.width, resource.height, 0, format, type, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glBindTexture(GL_TEXTURE_2D, 0);
+
+			physicals.push_back(physical);
+			resource.physical = (int)physicals.size() - 1;
+		}
+	}
+}
+
+GLenum FrameGraph::GetAttachment(const Pass& pass, int resource)
+{
+	if (resources[resource].backbuffer != 0)
+		return resources[resource].backbuffer;
+
+	int colourCount = 0;
+	for (const Access& write : pass.writes)
+	{
+		GLenum internalFormat = resources[write.resource].internalFormat;
+		GLenum attachment = GL_COLOR_ATTACHMENT0 + colourCount;
+		if (HasStencil(internalFormat))
+			attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+		else if (IsDepthFormat(internalFormat))
+			attachment = GL_DEPTH_ATTACHMENT;
+		else
+			colourCount++;
+		if (write.resource == resource)
+			return attachment;
+	}
+	return GL_NONE;
+}
+
+bool FrameGraph::IsFirstWriter(int position, int resource)
+{
+	for (int i = 0; i < position; i++)
+	{
+		for (const Access& write : passes[order[i]].writes)
+		{
+			if (write.resource == resource)
+				return false;
+		}
+	}
+	return true;
+}
+
+void FrameGraph::PreparePass(int position)
+{
+	Pass& pass = passes[order[position]];
+	pass.framebuffer = 0;
+	pass.width = 0;
+	pass.height = 0;
+	pass.clears.clear();
+	pass.discards.clear();
+	pass.invalidates.clear();
+	pass.deadTextures.clear();
+
+	bool toWindow = false, toTextures = false;
+	for (const Access& write : pass.writes)
+	{
+		if (resources[write.resource].backbuffer != 0)
+			toWindow = true;
+		else
+			toTextures = true;
+	}
+	if (toWindow && toTextures)
+		printf("Frame graph: the pass %s writes both the window and textures, it only draws to the window\n", pass.name);
+
+	if (!toWindow && toTextures)
+	{
+		GLenum drawBuffers[8];
+		GLsizei colourCount = 0;
+		glGenFramebuffers(1, &pass.framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+		for (const Access& write : pass.writes)
+		{
+			const Resource& resource = resources[write.resource];
+			GLenum attachment = GetAttachment(pass, write.resource);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, physicals[resource.physical].texture, 0);
+			if (attachment != GL_DEPTH_ATTACHMENT && attachment != GL_DEPTH_STENCIL_ATTACHMENT && colourCount < 8)
+				drawBuffers[colourCount++] = attachment;
+			pass.width = resource.width;
+			pass.height = resource.height;
+		}
+		if (colourCount > 0)
+			glDrawBuffers(colourCount, drawBuffers);
+		else
+			glDrawBuffer(GL_NONE);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			printf("Frame graph: the targets of the pass %s cannot be drawn to together\n", pass.name);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	for (const Access& write : pass.writes)
+	{
+		const Resource& resource = resources[write.resource];
+		if ((resource.backbuffer != 0) != toWindow)
+			continue;
+		GLenum attachment = GetAttachment(pass, write.resource);
+
+		// The first writer starts from nothing: a clear, or no load at all if it covers every pixel
+		if (IsFirstWriter(position, write.resource))
+		{
+			if (write.coversAll)
+				pass.discards.push_back(attachment);
+			else
+			{
+				ClearTarget clear = { write.resource, 0 };
+				if (attachment >= GL_COLOR_ATTACHMENT0 && attachment < GL_COLOR_ATTACHMENT0 + 8)
+					clear.drawBuffer = attachment - GL_COLOR_ATTACHMENT0;
+				pass.clears.push_back(clear);
+			}
+		}
+
+		// Nothing after reads it, it need not be kept past the pass
+		if (resource.lastUse == position && resource.backbuffer != GL_COLOR)
+			pass.invalidates.push_back(attachment);
+	}
+
+	for (const Access& read : pass.reads)
+	{
+		const Resource& resource = resources[read.resource];
+		if (resource.backbuffer == 0 && resource.lastUse == position && GetAttachment(pass, read.resource) == GL_NONE)
+			pass.deadTextures.push_back(physicals[resource.physical].texture);
+	}
+}
+
+bool FrameGraph::Compile()
+{
+	DeleteObjects();
+	canInvalidate = GLEW_ARB_invalidate_subdata;
+
+	Cull();
+	bool sorted = Sort();
+	Alias();
+	for (int position = 0; position < (int)order.size(); position++)
+		PreparePass(position);
+	return sorted;
+}
+
+void FrameGraph::Execute()
+{
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	for (int index : order)
+	{
+		Pass& pass = passes[index];
+		glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+		if (pass.framebuffer != 0)
+			glViewport(0, 0, pass.width, pass.height);
+		else
+			glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+		if (canInvalidate && !pass.discards.empty())
+			glInvalidateFramebuffer(GL_FRAMEBUFFER, (GLsizei)pass.discards.size(), pass.discards.data());
+		for (const ClearTarget& clear : pass.clears)
+		{
+			const Resource& resource = resources[clear.resource];
+			if (HasStencil(resource.internalFormat))
+				glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+			else if (IsDepthFormat(resource.internalFormat))
+			{
+				GLfloat depth = 1.0f;
+				glClearBufferfv(GL_DEPTH, 0, &depth);
+			}
+			else
+				glClearBufferfv(GL_COLOR, clear.drawBuffer, resource.clearColour);
+		}
+
+		pass.execute(pass.context);
+
+		if (canInvalidate)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+			if (!pass.invalidates.empty())
+				glInvalidateFramebuffer(GL_FRAMEBUFFER, (GLsizei)pass.invalidates.size(), pass.invalidates.data());
+			for (GLuint texture : pass.deadTextures)
+				glInvalidateTexImage(texture, 0);
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+GLuint FrameGraph::GetTexture(int texture)
+{
+	int physical = resources[texture].physical;
+	return physical >= 0 ? physicals[physical].texture : 0;
+}
+
+void FrameGraph::DeleteObjects()
+{
+	for (Pass& pass : passes)
+	{
+		if (pass.framebuffer != 0)
+			glDeleteFramebuffers(1, &pass.framebuffer);
+		pass.framebuffer = 0;
+	}
+	for (const Physical& physical : physicals)
+		glDeleteTextures(1, &physical.texture);
+	physicals.clear();
+	for (Resource& resource : resources)
+		resource.physical = -1;
+}
+
+void FrameGraph::Clear()
+{
+	DeleteObjects();
+	resources.clear();
+	passes.clear();
+	order.clear();
+}
+
+void FrameGraph::PrintStatistics()
+{
+	if (passes.empty())
+		return;
+
+	long long transientBytes = 0, aliasedBytes = 0;
+	int transientCount = 0;
+	for (const Resource& resource : resources)
+	{
+		if (resource.physical < 0)
+			continue;
+		transientBytes += (long long)resource.width * resource.height * GetBytesPerPixel(resource.internalFormat);
+		transientCount++;
+	}
+	for (const Physical& physical : physicals)
+		aliasedBytes += (long long)physical.width * physical.height * GetBytesPerPixel(physical.internalFormat);
+
+	printf("Frame graph: %d of %d passes kept, %d transient textures in %d GL textures (%.1f MB instead of %.1f MB)\n",
+		(int)order.size(), (int)passes.size(), transientCount, (int)physicals.size(), aliasedBytes / 1048576.0, transientBytes / 1048576.0);
+	for (const Pass& pass : passes)
+	{
+		if (!pass.kept)
+			printf("Frame graph: the pass %s was culled, nothing uses what it draws\n", pass.name);
+	}
+}
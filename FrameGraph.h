@@ -0,0 +1,193 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+
+/// <summary>
+/// The passes of a frame and the render targets they use. Passes declare the textures they read and write, and
+/// Compile works out the rest once:
+/// - Passes whose results nothing uses are culled. A pass is kept if it writes the window, or a texture a kept pass
+///   reads.
+/// - Passes are ordered by their dependencies, writers of a texture before its readers, then in the order added.
+/// - Transient textures only live from their first use to their last, so textures of the same size and format whose
+///   lives do not overlap share one GL texture.
+/// - A target is cleared by its first writer only, or just invalidated if that pass covers every pixel. Targets no
+///   pass reads afterwards are invalidated after their last use, so tiled GPUs need not write them back to memory.
+/// Execute then runs the passes every frame without deciding anything. Everything GL happens in Compile, Execute and
+/// Clear, on the GL thread.
+/// </summary>
+class FrameGraph
+{
+	public:
+		/// <summary>
+		/// Draws a pass, its framebuffer bound and cleared.
+		/// </summary>
+		typedef void (*ExecuteFunction)(void* context);
+
+		FrameGraph();
+		~FrameGraph();
+
+		/// <summary>
+		/// Declares a texture living only during the frame.
+		/// </summary>
+		/// <param name="internalFormat">A colour format read as floats (GL_RGBA8, GL_RGBA16F...) or a depth format.</param>
+		/// <returns>The texture, for Read, Write and GetTexture.</returns>
+		int CreateTexture(const char* name, GLsizei width, GLsizei height, GLenum internalFormat);
+
+		/// <summary>
+		/// Declares a buffer of the window. Its colour is shown, so passes writing it are never culled and it is never
+		/// invalidated; its depth is invalidated once the last pass is done with it. Passes writing the window draw
+		/// with the viewport set when Execute is called, the others with the size of their targets.
+		/// </summary>
+		/// <param name="buffer">GL_COLOR or GL_DEPTH.</param>
+		int ImportBackbuffer(GLenum buffer);
+
+		/// <summary>
+		/// Sets the colour a colour target is cleared to, transparent black by default. Depth is cleared to 1.
+		/// </summary>
+		void SetClearColour(int texture, GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+		/// <summary>
+		/// Declares a pass.
+		/// </summary>
+		/// <param name="execute">Draws the pass.</param>
+		/// <param name="context">Given to execute.</param>
+		int AddPass(const char* name, ExecuteFunction execute, void* context);
+
+		/// <summary>
+		/// Declares a texture a pass samples.
+		/// </summary>
+		void Read(int pass, int texture);
+
+		/// <summary>
+		/// Declares a texture a pass renders to. The writers of a texture run in the order they wrote it, the ones
+		/// after the first drawing over what the first left.
+		/// </summary>
+		/// <param name="coversAll">True if the pass writes every pixel, so what was there before need not be cleared.</param>
+		void Write(int pass, int texture, bool coversAll = false);
+
+		/// <summary>
+		/// Culls, orders and aliases, then creates the textures and framebuffers. Called again after any change.
+		/// </summary>
+		/// <returns>False if the passes depend on each other in a loop, they run in the order added then.</returns>
+		bool Compile();
+
+		/// <summary>
+		/// Runs the passes kept, in order.
+		/// </summary>
+		void Execute();
+
+		/// <summary>
+		/// Returns the GL texture holding a transient texture, for the passes reading it. Only valid once compiled.
+		/// </summary>
+		GLuint GetTexture(int texture);
+
+		/// <summary>
+		/// Deletes the textures and framebuffers, and forgets the passes.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Prints the passes kept and culled, and the memory the transient textures take with and without aliasing.
+		/// </summary>
+		void PrintStatistics();
+
+	private:
+		struct Resource
+		{
+			const char* name;
+			GLsizei width, height;
+			GLenum internalFormat;
+			GLenum backbuffer; // GL_COLOR or GL_DEPTH for the window, 0 for a transient texture
+			GLfloat clearColour[4];
+			int physical; // Index in physicals, -1 for the window
+			int firstUse, lastUse; // Positions in the order of the first and last pass using it, -1 if none
+		};
+
+		struct Access
+		{
+			int resource;
+			bool coversAll;
+		};
+
+		struct ClearTarget
+		{
+			int resource;
+			GLint drawBuffer; // Of the colour attachment, for glClearBuffer
+		};
+
+		struct Pass
+		{
+			const char* name;
+			ExecuteFunction execute;
+			void* context;
+			std::vector<Access> reads, writes;
+			bool kept;
+
+			// Decided by Compile
+			GLuint framebuffer; // 0 for the window
+			GLsizei width, height;
+			std::vector<ClearTarget> clears; // Targets cleared before the pass
+			std::vector<GLenum> discards; // Attachments invalidated before the pass
+			std::vector<GLenum> invalidates; // Attachments invalidated after the pass
+			std::vector<GLuint> deadTextures; // Textures only sampled so far, invalidated after the pass
+		};
+
+		struct Physical
+		{
+			GLuint texture;
+			GLsizei width, height;
+			GLenum internalFormat;
+			int busyUntil; // Position in the order of the last pass using it
+		};
+
+		/// <summary>
+		/// Marks the kept passes.
+		/// </summary>
+		void Cull();
+
+		/// <summary>
+		/// Returns true if a pass must run after another, both kept.
+		/// </summary>
+		bool DependsOn(int pass, int other);
+
+		/// <summary>
+		/// Returns true if no pass before a position in the order writes a resource.
+		/// </summary>
+		bool IsFirstWriter(int position, int resource);
+
+		/// <summary>
+		/// Sorts the kept passes into order.
+		/// </summary>
+		/// <returns>False if they depend on each other in a loop.</returns>
+		bool Sort();
+
+		/// <summary>
+		/// Gives every transient texture used a GL texture, shared with the others it can be.
+		/// </summary>
+		void Alias();
+
+		/// <summary>
+		/// Creates the framebuffer of a pass and decides its clears and invalidates.
+		/// </summary>
+		void PreparePass(int position);
+
+		/// <summary>
+		/// Returns the attachment a resource is written to in the framebuffer of a pass.
+		/// </summary>
+		GLenum GetAttachment(const Pass& pass, int resource);
+
+		/// <summary>
+		/// Deletes the textures and framebuffers, keeping the passes.
+		/// </summary>
+		void DeleteObjects();
+
+		// Frame graphs cannot be copied, the copy would delete the textures of the original.
+		FrameGraph(const FrameGraph&);
+		FrameGraph& operator=(const FrameGraph&);
+
+		std::vector<Resource> resources;
+		std::vector<Pass> passes;
+		std::vector<int> order; // Kept passes, in the order they run
+		std::vector<Physical> physicals;
+		bool canInvalidate; // glInvalidateFramebuffer and glInvalidateTexImage are there
+};
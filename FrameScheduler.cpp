@@ -0,0 +1,106 @@
+#include "FrameScheduler.h"
+#include <cstdio>
+
+FrameScheduler::FrameScheduler(double stepsPerSecond, int maxFramesInFlight)
+{
+	step = 1.0 / stepsPerSecond;
+	accumulator = 0.0;
+	started = false;
+
+	this->maxFramesInFlight = maxFramesInFlight < 1 ? 1 : maxFramesInFlight > MAX_FRAMES_IN_FLIGHT ? MAX_FRAMES_IN_FLIGHT : maxFramesInFlight;
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		fences[i] = 0;
+	fenceCount = 0;
+
+	frames = 0;
+	steps = 0;
+	waits = 0;
+	droppedSeconds = 0.0;
+	waitMilliseconds = 0.0;
+}
+
+FrameScheduler::~FrameScheduler()
+{
+	Clear();
+}
+
+void FrameScheduler::BeginFrame()
+{
+	WaitForGpu();
+	BeginSteps();
+}
+
+void FrameScheduler::WaitForGpu()
+{
+	// The frame about to start would be one too many in flight, waiting for the oldest to be done.
+	if (fenceCount >= maxFramesInFlight)
+	{
+		if (glClientWaitSync(fences[0], 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			auto start = std::chrono::steady_clock::now();
+			while (glClientWaitSync(fences[0], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+			{
+			}
+			waitMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			waits++;
+		}
+		glDeleteSync(fences[0]);
+		for (int i = 1; i < fenceCount; i++)
+			fences[i - 1] = fences[i];
+		fenceCount--;
+		fences[fenceCount] = 0;
+	}
+}
+
+void FrameScheduler::BeginSteps()
+{
+	// The first frame draws the initial state, without any step.
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (started)
+		accumulator += std::chrono::duration<double>(now - lastFrame).count();
+	lastFrame = now;
+	started = true;
+
+	if (accumulator > step * MAX_STEPS_PER_FRAME)
+	{
+		droppedSeconds += accumulator - step * MAX_STEPS_PER_FRAME;
+		accumulator = step * MAX_STEPS_PER_FRAME;
+	}
+	frames++;
+}
+
+void FrameScheduler::ResetClock()
+{
+	lastFrame = std::chrono::steady_clock::now();
+}
+
+bool FrameScheduler::Step()
+{
+	if (accumulator < step)
+		return false;
+	accumulator -= step;
+	steps++;
+	return true;
+}
+
+void FrameScheduler::EndFrame()
+{
+	if (fenceCount < MAX_FRAMES_IN_FLIGHT)
+		fences[fenceCount++] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void FrameScheduler::Clear()
+{
+	for (int i = 0; i < fenceCount; i++)
+	{
+		glDeleteSync(fences[i]);
+		fences[i] = 0;
+	}
+	fenceCount = 0;
+}
+
+void FrameScheduler::PrintStatistics()
+{
+	printf("Frame pacing: %d frames, %d steps of %.1f ms, %.1f s dropped by slow frames, waited for the GPU %d times (%.1f ms)\n",
+		frames, steps, step * 1000.0, droppedSeconds, waits, waitMilliseconds);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <GL/glew.h>
+#include <chrono>
+
+/// <summary>
+/// Paces the frame loop. The simulation advances in fixed steps whatever the frame rate: each frame runs as many
+/// steps as the time elapsed holds, and drawing blends the last two steps by the time left over (GetAlpha), so
+/// motion is as smooth at 30 as at 144 frames a second and moves at the same speed.
+/// The CPU is also kept from running ahead of the GPU: a fence is set after each frame, and a frame only starts once
+/// the GPU has finished all but the last maxFramesInFlight - 1 frames. Input is then read at most that many frames
+/// before it is shown.
+/// With a render thread, the thread stepping the simulation calls BeginSteps and Step, and the thread owning the GL
+/// context calls WaitForGpu and EndFrame. The two halves share nothing.
+/// </summary>
+class FrameScheduler
+{
+	public:
+		/// <param name="stepsPerSecond">The rate of the simulation.</param>
+		/// <param name="maxFramesInFlight">The frames the GPU may be behind the CPU, from 1 to MAX_FRAMES_IN_FLIGHT.</param>
+		FrameScheduler(double stepsPerSecond = 60.0, int maxFramesInFlight = 2);
+		~FrameScheduler();
+
+		/// <summary>
+		/// Waits for the GPU if too many frames are in flight, then adds the time since the last frame to the steps to run.
+		/// Called first thing in a frame, before reading input.
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Waits for the GPU if too many frames are in flight, the first half of BeginFrame.
+		/// </summary>
+		void WaitForGpu();
+
+		/// <summary>
+		/// Adds the time since the last frame to the steps to run, the second half of BeginFrame.
+		/// </summary>
+		void BeginSteps();
+
+		/// <summary>
+		/// Forgets the time since the last frame, so a loop that slept does not simulate the time it slept.
+		/// </summary>
+		void ResetClock();
+
+		/// <summary>
+		/// Takes one step off the time to simulate.
+		/// </summary>
+		/// <returns>True if a step must be run, false once the simulation has caught up with the frame.</returns>
+		bool Step();
+
+		/// <summary>
+		/// Sets the fence of the frame. Called after the swap.
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>
+		/// Deletes the fences, without waiting.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Returns the time one step simulates, in seconds.
+		/// </summary>
+		float GetStep() { return (float)step; }
+
+		/// <summary>
+		/// Returns how far the frame is between the previous step and the last one, from 0 to 1.
+		/// </summary>
+		float GetAlpha() { return (float)(accumulator / step); }
+
+		/// <summary>
+		/// Prints the frames, the steps, the time dropped by slow frames and the time spent waiting for the GPU.
+		/// </summary>
+		void PrintStatistics();
+
+		static const int MAX_FRAMES_IN_FLIGHT = 4;
+		static const int MAX_STEPS_PER_FRAME = 8; // A slower frame drops the rest rather than falling further behind
+
+	private:
+		double step;
+		double accumulator; // Time not simulated yet, in seconds
+		std::chrono::steady_clock::time_point lastFrame;
+		bool started;
+
+		int maxFramesInFlight;
+		GLsync fences[MAX_FRAMES_IN_FLIGHT]; // Of the frames in flight, oldest at first
+		int fenceCount;
+
+		// Statistics
+		int frames, steps, waits;
+		double droppedSeconds, waitMilliseconds;
+};
@@ -0,0 +1,526 @@
+#include "GltfImporter.h"
+#include "IndependentMesh.h"
+#include "MappedFile.h"
+#include "Json.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+/// <summary>
+/// Start of a GLB file, followed by the JSON chunk and the binary chunk.
+/// </summary>
+struct GlbHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int length;
+};
+
+struct GlbChunk
+{
+	unsigned int length;
+	unsigned int type;
+};
+
+static const unsigned int GLB_MAGIC = 0x46546C67; // "glTF"
+static const unsigned int GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+static const unsigned int GLB_CHUNK_BIN = 0x004E4942; // "BIN\0"
+
+static const int GLTF_MODE_TRIANGLES = 4;
+
+struct GltfView
+{
+	bool valid; // False if the view is not inside the binary chunk
+	size_t offset;
+	size_t length;
+	unsigned int stride;
+	GLuint buffer; // 0 until the view is uploaded
+};
+
+struct GltfAccessor
+{
+	bool valid; // False if its offset or count is not a whole number the importer can hold
+	int view;
+	size_t offset;
+	unsigned int componentType;
+	unsigned int components;
+	unsigned int count;
+};
+
+struct GltfMaterial
+{
+	bool hasColour;
+	float colour[4];
+};
+
+struct GltfPrimitive
+{
+	GLuint VAO, VBO, IBO;
+	unsigned int firstIndex;
+	GLsizei indexCount;
+	GLenum indexType;
+	int material;
+};
+
+/// <summary>
+/// Everything read from the file, while the importer builds the objects.
+/// </summary>
+struct GltfContext
+{
+	const unsigned char* binary;
+	size_t binaryLength;
+	std::vector<GltfView> views;
+	std::vector<GltfAccessor> accessors;
+	std::vector<GltfMaterial> materials;
+	std::vector<std::vector<GltfPrimitive> > meshes;
+	std::vector<GLuint>* buffers;
+	std::vector<GLuint>* vertexArrays;
+};
+
+static unsigned int GetComponentSize(unsigned int componentType)
+{
+	switch (componentType)
+	{
+		case GL_BYTE: case GL_UNSIGNED_BYTE: return 1;
+		case GL_SHORT: case GL_UNSIGNED_SHORT: return 2;
+		case GL_UNSIGNED_INT: case GL_FLOAT: return 4;
+		default: return 0;
+	}
+}
+
+static unsigned int GetComponentCount(JsonValue type)
+{
+	if (type.Equals("SCALAR")) return 1;
+	if (type.Equals("VEC2")) return 2;
+	if (type.Equals("VEC3")) return 3;
+	if (type.Equals("VEC4") || type.Equals("MAT2")) return 4;
+	if (type.Equals("MAT3")) return 9;
+	if (type.Equals("MAT4")) return 16;
+	return 0;
+}
+
+/// <summary>
+/// Reads a byte offset, a byte length or a count, 0 if it is missing. Returns false unless it is a whole number from 0
+/// to 2^32 - 1, the most any of them can be in a GLB file.
+/// </summary>
+static bool ReadSize(JsonValue value, size_t& size)
+{
+	double number = value.IsValid() ? value.AsNumber(-1.0) : 0.0;
+	if (!(number >= 0.0 && number <= 4294967295.0) || number != std::floor(number))
+		return false;
+
+	size = (size_t)number;
+	return true;
+}
+
+/// <summary>
+/// Returns the largest of count indices of type T, packed one after the other.
+/// </summary>
+template<typename T>
+static unsigned int GetMaxIndex(const unsigned char* data, unsigned int count)
+{
+	unsigned int maxIndex = 0;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		T index;
+		memcpy(&index, data + i * sizeof(T), sizeof(T));
+		if (index > maxIndex)
+			maxIndex = index;
+	}
+	return maxIndex;
+}
+
+/// <summary>
+/// Reads up to count numbers of an array, leaving the rest of values as they are.
+/// </summary>
+static void ReadFloats(JsonValue array, float* values, int count)
+{
+	int i = 0;
+	for (JsonValue element = array.First(); element.IsValid() && i < count; element = element.Next())
+	{
+		values[i] = (float)element.AsNumber(values[i]);
+		i++;
+	}
+}
+
+/// <summary>
+/// Returns the transformation of a node, given either as a matrix or as a translation, a rotation and a scale.
+/// </summary>
+static glm::mat4 GetNodeMatrix(JsonValue node)
+{
+	JsonValue matrix = node.Get("matrix");
+	if (matrix.Size() == 16)
+	{
+		// Column major, as glm expects it.
+		float values[16];
+		ReadFloats(matrix, values, 16);
+		return glm::make_mat4(values);
+	}
+
+	float translation[3] = { 0.0f, 0.0f, 0.0f };
+	float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float scale[3] = { 1.0f, 1.0f, 1.0f };
+	ReadFloats(node.Get("translation"), translation, 3);
+	ReadFloats(node.Get("rotation"), rotation, 4);
+	ReadFloats(node.Get("scale"), scale, 3);
+
+	// Rotation matrix of the unit quaternion (x, y, z, w).
+	float x = rotation[0], y = rotation[1], z = rotation[2], w = rotation[3];
+	glm::mat4 rotate(1.0f);
+	rotate[0][0] = 1.0f - 2.0f * (y * y + z * z);
+	rotate[0][1] = 2.0f * (x * y + z * w);
+	rotate[0][2] = 2.0f * (x * z - y * w);
+	rotate[1][0] = 2.0f * (x * y - z * w);
+	rotate[1][1] = 1.0f - 2.0f * (x * x + z * z);
+	rotate[1][2] = 2.0f * (y * z + x * w);
+	rotate[2][0] = 2.0f * (x * z + y * w);
+	rotate[2][1] = 2.0f * (y * z - x * w);
+	rotate[2][2] = 1.0f - 2.0f * (x * x + y * y);
+
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(translation[0], translation[1], translation[2]));
+	return glm::scale(model * rotate, glm::vec3(scale[0], scale[1], scale[2]));
+}
+
+/// <summary>
+/// Returns true if every element of an accessor is inside its buffer view.
+/// </summary>
+static bool AccessorFits(const GltfContext& context, const GltfAccessor& accessor, unsigned int elementSize)
+{
+	if (!accessor.valid || accessor.view < 0 || accessor.view >= (int)context.views.size() || accessor.count == 0)
+		return false;
+
+	const GltfView& view = context.views[accessor.view];
+	unsigned long long stride = view.stride != 0 ? view.stride : elementSize;
+	return view.valid && accessor.offset + (accessor.count - 1) * stride + elementSize <= view.length;
+}
+
+/// <summary>
+/// Uploads a buffer view to the GPU the first time it is needed, straight from the mapped file.
+/// </summary>
+static GLuint UploadView(GltfContext& context, int index)
+{
+	GltfView& view = context.views[index];
+	if (view.buffer == 0)
+	{
+		glGenBuffers(1, &view.buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, view.buffer);
+		glBufferData(GL_ARRAY_BUFFER, view.length, context.binary + view.offset, GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		context.buffers->push_back(view.buffer);
+	}
+	return view.buffer;
+}
+
+/// <summary>
+/// Sets up the drawing of an indexed triangle primitive. Returns false for anything else.
+/// </summary>
+static bool LoadPrimitive(GltfContext& context, JsonValue primitive, GltfPrimitive& result)
+{
+	int position = primitive.Get("attributes").Get("POSITION").AsInt();
+	int indices = primitive.Get("indices").AsInt();
+	JsonValue mode = primitive.Get("mode");
+	if ((mode.IsValid() ? mode.AsInt() : GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES
+		|| position < 0 || position >= (int)context.accessors.size() || indices < 0 || indices >= (int)context.accessors.size())
+		return false;
+
+	const GltfAccessor& positions = context.accessors[position];
+	if (positions.componentType != GL_FLOAT || positions.components != 3 || !AccessorFits(context, positions, 3 * sizeof(GLfloat)))
+		return false;
+
+	// The indices are drawn where they are, so they have to be packed and aligned on their size.
+	const GltfAccessor& elements = context.accessors[indices];
+	unsigned int indexSize = GetComponentSize(elements.componentType);
+	bool indexType = elements.componentType == GL_UNSIGNED_BYTE || elements.componentType == GL_UNSIGNED_SHORT || elements.componentType == GL_UNSIGNED_INT;
+	if (!indexType || elements.components != 1 || !AccessorFits(context, elements, indexSize)
+		|| (context.views[elements.view].stride != 0 && context.views[elements.view].stride != indexSize) || elements.offset % indexSize != 0)
+		return false;
+
+	// An index past the positions would have the GPU read outside of their buffer.
+	const unsigned char* indexData = context.binary + context.views[elements.view].offset + elements.offset;
+	unsigned int maxIndex = elements.componentType == GL_UNSIGNED_BYTE ? GetMaxIndex<unsigned char>(indexData, elements.count)
+		: elements.componentType == GL_UNSIGNED_SHORT ? GetMaxIndex<unsigned short>(indexData, elements.count)
+		: GetMaxIndex<unsigned int>(indexData, elements.count);
+	if (maxIndex >= positions.count)
+		return false;
+
+	result.VBO = UploadView(context, positions.view);
+	result.IBO = UploadView(context, elements.view);
+	result.firstIndex = (unsigned int)(elements.offset / indexSize);
+	result.indexCount = (GLsizei)elements.count;
+	result.indexType = elements.componentType;
+	result.material = primitive.Get("material").AsInt();
+
+	glGenVertexArrays(1, &result.VAO);
+	glBindVertexArray(result.VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, result.VBO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, context.views[positions.view].stride, (void*)positions.offset);
+	glEnableVertexAttribArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	context.vertexArrays->push_back(result.VAO);
+	return true;
+}
+
+GltfImporter::GltfImporter()
+{
+}
+
+GltfImporter::~GltfImporter()
+{
+	Clear();
+}
+
+ComplexObject* GltfImporter::Import(const std::string& path, GLuint modelLocation)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		printf("Could not open the model %s\n", path.c_str());
+		return NULL;
+	}
+
+	// Header, then the JSON chunk, then the optional binary chunk.
+	const unsigned char* data = file.GetData();
+	size_t size = file.GetSize();
+	GlbHeader header;
+	GlbChunk json;
+	if (size < sizeof(header) + sizeof(json))
+	{
+		printf("%s is not a GLB file\n", path.c_str());
+		return NULL;
+	}
+	memcpy(&header, data, sizeof(header));
+	memcpy(&json, data + sizeof(header), sizeof(json));
+	if (header.magic != GLB_MAGIC || header.version != 2 || header.length > size || json.type != GLB_CHUNK_JSON
+		|| json.length > header.length - sizeof(header) - sizeof(json))
+	{
+		printf("%s is not a GLB 2.0 file\n", path.c_str());
+		return NULL;
+	}
+
+	const char* text = (const char*)data + sizeof(header) + sizeof(json);
+	size_t binaryChunk = sizeof(header) + sizeof(json) + json.length;
+
+	GltfContext context;
+	context.binary = NULL;
+	context.binaryLength = 0;
+	context.buffers = &buffers;
+	context.vertexArrays = &vertexArrays;
+
+	GlbChunk binary;
+	if (binaryChunk + sizeof(binary) <= header.length)
+	{
+		memcpy(&binary, data + binaryChunk, sizeof(binary));
+		if (binary.type == GLB_CHUNK_BIN && binary.length <= header.length - binaryChunk - sizeof(binary))
+		{
+			context.binary = data + binaryChunk + sizeof(binary);
+			context.binaryLength = binary.length;
+		}
+	}
+
+	JsonDocument document;
+	if (!document.Parse(text, json.length))
+	{
+		printf("Could not parse the JSON of %s: %s\n", path.c_str(), document.GetError().c_str());
+		return NULL;
+	}
+	JsonValue root = document.GetRoot();
+
+	// Only the binary chunk can be read, which is the first buffer, without any URI.
+	bool binaryBuffer = context.binary != NULL && root.Get("buffers").First().IsValid() && !root.Get("buffers").First().Get("uri").IsValid();
+
+	for (JsonValue value = root.Get("bufferViews").First(); value.IsValid(); value = value.Next())
+	{
+		GltfView view;
+		size_t stride = 0;
+		bool sizes = ReadSize(value.Get("byteOffset"), view.offset) && ReadSize(value.Get("byteLength"), view.length)
+			&& ReadSize(value.Get("byteStride"), stride);
+		view.stride = (unsigned int)stride;
+		view.buffer = 0;
+		view.valid = sizes && binaryBuffer && value.Get("buffer").AsInt() == 0 && view.offset <= context.binaryLength
+			&& view.length <= context.binaryLength - view.offset;
+		context.views.push_back(view);
+	}
+
+	for (JsonValue value = root.Get("accessors").First(); value.IsValid(); value = value.Next())
+	{
+		GltfAccessor accessor;
+		size_t count = 0;
+		accessor.view = value.Get("bufferView").AsInt();
+		accessor.valid = ReadSize(value.Get("byteOffset"), accessor.offset) && ReadSize(value.Get("count"), count);
+		accessor.componentType = (unsigned int)value.Get("componentType").AsInt(0);
+		accessor.components = GetComponentCount(value.Get("type"));
+		accessor.count = (unsigned int)count;
+		context.accessors.push_back(accessor);
+	}
+
+	for (JsonValue value = root.Get("materials").First(); value.IsValid(); value = value.Next())
+	{
+		GltfMaterial material = { false, { 1.0f, 1.0f, 1.0f, 1.0f } };
+		JsonValue colour = value.Get("pbrMetallicRoughness").Get("baseColorFactor");
+		if (colour.IsValid())
+		{
+			material.hasColour = true;
+			ReadFloats(colour, material.colour, 4);
+		}
+		context.materials.push_back(material);
+	}
+
+	int primitiveCount = 0, skipped = 0;
+	for (JsonValue value = root.Get("meshes").First(); value.IsValid(); value = value.Next())
+	{
+		context.meshes.push_back(std::vector<GltfPrimitive>());
+		for (JsonValue primitive = value.Get("primitives").First(); primitive.IsValid(); primitive = primitive.Next())
+		{
+			GltfPrimitive result;
+			if (LoadPrimitive(context, primitive, result))
+			{
+				context.meshes.back().push_back(result);
+				primitiveCount++;
+			}
+			else
+			{
+				skipped++;
+			}
+		}
+	}
+
+	// The nodes are visited many times, so the handles are kept rather than searched for.
+	std::vector<JsonValue> nodes;
+	nodes.reserve(root.Get("nodes").Size());
+	for (JsonValue value = root.Get("nodes").First(); value.IsValid(); value = value.Next())
+	{
+		nodes.push_back(value);
+	}
+
+	// The nodes of the default scene, or every node no other node has as a child if there are no scenes.
+	std::vector<int> roots;
+	// A scene that is not a valid index is missing, as one past the last scene is.
+	JsonValue chosen = root.Get("scene");
+	int sceneIndex = chosen.IsValid() ? chosen.AsInt() : 0;
+	JsonValue scene = sceneIndex >= 0 ? root.Get("scenes").First() : JsonValue();
+	for (int i = sceneIndex; i > 0 && scene.IsValid(); i--)
+	{
+		scene = scene.Next();
+	}
+	if (scene.IsValid())
+	{
+		for (JsonValue value = scene.Get("nodes").First(); value.IsValid(); value = value.Next())
+		{
+			roots.push_back(value.AsInt());
+		}
+	}
+	else
+	{
+		std::vector<bool> child(nodes.size(), false);
+		for (int i = 0; i < nodes.size(); i++)
+		{
+			for (JsonValue value = nodes[i].Get("children").First(); value.IsValid(); value = value.Next())
+			{
+				int index = value.AsInt();
+				if (index >= 0 && index < (int)nodes.size())
+					child[index] = true;
+			}
+		}
+		for (int i = 0; i < nodes.size(); i++)
+		{
+			if (!child[i])
+				roots.push_back(i);
+		}
+	}
+
+	ComplexObject* model = arena.CreateObject();
+	glm::mat4 identity(1.0f);
+	model->SetModelMatrix(identity, modelLocation);
+
+	// Walking the hierarchy with a stack rather than recursion, deep files cannot overflow it.
+	// A node reached twice is only created the first time, so broken files cannot loop.
+	std::vector<std::pair<int, ComplexObject*> > pending;
+	std::vector<bool> created(nodes.size(), false);
+	for (int i = (int)roots.size() - 1; i >= 0; i--)
+	{
+		pending.push_back(std::make_pair(roots[i], model));
+	}
+
+	int nodeCount = 0;
+	std::vector<int> children;
+	while (!pending.empty())
+	{
+		int index = pending.back().first;
+		ComplexObject* parent = pending.back().second;
+		pending.pop_back();
+		if (index < 0 || index >= (int)nodes.size() || created[index])
+			continue;
+		created[index] = true;
+		nodeCount++;
+
+		ComplexObject* object = arena.CreateObject();
+		glm::mat4 matrix = GetNodeMatrix(nodes[index]);
+		object->SetModelMatrix(matrix, modelLocation);
+		parent->objectList.push_back(object);
+
+		int mesh = nodes[index].Get("mesh").AsInt();
+		if (mesh >= 0 && mesh < (int)context.meshes.size())
+		{
+			for (int i = 0; i < context.meshes[mesh].size(); i++)
+			{
+				const GltfPrimitive& primitive = context.meshes[mesh][i];
+				IndependentMesh* part = arena.CreateIndependentMesh();
+				part->SetModelMatrix(identity, modelLocation);
+				part->ShareBuffers(primitive.VAO, primitive.VBO, primitive.IBO, primitive.firstIndex, primitive.indexCount, primitive.indexType);
+
+				// The colour belongs to objects, so coloured primitives get one of their own.
+				if (primitive.material >= 0 && primitive.material < (int)context.materials.size() && context.materials[primitive.material].hasColour)
+				{
+					const float* colour = context.materials[primitive.material].colour;
+					ComplexObject* coloured = arena.CreateObject();
+					coloured->SetColour(colour[0], colour[1], colour[2]);
+					coloured->meshList.push_back(part);
+					object->objectList.push_back(coloured);
+				}
+				else
+				{
+					object->meshList.push_back(part);
+				}
+			}
+		}
+
+		children.clear();
+		for (JsonValue value = nodes[index].Get("children").First(); value.IsValid(); value = value.Next())
+		{
+			children.push_back(value.AsInt());
+		}
+		for (int i = (int)children.size() - 1; i >= 0; i--)
+		{
+			pending.push_back(std::make_pair(children[i], object));
+		}
+	}
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	printf("Imported %s: %d nodes, %d primitives in %.1f ms\n", path.c_str(), nodeCount, primitiveCount, milliseconds);
+	if (skipped > 0)
+	{
+		printf("%d primitives skipped, only indexed triangles with float positions are supported\n", skipped);
+	}
+	return model;
+}
+
+void GltfImporter::Clear()
+{
+	arena.Release();
+
+	if (!vertexArrays.empty())
+	{
+		glDeleteVertexArrays((GLsizei)vertexArrays.size(), vertexArrays.data());
+		vertexArrays.clear();
+	}
+
+	if (!buffers.empty())
+	{
+		glDeleteBuffers((GLsizei)buffers.size(), buffers.data());
+		buffers.clear();
+	}
+}
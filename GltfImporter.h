@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "ComplexObject.h"
+#include "SceneArena.h"
+
+/// <summary>
+/// Importer of binary glTF 2.0 files (.glb) into complex objects.
+/// The file is mapped into memory, its JSON is parsed in place, and the buffer views holding positions and indices
+/// are uploaded to the GPU straight from the mapping. Every glTF node becomes a ComplexObject whose model matrix is
+/// the node's transformation, and every triangle primitive becomes an IndependentMesh drawing the uploaded buffers.
+/// Only the positions and the base colour of materials are used, as the shaders have nothing else to draw with.
+/// </summary>
+class GltfImporter
+{
+	public:
+		GltfImporter();
+		~GltfImporter();
+
+		/// <summary>
+		/// Imports the default scene of a GLB file. The objects, meshes and GPU buffers belong to this importer, which must outlive them.
+		/// </summary>
+		/// <param name="path">Path of the .glb file.</param>
+		/// <param name="modelLocation">The location of the Model Matrix on the GPU</param>
+		/// <returns>An object holding the root nodes of the scene, or NULL if the file cannot be imported.</returns>
+		ComplexObject* Import(const std::string& path, GLuint modelLocation);
+
+		/// <summary>
+		/// Destroys every imported model and clears it from the GPU.
+		/// </summary>
+		void Clear();
+
+	private:
+		std::vector<GLuint> buffers; // One per uploaded buffer view
+		std::vector<GLuint> vertexArrays; // One per primitive
+		SceneArena arena; // The objects and meshes of every imported model
+};
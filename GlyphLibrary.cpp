@@ -0,0 +1,445 @@
+#include "GlyphLibrary.h"
+#include "IndependentMesh.h"
+#include <ctype.h>
+
+const float GlyphLibrary::GLYPH_SPACING = 0.75f;
+const float GlyphLibrary::SPACE_ADVANCE = 3.0f;
+
+/////////////////////////////////////////////////////////////////
+// Glyph table. Vertical strokes are spheres, horizontal ones  //
+// are cubes, like the original letters. Glyphs sit on a cell  //
+// going roughly from -1 to 4 on X and from -1 to 5 on Y.      //
+/////////////////////////////////////////////////////////////////
+
+static const GlyphPart GLYPH_PARTS[] = {
+	// A (same placements as the original hand-made letter)
+	{ PRIMITIVE_CUBE, { 0.0f, 2.5f, 0.0f }, 0.0f, { 4.0f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 0.0f, 5.25f, 0.0f }, 0.0f, { 4.0f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { -5.0f, 0.8f, -0.1f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 5.1f, 0.8f, -0.1f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { -5.0f, 4.0f, -0.1f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 5.1f, 4.0f, -0.1f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	// B
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 2.0f, 4.375f, 0.0f }, 0.0f, { 2.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 2.0f, 2.0f, 0.0f }, 0.0f, { 2.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 2.0f, -0.5f, 0.0f }, 0.0f, { 2.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 5.0f, 3.45f, 0.0f }, 0.0f, { 1.45f, 1.45f, 1.45f } },
+	{ PRIMITIVE_SPHERE, { 5.0f, 0.5f, 0.0f }, 0.0f, { 1.5f, 1.5f, 1.5f } },
+	// C
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// D
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 2.0f, 4.375f, 0.0f }, 0.0f, { 2.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 2.0f, -0.5f, 0.0f }, 0.0f, { 2.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 5.2f, 1.4f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 5.2f, 2.5f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	// E
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 2.25f, 2.0f, 0.0f }, 0.0f, { 2.75f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// F
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 2.25f, 2.0f, 0.0f }, 0.0f, { 2.75f, 0.5f, 1.0f } },
+	// G
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.6f, 0.0f }, 0.0f, { 1.6f, 1.6f, 1.6f } },
+	{ PRIMITIVE_CUBE, { 4.75f, 2.0f, 0.0f }, 0.0f, { 1.75f, 0.5f, 1.0f } },
+	// H
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 2.0f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// I (same placements as the original hand-made letter)
+	{ PRIMITIVE_CUBE, { 0.0f, 4.125f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 0.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 1.75f, 1.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	// J
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.2f, 0.0f }, 0.0f, { 1.2f, 1.2f, 1.2f } },
+	// K
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.6f, 3.45f, 0.0f }, -62.622f, { 0.8f, 3.153f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.6f, 0.5f, 0.0f }, -118.179f, { 0.8f, 3.176f, 1.0f } },
+	// L
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// M
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 1.7f, 3.1f, 0.0f }, -139.086f, { 0.8f, 1.985f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 4.3f, 3.1f, 0.0f }, -40.914f, { 0.8f, 1.985f, 1.0f } },
+	// N (same placements as the original hand-made letter)
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.5f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// O (same placements as the original hand-made letter)
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.5f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.5f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// P
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 2.25f, 4.375f, 0.0f }, 0.0f, { 2.75f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 2.25f, 2.0f, 0.0f }, 0.0f, { 2.75f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 5.6f, 3.4f, 0.0f }, 0.0f, { 1.5f, 1.5f, 1.5f } },
+	// Q
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.5f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.5f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 5.5f, -0.25f, 0.0f }, -119.197f, { 0.8f, 1.947f, 1.0f } },
+	// R (same placements as the original hand-made letter)
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.3f, 0.0f }, 0.0f, { 1.25f, 1.25f, 1.25f } },
+	{ PRIMITIVE_SPHERE, { 5.4f, 2.5f, 0.0f }, 0.0f, { 1.0f, 1.0f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 1.75f, 0.0f }, 0.0f, { 1.25f, 1.25f, 1.25f } },
+	{ PRIMITIVE_CUBE, { 2.625f, 3.15f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 2.625f, 1.4f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.3f, 0.3f, 0.0f }, 72.0f, { 0.5f, 2.6f, 1.0f } },
+	// S (same placements as the original hand-made letter)
+	{ PRIMITIVE_CUBE, { 0.0f, 0.0f, 0.0f }, 0.0f, { 2.75f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 0.0f, 2.25f, 0.0f }, 0.0f, { 2.75f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 0.0f, 4.625f, 0.0f }, 0.0f, { 2.75f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 2.0f, 1.0f, -0.1f }, 0.0f, { 1.25f, 1.25f, 1.25f } },
+	{ PRIMITIVE_SPHERE, { -2.0f, 3.5f, -0.1f }, 0.0f, { 1.25f, 1.25f, 1.25f } },
+	// T
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 4.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 3.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 3.0f, 2.4f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	// U
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// V
+	{ PRIMITIVE_CUBE, { 1.5f, 1.95f, 0.0f }, -153.048f, { 0.8f, 3.309f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 4.5f, 1.95f, 0.0f }, -26.952f, { 0.8f, 3.309f, 1.0f } },
+	// W
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 1.7f, 0.7f, 0.0f }, -40.914f, { 0.8f, 1.985f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 4.3f, 0.7f, 0.0f }, -139.086f, { 0.8f, 1.985f, 1.0f } },
+	// X
+	{ PRIMITIVE_CUBE, { 3.0f, 1.95f, 0.0f }, -134.519f, { 0.8f, 4.207f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 1.95f, 0.0f }, -45.481f, { 0.8f, 4.207f, 1.0f } },
+	// Y
+	{ PRIMITIVE_CUBE, { 1.5f, 3.45f, 0.0f }, -134.029f, { 0.8f, 2.086f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 4.5f, 3.45f, 0.0f }, 134.029f, { 0.8f, 2.086f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 3.0f, 0.55f, 0.0f }, 0.0f, { 1.65f, 1.65f, 1.65f } },
+	// Z
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 1.95f, 0.0f }, 126.209f, { 0.8f, 3.47f, 1.0f } },
+	// 0
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.5f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.5f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 1.95f, 0.0f }, -48.447f, { 0.8f, 2.94f, 1.0f } },
+	// 1
+	{ PRIMITIVE_SPHERE, { 3.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 3.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.0f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 1.5f, 4.2f, 0.0f }, -61.39f, { 0.8f, 1.253f, 1.0f } },
+	// 2
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.438f, 0.0f }, 0.0f, { 1.438f, 1.438f, 1.438f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 2.0f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.5f, 0.0f }, 0.0f, { 1.5f, 1.5f, 1.5f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// 3
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 4.0f, 2.0f, 0.0f }, 0.0f, { 2.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	// 4
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.5f, 0.0f }, 0.0f, { 1.5f, 1.5f, 1.5f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 2.0f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	// 5
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.438f, 0.0f }, 0.0f, { 1.438f, 1.438f, 1.438f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 2.0f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.5f, 0.0f }, 0.0f, { 1.5f, 1.5f, 1.5f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// 6
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 2.0f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.5f, 0.0f }, 0.0f, { 1.5f, 1.5f, 1.5f } },
+	// 7
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.8f, 1.6f, 0.0f }, 139.764f, { 0.8f, 3.406f, 1.0f } },
+	// 8
+	{ PRIMITIVE_SPHERE, { 0.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 2.0f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	// 9
+	{ PRIMITIVE_SPHERE, { 6.0f, 0.9f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_SPHERE, { 6.0f, 3.0f, 0.0f }, 0.0f, { 2.0f, 2.0f, 2.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 4.375f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_CUBE, { 3.0f, 2.0f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+	{ PRIMITIVE_SPHERE, { 0.0f, 3.438f, 0.0f }, 0.0f, { 1.438f, 1.438f, 1.438f } },
+	{ PRIMITIVE_CUBE, { 3.0f, -0.5f, 0.0f }, 0.0f, { 3.5f, 0.5f, 1.0f } },
+};
+
+static const GlyphDefinition GLYPHS[] = {
+	{ 'A', 0, 6 },
+	{ 'B', 6, 7 },
+	{ 'C', 13, 4 },
+	{ 'D', 17, 6 },
+	{ 'E', 23, 5 },
+	{ 'F', 28, 4 },
+	{ 'G', 32, 6 },
+	{ 'H', 38, 5 },
+	{ 'I', 43, 3 },
+	{ 'J', 46, 4 },
+	{ 'K', 50, 4 },
+	{ 'L', 54, 3 },
+	{ 'M', 57, 6 },
+	{ 'N', 63, 5 },
+	{ 'O', 68, 6 },
+	{ 'P', 74, 5 },
+	{ 'Q', 79, 7 },
+	{ 'R', 86, 6 },
+	{ 'S', 92, 5 },
+	{ 'T', 97, 3 },
+	{ 'U', 100, 5 },
+	{ 'V', 105, 2 },
+	{ 'W', 107, 6 },
+	{ 'X', 113, 2 },
+	{ 'Y', 115, 3 },
+	{ 'Z', 118, 3 },
+	{ '0', 121, 7 },
+	{ '1', 128, 4 },
+	{ '2', 132, 5 },
+	{ '3', 137, 5 },
+	{ '4', 142, 4 },
+	{ '5', 146, 5 },
+	{ '6', 151, 6 },
+	{ '7', 157, 2 },
+	{ '8', 159, 7 },
+	{ '9', 166, 6 },
+};
+
+static const int GLYPH_COUNT = sizeof(GLYPHS) / sizeof(GLYPHS[0]);
+static const int GLYPH_PART_COUNT = sizeof(GLYPH_PARTS) / sizeof(GLYPH_PARTS[0]);
+
+GlyphLibrary::GlyphLibrary()
+{
+	primitives = NULL;
+	loaded = false;
+
+	for (int i = 0; i < 128; i++)
+	{
+		glyphIndex[i] = -1;
+	}
+}
+
+GlyphLibrary::~GlyphLibrary()
+{
+}
+
+void GlyphLibrary::Load(PrimitiveLibrary* primitives)
+{
+	if (loaded)
+		return;
+
+	this->primitives = primitives;
+	primitives->Load();
+
+	partMatrices.resize(GLYPH_PART_COUNT);
+	for (int i = 0; i < GLYPH_PART_COUNT; i++)
+	{
+		partMatrices[i] = GetPartMatrix(GLYPH_PARTS[i]);
+	}
+
+	glyphMinX.resize(GLYPH_COUNT);
+	glyphMaxX.resize(GLYPH_COUNT);
+	for (int i = 0; i < GLYPH_COUNT; i++)
+	{
+		glyphIndex[(unsigned char)GLYPHS[i].character] = i;
+
+		// Bounds from the corners of the unit cube around every part, which also contains the unit sphere.
+		glyphMinX[i] = 1e30f;
+		glyphMaxX[i] = -1e30f;
+		for (int p = GLYPHS[i].firstPart; p < GLYPHS[i].firstPart + GLYPHS[i].partCount; p++)
+		{
+			for (int corner = 0; corner < 8; corner++)
+			{
+				glm::vec4 c((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f, 1.0f);
+				float x = (partMatrices[p] * c).x;
+				if (x < glyphMinX[i]) glyphMinX[i] = x;
+				if (x > glyphMaxX[i]) glyphMaxX[i] = x;
+			}
+		}
+	}
+
+	loaded = true;
+}
+
+glm::mat4 GlyphLibrary::GetPartMatrix(const GlyphPart& part)
+{
+	// Half-unit tall, 1 unit wide, 0.25 units deep
+	glm::mat4 model = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f, 1.0f, 0.25f));
+	model = glm::translate(model, glm::vec3(part.translate[0], part.translate[1], part.translate[2]));
+	model = glm::rotate(model, glm::radians(part.rotateZ), glm::vec3(0.0f, 0.0f, 1.0f));
+	model = glm::scale(model, glm::vec3(part.scale[0], part.scale[1], part.scale[2]));
+	return model;
+}
+
+int GlyphLibrary::FindGlyph(unsigned int codepoint)
+{
+	if (codepoint >= 128)
+		return -1;
+	return glyphIndex[toupper((int)codepoint)];
+}
+
+bool GlyphLibrary::HasGlyph(char character)
+{
+	return FindGlyph((unsigned char)character) >= 0;
+}
+
+int GlyphLibrary::GetGlyphCount()
+{
+	return GLYPH_COUNT;
+}
+
+int GlyphLibrary::GetFirstPart(int glyph)
+{
+	return GLYPHS[glyph].firstPart;
+}
+
+int GlyphLibrary::GetPartCount(int glyph)
+{
+	return GLYPHS[glyph].partCount;
+}
+
+float GlyphLibrary::GetMinX(int glyph)
+{
+	return glyphMinX[glyph];
+}
+
+float GlyphLibrary::GetAdvance(int glyph)
+{
+	return glyphMaxX[glyph] - glyphMinX[glyph] + GLYPH_SPACING;
+}
+
+int GlyphLibrary::GetTotalPartCount()
+{
+	return GLYPH_PART_COUNT;
+}
+
+PrimitiveType GlyphLibrary::GetPartPrimitive(int part)
+{
+	return GLYPH_PARTS[part].primitive;
+}
+
+const std::vector<glm::mat4>& GlyphLibrary::GetPartMatrices()
+{
+	return partMatrices;
+}
+
+PrimitiveLibrary* GlyphLibrary::GetPrimitives()
+{
+	return primitives;
+}
+
+ComplexObject* GlyphLibrary::CreateGlyphObject(char character, GLuint uniformModel)
+{
+	int glyph = FindGlyph((unsigned char)character);
+	if (glyph < 0)
+		return NULL;
+
+	ComplexObject* object = new ComplexObject();
+
+	for (int p = GLYPHS[glyph].firstPart; p < GLYPHS[glyph].firstPart + GLYPHS[glyph].partCount; p++)
+	{
+		// The part draws the shared primitive, only its matrix is its own.
+		IndependentMesh* part = new IndependentMesh();
+		part->ShareMesh(primitives->GetMesh(GLYPH_PARTS[p].primitive));
+		part->SetModelMatrix(partMatrices[p], uniformModel);
+		object->meshList.push_back(part);
+	}
+
+	return object;
+}
+
+float GlyphLibrary::LayoutString(const std::string& text, std::vector<GlyphPlacement>& placements)
+{
+	placements.clear();
+	float pen = 0.0f;
+
+	for (int i = 0; i < text.size(); i++)
+	{
+		int glyph = FindGlyph((unsigned char)text[i]);
+		if (glyph < 0)
+		{
+			pen += SPACE_ADVANCE;
+			continue;
+		}
+
+		// Move the glyph so its left edge sits on the pen.
+		glm::mat4 offset = glm::translate(glm::mat4(1.0f), glm::vec3(pen - glyphMinX[glyph], 0.0f, 0.0f));
+
+		for (int p = GLYPHS[glyph].firstPart; p < GLYPHS[glyph].firstPart + GLYPHS[glyph].partCount; p++)
+		{
+			GlyphPlacement placement;
+			placement.primitive = GLYPH_PARTS[p].primitive;
+			placement.model = offset * partMatrices[p];
+			placements.push_back(placement);
+		}
+
+		pen += GetAdvance(glyph);
+	}
+
+	return pen;
+}
+
+void GlyphLibrary::RenderString(const std::vector<GlyphPlacement>& placements, const glm::mat4& stringModel, GLuint uniformModel)
+{
+	for (int i = 0; i < placements.size(); i++)
+	{
+		glm::mat4 model = stringModel * placements[i].model;
+		primitives->GetMesh(placements[i].primitive)->RenderMesh(model, uniformModel);
+	}
+}
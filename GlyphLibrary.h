@@ -0,0 +1,161 @@
+#pragma once
+#include "Primitives.h"
+#include "ComplexObject.h"
+#include <string>
+#include <vector>
+
+/// <summary>
+/// One primitive of a glyph. The part is placed with SIZE * T * Rz * S, where SIZE is the
+/// half-unit tall, 1 unit wide, 0.25 units deep matrix the hand-made letters were always built with.
+/// Sphere radii are folded into the scale.
+/// </summary>
+struct GlyphPart
+{
+	PrimitiveType primitive;
+	float translate[3];
+	float rotateZ; // In degrees
+	float scale[3];
+};
+
+/// <summary>
+/// A glyph: a character and the range of parts in the part table it is built from.
+/// </summary>
+struct GlyphDefinition
+{
+	char character;
+	unsigned short firstPart;
+	unsigned short partCount;
+};
+
+/// <summary>
+/// A primitive placed by a string layout, ready to be drawn with its shared mesh.
+/// </summary>
+struct GlyphPlacement
+{
+	PrimitiveType primitive;
+	glm::mat4 model;
+};
+
+/// <summary>
+/// Data-driven set of glyphs (A-Z and 0-9), each described as a list of primitive placements in a table.
+/// Every glyph draws the shared meshes of a PrimitiveLibrary, so laying out and drawing a new string
+/// does not create anything on the GPU.
+/// </summary>
+class GlyphLibrary
+{
+	public:
+		GlyphLibrary();
+		~GlyphLibrary();
+
+		/// <summary>
+		/// Loads the glyph table: computes the matrix of every part and the bounds of every glyph.
+		/// Also makes sure the primitives are loaded. Does nothing if already loaded.
+		/// </summary>
+		/// <param name="primitives">The primitives shared by every glyph.</param>
+		void Load(PrimitiveLibrary* primitives);
+
+		/// <summary>
+		/// Returns true if the character can be drawn. Lowercase letters use their uppercase glyph.
+		/// </summary>
+		bool HasGlyph(char character);
+
+		/// <summary>
+		/// Creates a complex object for a single glyph, whose meshes share the primitive geometry.
+		/// The object can be transformed, coloured, textured and baked like any other.
+		/// </summary>
+		/// <param name="character">The character wanted.</param>
+		/// <param name="uniformModel">The location of the Model Matrix on the GPU</param>
+		/// <returns>A pointer to the complex object, or NULL if there is no glyph for that character.</returns>
+		ComplexObject* CreateGlyphObject(char character, GLuint uniformModel);
+
+		/// <summary>
+		/// Lays a string out on a line, starting at the origin and going towards +X.
+		/// The placements vector is cleared first, reusing it between calls avoids any allocation.
+		/// </summary>
+		/// <param name="text">The string to lay out. Characters without a glyph are drawn as spaces.</param>
+		/// <param name="placements">Receives one placement per primitive to draw.</param>
+		/// <returns>The width of the laid out string.</returns>
+		float LayoutString(const std::string& text, std::vector<GlyphPlacement>& placements);
+
+		/// <summary>
+		/// Draws laid out placements with the shared primitive meshes.
+		/// </summary>
+		/// <param name="placements">Placements from LayoutString.</param>
+		/// <param name="stringModel">The model matrix to apply to the whole string.</param>
+		/// <param name="uniformModel">The location of the Model Matrix on the GPU</param>
+		void RenderString(const std::vector<GlyphPlacement>& placements, const glm::mat4& stringModel, GLuint uniformModel);
+
+		/// <summary>
+		/// Returns the placement matrix of a part of the table.
+		/// </summary>
+		static glm::mat4 GetPartMatrix(const GlyphPart& part);
+
+		/// <summary>
+		/// Returns the index of the glyph drawing a character, or -1 if there is none.
+		/// Lowercase letters use their uppercase glyph.
+		/// </summary>
+		/// <param name="codepoint">The unicode codepoint of the character.</param>
+		int FindGlyph(unsigned int codepoint);
+		/// <summary>
+		/// Returns the number of glyphs in the glyph table.
+		/// </summary>
+		int GetGlyphCount();
+		/// <summary>
+		/// Returns the index in the part table of the first part of a glyph.
+		/// </summary>
+		int GetFirstPart(int glyph);
+		/// <summary>
+		/// Returns the number of parts of a glyph.
+		/// </summary>
+		int GetPartCount(int glyph);
+		/// <summary>
+		/// Returns the left edge of a glyph.
+		/// </summary>
+		float GetMinX(int glyph);
+		/// <summary>
+		/// Returns the horizontal distance from the left edge of a glyph to the left edge of the next one.
+		/// </summary>
+		float GetAdvance(int glyph);
+		/// <summary>
+		/// Returns the number of parts in the part table.
+		/// </summary>
+		int GetTotalPartCount();
+		/// <summary>
+		/// Returns the primitive used by a part of the part table.
+		/// </summary>
+		PrimitiveType GetPartPrimitive(int part);
+		/// <summary>
+		/// Returns the matrices of every part of the part table, in order.
+		/// </summary>
+		const std::vector<glm::mat4>& GetPartMatrices();
+		/// <summary>
+		/// Returns the shared primitives the glyphs are drawn with.
+		/// </summary>
+		PrimitiveLibrary* GetPrimitives();
+
+		/// <summary>
+		/// Horizontal distance left between two glyphs.
+		/// </summary>
+		static const float GLYPH_SPACING;
+		/// <summary>
+		/// Horizontal distance taken by a space.
+		/// </summary>
+		static const float SPACE_ADVANCE;
+
+	private:
+		PrimitiveLibrary* primitives;
+		bool loaded;
+
+		/// <summary>
+		/// Index in the glyph table for each ASCII character, -1 if there is no glyph.
+		/// </summary>
+		int glyphIndex[128];
+		/// <summary>
+		/// Matrix of each part of the part table, computed once at load.
+		/// </summary>
+		std::vector<glm::mat4> partMatrices;
+		/// <summary>
+		/// Left and right edge of each glyph of the glyph table.
+		/// </summary>
+		std::vector<float> glyphMinX, glyphMaxX;
+};
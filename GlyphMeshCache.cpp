@@ -0,0 +1,235 @@
+#include "GlyphMeshCache.h"
+#include "IndependentMesh.h"
+#include <algorithm>
+#include <cctype>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+size_t GlyphMeshKeyHash::operator()(const GlyphMeshKey& key) const
+{
+	size_t hash = std::hash<unsigned int>()(key.codepoint);
+	hash = hash * 31 + std::hash<float>()(key.style.depth);
+	hash = hash * 31 + std::hash<float>()(key.style.bevel);
+	hash = hash * 31 + std::hash<int>()(key.style.quality);
+	return hash;
+}
+
+GlyphMeshCache::GlyphMeshCache(size_t capacity) : nextGlyph(0), glyphsLeft(0)
+{
+	this->capacity = std::max((size_t)1, capacity);
+	batchKeys = NULL;
+	batchMeshes = NULL;
+	batchSize = 0;
+	generation = 0;
+	busyWorkers = 0;
+	stopping = false;
+}
+
+GlyphMeshCache::~GlyphMeshCache()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+	for (int i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+	Clear();
+}
+
+const MeshData* GlyphMeshCache::Insert(const GlyphMeshKey& key, MeshData& mesh)
+{
+	if (entries.size() >= capacity)
+	{
+		lookup.erase(entries.back().first);
+		entries.pop_back();
+	}
+
+	entries.push_front(std::make_pair(key, MeshData()));
+	entries.front().second.vertices.swap(mesh.vertices);
+	entries.front().second.indices.swap(mesh.indices);
+	lookup[key] = entries.begin();
+	return &entries.front().second;
+}
+
+/// <summary>
+/// Lowercase letters use the uppercase glyph, so they share its cache entry.
+/// </summary>
+static unsigned int ToGlyphCodepoint(unsigned int codepoint)
+{
+	return codepoint < 128 ? (unsigned int)toupper((int)codepoint) : codepoint;
+}
+
+const MeshData* GlyphMeshCache::Get(unsigned int codepoint, const ExtrudeStyle& style)
+{
+	codepoint = ToGlyphCodepoint(codepoint);
+	if (!StrokeFont::HasGlyph(codepoint))
+		return NULL;
+
+	GlyphMeshKey key = { codepoint, style };
+	auto found = lookup.find(key);
+	if (found != lookup.end())
+	{
+		// Move it to the front, it is now the most recently used.
+		entries.splice(entries.begin(), entries, found->second);
+		return &found->second->second;
+	}
+
+	MeshData mesh = StrokeFont::Extrude(codepoint, style);
+	return Insert(key, mesh);
+}
+
+void GlyphMeshCache::Prepare(const std::string& text, const ExtrudeStyle& style)
+{
+	// Every distinct glyph of the string that has to be generated.
+	std::vector<GlyphMeshKey> missing;
+	for (int i = 0; i < text.size(); i++)
+	{
+		GlyphMeshKey key = { ToGlyphCodepoint((unsigned char)text[i]), style };
+		if (!StrokeFont::HasGlyph(key.codepoint) || lookup.count(key) > 0 || std::find(missing.begin(), missing.end(), key) != missing.end())
+			continue;
+		missing.push_back(key);
+	}
+
+	if (missing.empty())
+		return;
+
+	// Glyphs past the capacity would evict the first ones of the batch as soon as they are inserted.
+	if (missing.size() > capacity)
+		missing.resize(capacity);
+	std::vector<MeshData> meshes(missing.size());
+
+	std::unique_lock<std::mutex> lock(mutex);
+	if (missing.size() > 1 && workers.empty())
+	{
+		// The calling thread generates as well, so one worker per other core.
+		int workerCount = (int)std::max(1u, std::thread::hardware_concurrency()) - 1;
+		for (int i = 0; i < workerCount; i++)
+		{
+			workers.push_back(std::thread(&GlyphMeshCache::Run, this));
+		}
+	}
+
+	// Generation only touches the CPU, so each thread takes the next glyph until there are none left.
+	finished.wait(lock, [&]() { return busyWorkers == 0; });
+	batchKeys = missing.data();
+	batchMeshes = meshes.data();
+	batchSize = (int)missing.size();
+	nextGlyph = 0;
+	glyphsLeft = batchSize;
+	generation++;
+	lock.unlock();
+	if (batchSize > 1)
+		started.notify_all();
+
+	GenerateBatch();
+	lock.lock();
+	finished.wait(lock, [&]() { return glyphsLeft == 0 && busyWorkers == 0; });
+	lock.unlock();
+
+	for (int i = 0; i < missing.size(); i++)
+	{
+		Insert(missing[i], meshes[i]);
+	}
+}
+
+void GlyphMeshCache::GenerateBatch()
+{
+	for (int i = nextGlyph++; i < batchSize; i = nextGlyph++)
+	{
+		batchMeshes[i] = StrokeFont::Extrude(batchKeys[i].codepoint, batchKeys[i].style);
+		glyphsLeft--;
+	}
+}
+
+void GlyphMeshCache::Run()
+{
+	unsigned int seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		started.wait(lock, [&]() { return stopping || generation != seen; });
+		if (stopping)
+			return;
+		seen = generation;
+
+		busyWorkers++;
+		lock.unlock();
+		GenerateBatch();
+		lock.lock();
+		if (--busyWorkers == 0)
+			finished.notify_all();
+	}
+}
+
+ComplexObject* GlyphMeshCache::CreateGlyphObject(unsigned int codepoint, const ExtrudeStyle& style, GLuint uniformModel)
+{
+	const MeshData* data = Get(codepoint, style);
+	if (data == NULL)
+		return NULL;
+
+	// The glyph is built from its bottom left corner, move its center to the origin.
+	float width = StrokeFont::GetAdvance(codepoint) - StrokeFont::GLYPH_SPACING;
+	glm::mat4 center = glm::translate(glm::mat4(1.0f), glm::vec3(-width / 2.0f, -3.0f * StrokeFont::GRID_UNIT, 0.0f));
+
+	IndependentMesh* mesh = new IndependentMesh();
+	mesh->CreateMesh(new MeshData(*data));
+	mesh->SetModelMatrix(center, uniformModel);
+
+	ComplexObject* object = new ComplexObject();
+	object->meshList.push_back(mesh);
+	return object;
+}
+
+ComplexObject* GlyphMeshCache::CreateStringObject(const std::string& text, const ExtrudeStyle& style, GLuint uniformModel)
+{
+	Prepare(text, style);
+
+	ComplexObject* object = new ComplexObject();
+	// First mesh created for each character, later occurrences share it.
+	std::unordered_map<unsigned int, Mesh*> uploaded;
+	float pen = 0.0f;
+
+	for (int i = 0; i < text.size(); i++)
+	{
+		unsigned int codepoint = ToGlyphCodepoint((unsigned char)text[i]);
+		const MeshData* data = Get(codepoint, style);
+		if (data != NULL)
+		{
+			glm::mat4 offset = glm::translate(glm::mat4(1.0f), glm::vec3(pen, 0.0f, 0.0f));
+			IndependentMesh* mesh = new IndependentMesh();
+
+			auto found = uploaded.find(codepoint);
+			if (found != uploaded.end())
+			{
+				mesh->ShareMesh(found->second);
+			}
+			else
+			{
+				mesh->CreateMesh(new MeshData(*data));
+				uploaded[codepoint] = mesh;
+			}
+
+			mesh->SetModelMatrix(offset, uniformModel);
+			object->meshList.push_back(mesh);
+		}
+
+		pen += StrokeFont::GetAdvance(codepoint);
+	}
+
+	return object;
+}
+
+size_t GlyphMeshCache::GetSize()
+{
+	return entries.size();
+}
+
+void GlyphMeshCache::Clear()
+{
+	lookup.clear();
+	entries.clear();
+}
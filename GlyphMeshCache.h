@@ -0,0 +1,132 @@
+#pragma once
+#include "StrokeFont.h"
+#include "ComplexObject.h"
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// What a cached glyph mesh was generated from.
+/// </summary>
+struct GlyphMeshKey
+{
+	unsigned int codepoint;
+	ExtrudeStyle style;
+
+	bool operator==(const GlyphMeshKey& other) const
+	{
+		return codepoint == other.codepoint && style == other.style;
+	}
+};
+
+struct GlyphMeshKeyHash
+{
+	size_t operator()(const GlyphMeshKey& key) const;
+};
+
+/// <summary>
+/// Least recently used cache of extruded stroke glyphs, keyed by character, depth, bevel and quality.
+/// Missing glyphs of a whole string are generated in parallel by workers started on first use and kept until the
+/// cache is destroyed, then the cached meshes are drawn through the usual IndependentMesh / ComplexObject path.
+/// </summary>
+class GlyphMeshCache
+{
+	public:
+		/// <summary>
+		/// Creates an empty cache.
+		/// </summary>
+		/// <param name="capacity">How many glyph meshes are kept before the least recently used ones are dropped.</param>
+		GlyphMeshCache(size_t capacity = DEFAULT_CAPACITY);
+		~GlyphMeshCache();
+
+		/// <summary>
+		/// Returns the mesh of a glyph, generating it if it is not cached.
+		/// The pointer is only valid until the next call that can add to the cache.
+		/// </summary>
+		/// <returns>The glyph's mesh, or NULL if there is no glyph for that character.</returns>
+		const MeshData* Get(unsigned int codepoint, const ExtrudeStyle& style);
+
+		/// <summary>
+		/// Generates the glyphs of a string that are not cached yet, spreading them over all the cores. At most
+		/// capacity glyphs are generated: more would evict each other before being used, Get makes the rest when the
+		/// string reaches them.
+		/// </summary>
+		void Prepare(const std::string& text, const ExtrudeStyle& style);
+
+		/// <summary>
+		/// Creates a complex object drawing a single glyph, centered on the origin like the GlyphLibrary glyphs.
+		/// </summary>
+		/// <param name="uniformModel">The location of the Model Matrix on the GPU</param>
+		/// <returns>A pointer to the complex object, or NULL if there is no glyph for that character.</returns>
+		ComplexObject* CreateGlyphObject(unsigned int codepoint, const ExtrudeStyle& style, GLuint uniformModel);
+
+		/// <summary>
+		/// Creates a complex object drawing a string on a line, starting at the origin and going towards +X.
+		/// Repeated characters share the GPU mesh of their first occurrence.
+		/// </summary>
+		/// <param name="text">The string to draw. Characters without a glyph are drawn as spaces.</param>
+		/// <param name="uniformModel">The location of the Model Matrix on the GPU</param>
+		ComplexObject* CreateStringObject(const std::string& text, const ExtrudeStyle& style, GLuint uniformModel);
+
+		/// <summary>
+		/// Returns the number of glyph meshes in the cache.
+		/// </summary>
+		size_t GetSize();
+
+		/// <summary>
+		/// Drops every cached glyph mesh.
+		/// </summary>
+		void Clear();
+
+		static const size_t DEFAULT_CAPACITY = 256;
+
+	private:
+		typedef std::list<std::pair<GlyphMeshKey, MeshData> > EntryList;
+
+		/// <summary>
+		/// Adds a generated mesh as the most recently used one, dropping the least recently used if full.
+		/// </summary>
+		const MeshData* Insert(const GlyphMeshKey& key, MeshData& mesh);
+
+		/// <summary>
+		/// Generates the glyphs of every batch Prepare hands out, until the cache is destroyed.
+		/// </summary>
+		void Run();
+
+		/// <summary>
+		/// Generates the glyphs of the batch left, on a worker or on the thread calling Prepare.
+		/// </summary>
+		void GenerateBatch();
+
+		// Glyph mesh caches cannot be copied, the copy would share the workers.
+		GlyphMeshCache(const GlyphMeshCache&);
+		GlyphMeshCache& operator=(const GlyphMeshCache&);
+
+		/// <summary>
+		/// Cached meshes, most recently used first.
+		/// </summary>
+		EntryList entries;
+		std::unordered_map<GlyphMeshKey, EntryList::iterator, GlyphMeshKeyHash> lookup;
+		size_t capacity;
+
+		std::vector<std::thread> workers;
+
+		// Batch being generated
+		const GlyphMeshKey* batchKeys;
+		MeshData* batchMeshes;
+		int batchSize;
+		std::atomic<int> nextGlyph; // Next glyph of the batch to take
+		std::atomic<int> glyphsLeft; // Glyphs of the batch not generated yet
+
+		// Guarded by mutex
+		std::mutex mutex;
+		std::condition_variable started, finished;
+		unsigned int generation; // Counts the batches, a worker generates when it changes
+		int busyWorkers; // Workers inside GenerateBatch, the next batch only starts once they are out
+		bool stopping;
+};
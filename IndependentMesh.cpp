@@ -2,7 +2,7 @@
 
 IndependentMesh::IndependentMesh() : Mesh()
 {
-	modelMatrix = new glm::mat4(1.0f);
+	modelMatrix = glm::mat4(1.0f);
     uniformModelLocation = 0;
 }
 
@@ -10,8 +10,6 @@ IndependentMesh::~IndependentMesh()
 {
     // Removing the model matrix from gpu
     glUniform1f((*this).uniformModelLocation, 0.0f);
-
-	delete modelMatrix;
 }
 
 void IndependentMesh::RenderMesh()
@@ -27,13 +25,13 @@ void IndependentMesh::RenderMesh()
     glUniformMatrix4fv(uniformModelLocation, // Value to change
         1, // How many matrices to pass
         GL_FALSE, // Transpose?
-        glm::value_ptr(*modelMatrix)); // Our value. Can't pass our value directly. We need to use a pointer.
+        glm::value_ptr(modelMatrix)); // Our value. Can't pass our value directly. We need to use a pointer.
 
     // Drawing our triangles.
     glDrawElements(GL_TRIANGLES, // What to draw
         indexCount, // Count of indices
-        GL_UNSIGNED_INT, // Format of indices
-        0 // Point to the indices, but we dont need it because we have IBO already.
+        indexType, // Format of indices
+        GetIndexOffset() // Where our indices start in the IBO. 0 unless the IBO is shared (see ShareBuffers).
     );
 
     // Removing the model matrix from gpu
@@ -58,13 +56,13 @@ void IndependentMesh::RenderMesh(GLenum drawType)
     glUniformMatrix4fv(uniformModelLocation, // Value to change
         1, // How many matrices to pass
         GL_FALSE, // Transpose?
-        glm::value_ptr(*modelMatrix)); // Our value. Can't pass our value directly. We need to use a pointer.
+        glm::value_ptr(modelMatrix)); // Our value. Can't pass our value directly. We need to use a pointer.
 
     // Drawing our triangles.
     glDrawElements(drawType, // What to draw
         indexCount, // Count of indices
-        GL_UNSIGNED_INT, // Format of indices
-        0 // Point to the indices, but we dont need it because we have IBO already.
+        indexType, // Format of indices
+        GetIndexOffset() // Where our indices start in the IBO. 0 unless the IBO is shared (see ShareBuffers).
     );
 
     // Removing the model matrix from gpu
@@ -86,7 +84,7 @@ void IndependentMesh::RenderMesh(glm::mat4& matrix, GLuint uniformModelLocation)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
 
     // We apply the parent transformation first, then our own.
-    glm::mat4 model = matrix * *modelMatrix;
+    glm::mat4 model = matrix * modelMatrix;
 
     // Reassigning the uniform variable. So now we want to assign a matrix, 4x4, with float values.
     glUniformMatrix4fv(uniformModelLocation, // Value to change
@@ -97,8 +95,8 @@ void IndependentMesh::RenderMesh(glm::mat4& matrix, GLuint uniformModelLocation)
     // Drawing our triangles.
     glDrawElements(GL_TRIANGLES, // What to draw
         indexCount, // Count of indices
-        GL_UNSIGNED_INT, // Format of indices
-        0 // Point to the indices, but we dont need it because we have IBO already.
+        indexType, // Format of indices
+        GetIndexOffset() // Where our indices start in the IBO. 0 unless the IBO is shared (see ShareBuffers).
     );
 
     // Removing the model matrix from gpu
@@ -112,14 +110,17 @@ void IndependentMesh::RenderMesh(glm::mat4& matrix, GLuint uniformModelLocation)
 
 void IndependentMesh::SetModelMatrix(glm::mat4& matrix, GLuint uniformModelLocation)
 {
-    // Removing the model matrix from gpu
-    glUniform1f((*this).uniformModelLocation, 0.0f);
-
-	*modelMatrix = matrix;
+	modelMatrix = matrix;
     this->uniformModelLocation = uniformModelLocation;
 }
 
+glm::mat4 IndependentMesh::GetDrawMatrix(const glm::mat4& matrix, bool fromParent)
+{
+    // Drawn alone, the mesh ignores the matrix in use and sets its own.
+    return fromParent ? matrix * modelMatrix : modelMatrix;
+}
+
 glm::mat4& IndependentMesh::GetModelMatrix()
 {
-	return *modelMatrix;
+	return modelMatrix;
 }
@@ -28,6 +28,11 @@ class IndependentMesh : public Mesh
 		/// <param name="uniformModelLocation">The location of the matrix in the GPU.</param>
 		void RenderMesh(glm::mat4& matrix, GLuint uniformModelLocation);
 
+		/// <summary>
+		/// Returns this mesh's model matrix, combined with the parent's if there is one.
+		/// </summary>
+		glm::mat4 GetDrawMatrix(const glm::mat4& matrix, bool fromParent);
+
 		/// <summary>
 		/// Sets this mesh's custom model matrix.
 		/// </summary>
@@ -39,7 +44,7 @@ class IndependentMesh : public Mesh
 		/// <summary>
 		/// The model matrix of this mesh.
 		/// </summary>
-		glm::mat4* modelMatrix;
+		glm::mat4 modelMatrix;
 		/// <summary>
 		/// The location of the model matrix of this mesh.
 		/// </summary>
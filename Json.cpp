@@ -0,0 +1,364 @@
+#include "Json.h"
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+JsonValue::JsonValue()
+{
+	document = NULL;
+	index = 0;
+	limit = 0;
+}
+
+JsonValue::JsonValue(const JsonDocument* document, unsigned int index, unsigned int limit)
+{
+	this->document = document;
+	this->index = index;
+	this->limit = limit;
+}
+
+JsonType JsonValue::GetType() const
+{
+	return document != NULL ? document->nodes[index].type : JSON_NULL;
+}
+
+unsigned int JsonValue::Size() const
+{
+	return document != NULL ? document->nodes[index].count : 0;
+}
+
+JsonValue JsonValue::Get(const char* key) const
+{
+	if (GetType() != JSON_OBJECT)
+		return JsonValue();
+
+	size_t keyLength = strlen(key);
+	for (JsonValue member = First(); member.IsValid(); member = member.Next())
+	{
+		const JsonNode& node = document->nodes[member.index];
+		if (node.keyLength == keyLength && memcmp(node.key, key, keyLength) == 0)
+			return member;
+	}
+	return JsonValue();
+}
+
+JsonValue JsonValue::First() const
+{
+	if (Size() == 0)
+		return JsonValue();
+	return JsonValue(document, index + 1, document->nodes[index].end);
+}
+
+JsonValue JsonValue::Next() const
+{
+	if (document == NULL)
+		return JsonValue();
+
+	// The next sibling starts right after everything inside this value.
+	unsigned int next = document->nodes[index].end;
+	if (next >= limit)
+		return JsonValue();
+	return JsonValue(document, next, limit);
+}
+
+double JsonValue::AsNumber(double fallback) const
+{
+	return GetType() == JSON_NUMBER ? document->nodes[index].number : fallback;
+}
+
+int JsonValue::AsInt(int fallback) const
+{
+	// Casting a number an int cannot hold is undefined, so those are not integers either.
+	double number = AsNumber(0.5);
+	if (!(number >= INT_MIN && number <= INT_MAX) || number != std::floor(number))
+		return fallback;
+	return (int)number;
+}
+
+bool JsonValue::AsBool(bool fallback) const
+{
+	JsonType type = GetType();
+	return type == JSON_TRUE ? true : type == JSON_FALSE ? false : fallback;
+}
+
+std::string JsonValue::AsString(const std::string& fallback) const
+{
+	if (GetType() != JSON_STRING)
+		return fallback;
+	const JsonNode& node = document->nodes[index];
+	return std::string(node.text, node.length);
+}
+
+bool JsonValue::Equals(const char* text) const
+{
+	if (GetType() != JSON_STRING)
+		return false;
+	const JsonNode& node = document->nodes[index];
+	return strlen(text) == node.length && memcmp(node.text, text, node.length) == 0;
+}
+
+bool JsonDocument::Parse(const char* text, size_t length)
+{
+	nodes.clear();
+	// Roughly one value every few characters, so the array rarely grows while parsing.
+	nodes.reserve(length / 8 + 1);
+	start = text;
+	cursor = text;
+	stop = text + length;
+	error.clear();
+
+	SkipSpace();
+	if (!ParseValue(NULL, 0, 0))
+	{
+		nodes.clear();
+		return false;
+	}
+
+	// Binary containers pad the text with spaces or zeros.
+	SkipSpace();
+	while (cursor < stop && *cursor == '\0')
+		cursor++;
+	if (cursor != stop)
+	{
+		nodes.clear();
+		return Fail("unexpected text after the document");
+	}
+	return true;
+}
+
+JsonValue JsonDocument::GetRoot() const
+{
+	if (nodes.empty())
+		return JsonValue();
+	return JsonValue(this, 0, (unsigned int)nodes.size());
+}
+
+bool JsonDocument::ParseValue(const char* key, unsigned int keyLength, int depth)
+{
+	if (depth > MAX_DEPTH)
+		return Fail("too deeply nested");
+	if (cursor >= stop)
+		return Fail("unexpected end of the document");
+
+	unsigned int index = (unsigned int)nodes.size();
+	JsonNode node;
+	memset(&node, 0, sizeof(node));
+	node.key = key;
+	node.keyLength = keyLength;
+	nodes.push_back(node);
+
+	// The array can grow while the children are parsed, so the node is only accessed through its index.
+	char c = *cursor;
+	if (c == '{' || c == '[')
+	{
+		bool object = c == '{';
+		char close = object ? '}' : ']';
+		nodes[index].type = object ? JSON_OBJECT : JSON_ARRAY;
+		cursor++;
+		SkipSpace();
+
+		if (cursor < stop && *cursor == close)
+		{
+			cursor++;
+		}
+		else
+		{
+			unsigned int count = 0;
+			while (true)
+			{
+				const char* memberKey = NULL;
+				unsigned int memberKeyLength = 0;
+				if (object)
+				{
+					if (cursor >= stop || *cursor != '"' || !ParseString(memberKey, memberKeyLength))
+						return Fail("expected a member name");
+					SkipSpace();
+					if (cursor >= stop || *cursor != ':')
+						return Fail("expected ':'");
+					cursor++;
+					SkipSpace();
+				}
+
+				if (!ParseValue(memberKey, memberKeyLength, depth + 1))
+					return false;
+				count++;
+
+				SkipSpace();
+				if (cursor < stop && *cursor == ',')
+				{
+					cursor++;
+					SkipSpace();
+					continue;
+				}
+				if (cursor < stop && *cursor == close)
+				{
+					cursor++;
+					break;
+				}
+				return Fail(object ? "expected ',' or '}'" : "expected ',' or ']'");
+			}
+			nodes[index].count = count;
+		}
+	}
+	else if (c == '"')
+	{
+		nodes[index].type = JSON_STRING;
+		if (!ParseString(nodes[index].text, nodes[index].length))
+			return false;
+	}
+	else if (c == 't')
+	{
+		nodes[index].type = JSON_TRUE;
+		if (!ParseLiteral("true"))
+			return false;
+	}
+	else if (c == 'f')
+	{
+		nodes[index].type = JSON_FALSE;
+		if (!ParseLiteral("false"))
+			return false;
+	}
+	else if (c == 'n')
+	{
+		nodes[index].type = JSON_NULL;
+		if (!ParseLiteral("null"))
+			return false;
+	}
+	else
+	{
+		nodes[index].type = JSON_NUMBER;
+		if (!ParseNumber(nodes[index].number))
+			return false;
+	}
+
+	nodes[index].end = (unsigned int)nodes.size();
+	return true;
+}
+
+bool JsonDocument::ParseString(const char*& text, unsigned int& length)
+{
+	// Skipping the opening quote, then looking for the closing one, jumping over escaped characters.
+	const char* first = ++cursor;
+	while (cursor < stop && *cursor != '"')
+	{
+		if (*cursor == '\\')
+			cursor++;
+		cursor++;
+	}
+	if (cursor >= stop)
+		return Fail("unterminated string");
+
+	text = first;
+	length = (unsigned int)(cursor - first);
+	cursor++;
+	return true;
+}
+
+bool JsonDocument::ParseNumber(double& number)
+{
+	bool negative = false;
+	if (cursor < stop && *cursor == '-')
+	{
+		negative = true;
+		cursor++;
+	}
+	if (cursor >= stop || *cursor < '0' || *cursor > '9')
+		return Fail("unexpected character");
+
+	// Digits are gathered as an integer and a power of ten, so most numbers need a single multiplication.
+	unsigned long long mantissa = 0;
+	int exponent = 0;
+	int digits = 0;
+	while (cursor < stop && *cursor >= '0' && *cursor <= '9')
+	{
+		if (digits < 19)
+		{
+			mantissa = mantissa * 10 + (*cursor - '0');
+			digits += mantissa > 0 ? 1 : 0;
+		}
+		else
+		{
+			exponent++;
+		}
+		cursor++;
+	}
+
+	if (cursor < stop && *cursor == '.')
+	{
+		cursor++;
+		if (cursor >= stop || *cursor < '0' || *cursor > '9')
+			return Fail("expected a digit after '.'");
+		while (cursor < stop && *cursor >= '0' && *cursor <= '9')
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*cursor - '0');
+				digits += mantissa > 0 ? 1 : 0;
+				exponent--;
+			}
+			cursor++;
+		}
+	}
+
+	if (cursor < stop && (*cursor == 'e' || *cursor == 'E'))
+	{
+		cursor++;
+		bool negativeExponent = false;
+		if (cursor < stop && (*cursor == '+' || *cursor == '-'))
+		{
+			negativeExponent = *cursor == '-';
+			cursor++;
+		}
+		if (cursor >= stop || *cursor < '0' || *cursor > '9')
+			return Fail("expected a digit in the exponent");
+
+		int value = 0;
+		while (cursor < stop && *cursor >= '0' && *cursor <= '9')
+		{
+			if (value < 10000)
+				value = value * 10 + (*cursor - '0');
+			cursor++;
+		}
+		exponent += negativeExponent ? -value : value;
+	}
+
+	static const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	double value = (double)mantissa;
+	if (exponent == 0)
+		number = value;
+	else if (exponent > 0 && exponent <= 22)
+		number = value * POWERS_OF_TEN[exponent];
+	else if (exponent < 0 && exponent >= -22)
+		number = value / POWERS_OF_TEN[-exponent];
+	else
+		number = value * pow(10.0, exponent);
+
+	if (negative)
+		number = -number;
+	return true;
+}
+
+bool JsonDocument::ParseLiteral(const char* literal)
+{
+	size_t length = strlen(literal);
+	if ((size_t)(stop - cursor) < length || memcmp(cursor, literal, length) != 0)
+		return Fail("unexpected character");
+	cursor += length;
+	return true;
+}
+
+void JsonDocument::SkipSpace()
+{
+	while (cursor < stop && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r'))
+		cursor++;
+}
+
+bool JsonDocument::Fail(const char* message)
+{
+	if (error.empty())
+	{
+		error = message;
+		error += " at offset " + std::to_string(cursor - start);
+	}
+	return false;
+}
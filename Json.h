@@ -0,0 +1,114 @@
+#pragma once
+#include <string>
+#include <vector>
+
+enum JsonType { JSON_NULL, JSON_FALSE, JSON_TRUE, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+
+/// <summary>
+/// A value parsed by JsonDocument. Keys and strings point into the parsed text, escapes are left as they are.
+/// </summary>
+struct JsonNode
+{
+	JsonType type;
+	const char* key; // Name of the member, NULL outside of objects
+	unsigned int keyLength;
+	const char* text; // Contents of a string, without the quotes
+	unsigned int length;
+	unsigned int count; // Number of elements or members
+	unsigned int end; // Index of the first node after this value and everything inside it
+	double number;
+};
+
+class JsonDocument;
+
+/// <summary>
+/// A handle to a value of a JsonDocument, cheap to copy. Looking up a missing value gives an invalid handle,
+/// whose accessors return their fallback, so optional values can be read without checking every step.
+/// </summary>
+class JsonValue
+{
+	public:
+		JsonValue();
+
+		/// <summary>
+		/// Returns false if this handle does not point at a value, after looking up a missing member for example.
+		/// </summary>
+		bool IsValid() const { return document != NULL; }
+		JsonType GetType() const;
+
+		/// <summary>
+		/// Returns the number of elements of an array or members of an object, 0 for any other value.
+		/// </summary>
+		unsigned int Size() const;
+
+		/// <summary>
+		/// Returns the member of an object with the given name. Members are searched in order.
+		/// </summary>
+		JsonValue Get(const char* key) const;
+
+		/// <summary>
+		/// Returns the first element of an array or member of an object. Go through the others with Next.
+		/// </summary>
+		JsonValue First() const;
+
+		/// <summary>
+		/// Returns the element or member after this one, or an invalid handle after the last one.
+		/// </summary>
+		JsonValue Next() const;
+
+		/// <summary>
+		/// Return the value, or fallback if it is not of that type. AsInt only takes whole numbers an int can hold.
+		/// </summary>
+		double AsNumber(double fallback = 0.0) const;
+		int AsInt(int fallback = -1) const;
+		bool AsBool(bool fallback = false) const;
+		std::string AsString(const std::string& fallback = "") const;
+
+		/// <summary>
+		/// Returns true if this value is a string equal to text.
+		/// </summary>
+		bool Equals(const char* text) const;
+
+	private:
+		friend class JsonDocument;
+		JsonValue(const JsonDocument* document, unsigned int index, unsigned int limit);
+
+		const JsonDocument* document;
+		unsigned int index;
+		unsigned int limit; // End of the parent, where the siblings stop
+};
+
+/// <summary>
+/// Parser of JSON text into a flat array of values, in the order they appear in the text.
+/// Nothing is copied out of the text, which must outlive the document.
+/// </summary>
+class JsonDocument
+{
+	public:
+		/// <summary>
+		/// Parses a whole document, replacing the previous one.
+		/// </summary>
+		/// <returns>False if the text is not valid JSON, GetError then tells where.</returns>
+		bool Parse(const char* text, size_t length);
+
+		JsonValue GetRoot() const;
+		const std::string& GetError() const { return error; }
+
+		static const int MAX_DEPTH = 256;
+
+	private:
+		friend class JsonValue;
+
+		bool ParseValue(const char* key, unsigned int keyLength, int depth);
+		bool ParseString(const char*& text, unsigned int& length);
+		bool ParseNumber(double& number);
+		bool ParseLiteral(const char* literal);
+		void SkipSpace();
+		bool Fail(const char* message);
+
+		std::vector<JsonNode> nodes;
+		const char* start;
+		const char* cursor;
+		const char* stop;
+		std::string error;
+};
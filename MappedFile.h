@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+
+/// <summary>
+/// A whole file mapped read-only into memory, with mmap or MapViewOfFile on Windows.
+/// Its contents can be read in place and uploaded to the GPU without reading the file into a buffer first.
+/// The mapping starts on a page boundary.
+/// </summary>
+class MappedFile
+{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		/// <summary>
+		/// Maps a file, unmapping the previous one.
+		/// </summary>
+		/// <returns>False if the file cannot be opened or is empty.</returns>
+		bool Open(const std::string& path);
+
+		/// <summary>
+		/// Unmaps the file. Pointers into it are no longer valid.
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Returns the contents of the file, or NULL if none is mapped.
+		/// </summary>
+		const unsigned char* GetData() { return data; }
+
+		/// <summary>
+		/// Returns the size of the file in bytes.
+		/// </summary>
+		size_t GetSize() { return size; }
+
+	private:
+		// Mapped files cannot be copied, the copy would unmap the file of the original.
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+
+		const unsigned char* data;
+		size_t size;
+		void* fileHandle; // Handles of the mapping on Windows
+		void* mappingHandle;
+};
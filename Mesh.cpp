@@ -1,4 +1,5 @@
 #include "Mesh.h"
+#include "CommandBuffer.h"
 
 Mesh::Mesh()
 {
@@ -6,17 +7,45 @@ Mesh::Mesh()
 	VBO = 0;
 	IBO = 0;
 	indexCount = 0;
+	firstIndex = 0;
+	indexType = GL_UNSIGNED_INT;
+	sourceData = NULL;
+	staticVertices = NULL;
+	staticIndices = NULL;
+	staticVertexCount = 0;
+	staticIndexCount = 0;
+	sharedSource = NULL;
+	sharesBuffers = false;
 }
 
 Mesh::~Mesh()
 {
 	ClearMesh();
+
+	if (!sharesBuffers)
+	{
+		delete sourceData;
+	}
+	sourceData = NULL;
 }
 
-void Mesh::CreateMesh(GLfloat* vertices, unsigned int* indices, unsigned int numOfVertices, unsigned int numOfIndices)
+void Mesh::CreateMesh(const GLfloat* vertices, const unsigned int* indices, unsigned int numOfVertices, unsigned int numOfIndices)
 {
+    if (sharesBuffers)
+    {
+        // We are getting our own buffers, stop pointing at the shared ones.
+        ClearMesh();
+        sourceData = NULL;
+        sharedSource = NULL;
+        sharesBuffers = false;
+    }
+    staticVertices = NULL;
+    staticIndices = NULL;
+
     // Updating our member variables
     indexCount = numOfIndices;
+    firstIndex = 0;
+    indexType = GL_UNSIGNED_INT;
 
     // Creating our VAO. 1- Amount of arrays and then 2- Where to store the ID of the array.
     // This now creates some stuff in the graphics card and its memory.
@@ -71,6 +100,130 @@ void Mesh::CreateMesh(GLfloat* vertices, unsigned int* indices, unsigned int num
     // And now we are not indented anymore! Because we have unbound our vertex array.
 }
 
+void Mesh::CreateMesh(MeshData* data)
+{
+    if (data->vertices.empty() || data->indices.empty())
+    {
+        // A bake or a union can come out empty, then there is nothing to upload and nothing is drawn.
+        ClearMesh();
+        if (sharesBuffers)
+        {
+            sourceData = NULL;
+            sharedSource = NULL;
+            sharesBuffers = false;
+        }
+        staticVertices = NULL;
+        staticIndices = NULL;
+    }
+    else
+    {
+        CreateMesh(data->vertices.data(), data->indices.data(), data->vertices.size(), data->indices.size());
+    }
+
+    // Keeping the geometry, so it can be merged with other meshes when baking.
+    if (sourceData != data)
+    {
+        delete sourceData;
+    }
+    sourceData = data;
+}
+
+void Mesh::CreateStaticMesh(const GLfloat* vertices, const unsigned int* indices, unsigned int numOfVertices, unsigned int numOfIndices)
+{
+    CreateMesh(vertices, indices, numOfVertices, numOfIndices);
+
+    // No copy yet, GetSourceData builds one if the mesh is ever baked.
+    delete sourceData;
+    sourceData = NULL;
+    staticVertices = vertices;
+    staticIndices = indices;
+    staticVertexCount = numOfVertices;
+    staticIndexCount = numOfIndices;
+}
+
+void Mesh::ShareMesh(Mesh* source)
+{
+    ClearMesh();
+    if (!sharesBuffers)
+    {
+        delete sourceData;
+    }
+
+    VAO = source->VAO;
+    VBO = source->VBO;
+    IBO = source->IBO;
+    indexCount = source->indexCount;
+    firstIndex = source->firstIndex;
+    indexType = source->indexType;
+    // Asking the source for its data rather than copying the pointer, it may only build it later.
+    sourceData = NULL;
+    staticVertices = NULL;
+    staticIndices = NULL;
+    sharedSource = source;
+    sharesBuffers = true;
+}
+
+void Mesh::ShareBuffers(GLuint VAO, GLuint VBO, GLuint IBO, unsigned int firstIndex, GLsizei indexCount, GLenum indexType)
+{
+    ClearMesh();
+    if (!sharesBuffers)
+    {
+        delete sourceData;
+    }
+
+    this->VAO = VAO;
+    this->VBO = VBO;
+    this->IBO = IBO;
+    this->firstIndex = firstIndex;
+    this->indexCount = indexCount;
+    this->indexType = indexType;
+    sourceData = NULL;
+    staticVertices = NULL;
+    staticIndices = NULL;
+    sharedSource = NULL;
+    sharesBuffers = true;
+}
+
+const void* Mesh::GetIndexOffset()
+{
+    GLsizeiptr indexSize = indexType == GL_UNSIGNED_BYTE ? 1 : indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+    return (const void*)(firstIndex * indexSize);
+}
+
+MeshData* Mesh::GetSourceData()
+{
+    if (sharedSource != NULL)
+    {
+        return sharedSource->GetSourceData();
+    }
+
+    if (sourceData == NULL && staticVertices != NULL)
+    {
+        sourceData = new MeshData();
+        sourceData->vertices.assign(staticVertices, staticVertices + staticVertexCount);
+        sourceData->indices.assign(staticIndices, staticIndices + staticIndexCount);
+    }
+    return sourceData;
+}
+
+GLsizei Mesh::GetTriangleCount()
+{
+    return indexCount / 3;
+}
+
+glm::mat4 Mesh::GetDrawMatrix(const glm::mat4& matrix, bool)
+{
+    return matrix;
+}
+
+void Mesh::RecordMesh(CommandBuffer& commands, GLenum drawType)
+{
+    if (indexCount == 0)
+        return;
+    commands.BindVertexArray(VAO, IBO);
+    commands.DrawElements(drawType, indexCount, indexType, GetIndexOffset());
+}
+
 void Mesh::RenderMesh()
 {
     // We want to work with our created VAO.
@@ -83,8 +236,8 @@ void Mesh::RenderMesh()
     // Drawing our triangles.
     glDrawElements(GL_TRIANGLES, // What to draw
         indexCount, // Count of indices
-        GL_UNSIGNED_INT, // Format of indices
-        0 // Point to the indices, but we dont need it because we have IBO already.
+        indexType, // Format of indices
+        GetIndexOffset() // Where our indices start in the IBO. 0 unless the IBO is shared (see ShareBuffers).
     );
 
     // We unbind the VAO.
@@ -105,8 +258,8 @@ void Mesh::RenderMesh(GLenum drawType)
     // Drawing our triangles.
     glDrawElements(drawType, // What to draw
         indexCount, // Count of indices
-        GL_UNSIGNED_INT, // Format of indices
-        0 // Point to the indices, but we dont need it because we have IBO already.
+        indexType, // Format of indices
+        GetIndexOffset() // Where our indices start in the IBO. 0 unless the IBO is shared (see ShareBuffers).
     );
 
     // We unbind the VAO.
@@ -136,8 +289,8 @@ void Mesh::RenderMesh(glm::mat4& matrix, GLuint uniformModelLocation)
     // Drawing our triangles.
     glDrawElements(GL_TRIANGLES, // What to draw
         indexCount, // Count of indices
-        GL_UNSIGNED_INT, // Format of indices
-        0 // Point to the indices, but we dont need it because we have IBO already.
+        indexType, // Format of indices
+        GetIndexOffset() // Where our indices start in the IBO. 0 unless the IBO is shared (see ShareBuffers).
     );
 
     // Removing the model matrix from gpu
@@ -151,6 +304,18 @@ void Mesh::RenderMesh(glm::mat4& matrix, GLuint uniformModelLocation)
 
 void Mesh::ClearMesh()
 {
+    if (sharesBuffers)
+    {
+        // The buffers belong to another mesh, we just stop using them.
+        VAO = 0;
+        VBO = 0;
+        IBO = 0;
+        indexCount = 0;
+        firstIndex = 0;
+        indexType = GL_UNSIGNED_INT;
+        return;
+    }
+
     if (IBO != 0)
     {
         // Cleaning the buffers.
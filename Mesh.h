@@ -3,12 +3,15 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "MeshData.h"
+
+class CommandBuffer;
 
 class Mesh
 {
 	public:
 		Mesh();
-		~Mesh();
+		virtual ~Mesh();
 
 		/// <summary>
 		/// Creates a mesh using the supplied parameters
@@ -17,7 +20,66 @@ class Mesh
 		/// <param name="indices">Pointer to the indices for index drawing of the mesh.</param>
 		/// <param name="numOfVertices">Number of vertices</param>
 		/// <param name="numOfIndices">Number of indices in the index drawing array</param>
-		void CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices);
+		void CreateMesh(const GLfloat *vertices, const unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices);
+		/// <summary>
+		/// Creates a mesh from CPU-side geometry, and keeps that geometry around so the mesh can be baked later on.
+		/// </summary>
+		/// <param name="data">The geometry of the mesh. The mesh takes ownership of it.</param>
+		void CreateMesh(MeshData* data);
+		/// <summary>
+		/// Creates a mesh straight from geometry in static storage, such as a table of PrimitiveTables. Nothing is
+		/// copied on the CPU: the source data is only built from the arrays the first time it is asked for.
+		/// </summary>
+		/// <param name="vertices">The vertices of the mesh. They must outlive the mesh.</param>
+		/// <param name="indices">The indices of the mesh. They must outlive the mesh.</param>
+		/// <param name="numOfVertices">Number of vertices</param>
+		/// <param name="numOfIndices">Number of indices in the index drawing array</param>
+		void CreateStaticMesh(const GLfloat* vertices, const unsigned int* indices, unsigned int numOfVertices, unsigned int numOfIndices);
+		/// <summary>
+		/// Same as above, from a table of PrimitiveTables, such as SphereTable&lt;24, 12&gt;::Get().
+		/// </summary>
+		template<typename Table>
+		void CreateStaticMesh(const Table& table)
+		{
+			CreateStaticMesh(table.vertices, table.indices, Table::VERTEX_COUNT * 3, Table::INDEX_COUNT);
+		}
+		/// <summary>
+		/// Makes this mesh draw the GPU buffers (and source data) of another mesh, without owning them.
+		/// Clearing or deleting this mesh leaves the other one intact, so many meshes can share the same geometry.
+		/// </summary>
+		/// <param name="source">The mesh to share. It must outlive this mesh.</param>
+		void ShareMesh(Mesh* source);
+		/// <summary>
+		/// Makes this mesh draw a range of GPU buffers it does not own, such as the buffers of a whole scene loaded at once.
+		/// </summary>
+		/// <param name="VAO">The vertex array to draw with.</param>
+		/// <param name="VBO">The vertex buffer the vertex array reads.</param>
+		/// <param name="IBO">The index buffer holding the range.</param>
+		/// <param name="firstIndex">Position of the first index of this mesh in the IBO.</param>
+		/// <param name="indexCount">Number of indices of this mesh.</param>
+		/// <param name="indexType">GL_UNSIGNED_INT, GL_UNSIGNED_SHORT or GL_UNSIGNED_BYTE, the type of the indices in the IBO.</param>
+		void ShareBuffers(GLuint VAO, GLuint VBO, GLuint IBO, unsigned int firstIndex, GLsizei indexCount, GLenum indexType = GL_UNSIGNED_INT);
+		/// <summary>
+		/// Returns the CPU-side geometry this mesh was created from, or NULL if it was created from raw arrays.
+		/// Meshes sharing another mesh return the source data of that mesh.
+		/// </summary>
+		MeshData* GetSourceData();
+		/// <summary>
+		/// Returns the number of triangles drawn by this mesh.
+		/// </summary>
+		GLsizei GetTriangleCount();
+		/// <summary>
+		/// Returns the number of indices drawn by this mesh.
+		/// </summary>
+		GLsizei GetIndexCount() { return indexCount; }
+		/// <summary>
+		/// Returns the vertex buffer of this mesh, to build other vertex arrays on top of it (instancing).
+		/// </summary>
+		GLuint GetVBO() { return VBO; }
+		/// <summary>
+		/// Returns the index buffer of this mesh, to build other vertex arrays on top of it (instancing).
+		/// </summary>
+		GLuint GetIBO() { return IBO; }
 		/// <summary>
 		/// Draws the mesh on screen
 		/// </summary>
@@ -31,6 +93,17 @@ class Mesh
 		/// <param name="matrix">The model matrix, representing the transformation to apply.</param>
 		/// <param name="uniformModelLocation">The location of the provided model matrix.</param>
 		virtual void RenderMesh(glm::mat4& matrix, GLuint uniformModelLocation);
+		/// <summary>
+		/// Returns the model matrix the mesh is drawn with, for recording the draw instead of making it
+		/// </summary>
+		/// <param name="matrix">The model matrix of the parent, or the one already in use if there is no parent.</param>
+		/// <param name="fromParent">True if the matrix is the parent's, as RenderMesh(matrix, location) gets it.</param>
+		virtual glm::mat4 GetDrawMatrix(const glm::mat4& matrix, bool fromParent);
+		/// <summary>
+		/// Records the draw of the mesh into a command buffer, the model matrix already set
+		/// </summary>
+		/// <param name="drawType">GL_TRIANGLES, GL_LINES or GL_POINTS.</param>
+		void RecordMesh(CommandBuffer& commands, GLenum drawType);
 		
 		/// <summary>
 		/// Clears the mesh from the GPU.
@@ -39,7 +112,20 @@ class Mesh
 
 
 	protected:
+		/// <summary>
+		/// Returns where the indices of this mesh start in the IBO, in bytes, as glDrawElements expects it.
+		/// </summary>
+		const void* GetIndexOffset();
+
 		GLuint VAO, VBO, IBO;
 		GLsizei indexCount; // Just an integer, but recognized by openGL to represent a size.
+		unsigned int firstIndex; // Where the indices of this mesh start in the IBO, 0 unless the IBO is shared (see ShareBuffers).
+		GLenum indexType; // Type of the indices, GL_UNSIGNED_INT unless the IBO is shared (see ShareBuffers).
+		MeshData* sourceData; // Geometry kept on the CPU for baking. NULL if not kept, or not built yet.
+		const GLfloat* staticVertices; // Static geometry the source data is built from on demand (see CreateStaticMesh).
+		const unsigned int* staticIndices;
+		unsigned int staticVertexCount, staticIndexCount;
+		Mesh* sharedSource; // The mesh whose source data this one uses (see ShareMesh). NULL if not sharing a mesh.
+		bool sharesBuffers; // True if the buffers belong to another mesh (see ShareMesh).
 };
 
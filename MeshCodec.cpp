@@ -0,0 +1,499 @@
+#include "MeshCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MESH_CODEC_SSE2
+#endif
+
+/// <summary>
+/// Start of every encoded mesh, followed by the vertex stream and the index stream.
+/// </summary>
+struct MeshCodecHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int vertexCount;
+	unsigned int indexCount;
+	float origin[3]; // Position of the quantized value 0
+	float step[3]; // Distance between two quantized values
+	unsigned int vertexBytes;
+	unsigned int indexBytes;
+};
+
+static const char CODEC_MAGIC[4] = { 'M', 'S', 'H', 'C' };
+static const unsigned int NO_VERTEX = 0xFFFFFFFF;
+static const int STREAM_PADDING = 8; // The bit unpacker reads 8 bytes at a time
+static const int MISSED_EDGE = 15; // Edge code of a triangle stored with its 3 vertices
+static const int EXPLICIT_VERTEX = 15; // Vertex code of a vertex stored as a number
+
+/// <summary>
+/// The edges and vertices of the last triangles, kept the same way by the encoder and the decoder.
+/// </summary>
+struct TriangleHistory
+{
+	unsigned int edgeStart[MeshCodec::EDGE_HISTORY];
+	unsigned int edgeEnd[MeshCodec::EDGE_HISTORY];
+	unsigned int edgeCount;
+	unsigned int vertices[MeshCodec::VERTEX_HISTORY];
+	unsigned int vertexCount;
+	unsigned int next; // The vertex a triangle uses for the first time, vertices are numbered in order of first use
+
+	TriangleHistory()
+	{
+		memset(this, 0, sizeof(*this));
+	}
+
+	void PushEdge(unsigned int start, unsigned int end)
+	{
+		edgeStart[edgeCount % MeshCodec::EDGE_HISTORY] = start;
+		edgeEnd[edgeCount % MeshCodec::EDGE_HISTORY] = end;
+		edgeCount++;
+	}
+
+	// Edge i, 0 being the most recent one.
+	unsigned int EdgeSlot(int i)
+	{
+		return (edgeCount - 1 - i) % MeshCodec::EDGE_HISTORY;
+	}
+
+	void PushVertex(unsigned int vertex)
+	{
+		vertices[vertexCount % MeshCodec::VERTEX_HISTORY] = vertex;
+		vertexCount++;
+	}
+
+	// Vertex i, 0 being the most recent one.
+	unsigned int GetVertex(int i)
+	{
+		return vertices[(vertexCount - 1 - i) % MeshCodec::VERTEX_HISTORY];
+	}
+};
+
+static void WriteVarint(std::vector<unsigned char>& out, unsigned int value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+static bool ReadVarint(const unsigned char*& data, const unsigned char* end, unsigned int& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		if (data >= end)
+			return false;
+		unsigned char byte = *data++;
+		value |= (unsigned int)(byte & 0x7F) << shift;
+		if (byte < 0x80)
+			return true;
+	}
+	return false;
+}
+
+static unsigned int ZigZag(int value)
+{
+	return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static int UnZigZag(unsigned int value)
+{
+	return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+/// <summary>
+/// Returns the 4 bit code of a vertex of a triangle, and adds it to the history.
+/// Vertices that are neither new nor recent are written as a number after the code bytes.
+/// </summary>
+static int EncodeVertex(TriangleHistory& history, unsigned int vertex, std::vector<unsigned char>& numbers)
+{
+	int code = EXPLICIT_VERTEX;
+	if (vertex == history.next)
+	{
+		code = 0;
+		history.next++;
+	}
+	else
+	{
+		int recent = history.vertexCount < MeshCodec::VERTEX_HISTORY ? history.vertexCount : MeshCodec::VERTEX_HISTORY;
+		for (int i = 0; i < recent && i < EXPLICIT_VERTEX - 1; i++)
+		{
+			if (history.GetVertex(i) == vertex)
+			{
+				code = i + 1;
+				break;
+			}
+		}
+		if (code == EXPLICIT_VERTEX)
+		{
+			WriteVarint(numbers, ZigZag((int)vertex - (int)history.next));
+		}
+	}
+
+	history.PushVertex(vertex);
+	return code;
+}
+
+static bool DecodeVertex(TriangleHistory& history, int code, const unsigned char*& data, const unsigned char* end, unsigned int& vertex)
+{
+	if (code == 0)
+	{
+		vertex = history.next++;
+	}
+	else if (code == EXPLICIT_VERTEX)
+	{
+		unsigned int number;
+		if (!ReadVarint(data, end, number))
+			return false;
+		vertex = history.next + UnZigZag(number);
+	}
+	else
+	{
+		vertex = history.GetVertex(code - 1);
+	}
+
+	history.PushVertex(vertex);
+	return true;
+}
+
+/// <summary>
+/// Unpacks 16 values of the given width, written one after the other from the lowest bit.
+/// </summary>
+template<int Width>
+static void UnpackBlock(const unsigned char* data, uint16_t* values)
+{
+	for (int i = 0; i < MeshCodec::BLOCK_SIZE; i++)
+	{
+		int bit = i * Width;
+		uint64_t word;
+		memcpy(&word, data + bit / 8, sizeof(word));
+		values[i] = (uint16_t)((word >> (bit % 8)) & ((1u << Width) - 1));
+	}
+}
+
+/// <summary>
+/// Turns 16 zigzag differences into values, continuing from the last value of the previous block.
+/// </summary>
+static uint16_t SumBlock(uint16_t* values, uint16_t previous)
+{
+#ifdef MESH_CODEC_SSE2
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i carry = _mm_set1_epi16((short)previous);
+
+	for (int half = 0; half < 2; half++)
+	{
+		__m128i delta = _mm_loadu_si128((const __m128i*)(values + half * 8));
+		delta = _mm_xor_si128(_mm_srli_epi16(delta, 1), _mm_sub_epi16(zero, _mm_and_si128(delta, one)));
+
+		// Prefix sum of the 8 lanes in 3 steps, then the sum of everything before.
+		delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 2));
+		delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 4));
+		delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 8));
+		delta = _mm_add_epi16(delta, carry);
+		_mm_storeu_si128((__m128i*)(values + half * 8), delta);
+
+		__m128i last = _mm_shufflehi_epi16(delta, 0xFF);
+		carry = _mm_unpackhi_epi64(last, last);
+	}
+	return values[MeshCodec::BLOCK_SIZE - 1];
+#else
+	for (int i = 0; i < MeshCodec::BLOCK_SIZE; i++)
+	{
+		uint16_t delta = (uint16_t)((values[i] >> 1) ^ (uint16_t)-(int)(values[i] & 1));
+		previous = (uint16_t)(previous + delta);
+		values[i] = previous;
+	}
+	return previous;
+#endif
+}
+
+std::vector<unsigned char> MeshCodec::Encode(const MeshData& mesh)
+{
+	unsigned int sourceCount = mesh.VertexCount();
+	unsigned int indexCount = (unsigned int)(mesh.indices.size() / 3 * 3);
+
+	// Renumbering the vertices in the order they are first used.
+	std::vector<unsigned int> remap(sourceCount, NO_VERTEX);
+	std::vector<unsigned int> order;
+	order.reserve(sourceCount);
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int index = mesh.indices[i];
+		if (index < sourceCount && remap[index] == NO_VERTEX)
+		{
+			remap[index] = (unsigned int)order.size();
+			order.push_back(index);
+		}
+	}
+	unsigned int vertexCount = (unsigned int)order.size();
+
+	MeshCodecHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CODEC_MAGIC, sizeof(CODEC_MAGIC));
+	header.version = VERSION;
+	header.vertexCount = vertexCount;
+
+	float maximum[3] = { 0.0f, 0.0f, 0.0f };
+	for (int k = 0; k < 3; k++)
+	{
+		header.origin[k] = vertexCount > 0 ? mesh.vertices[order[0] * 3 + k] : 0.0f;
+		maximum[k] = header.origin[k];
+	}
+	for (unsigned int i = 0; i < vertexCount; i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			float value = mesh.vertices[order[i] * 3 + k];
+			header.origin[k] = value < header.origin[k] ? value : header.origin[k];
+			maximum[k] = value > maximum[k] ? value : maximum[k];
+		}
+	}
+	for (int k = 0; k < 3; k++)
+	{
+		header.step[k] = (maximum[k] - header.origin[k]) / 65535.0f;
+	}
+
+	std::vector<unsigned char> out(sizeof(header));
+
+	// Vertex stream: each coordinate on its own, by blocks of 16 differences.
+	size_t vertexStart = out.size();
+	for (int k = 0; k < 3; k++)
+	{
+		uint16_t previous = 0;
+		for (unsigned int block = 0; block < vertexCount; block += BLOCK_SIZE)
+		{
+			unsigned int values[BLOCK_SIZE];
+			unsigned int largest = 0;
+			for (int i = 0; i < BLOCK_SIZE; i++)
+			{
+				uint16_t quantized = previous;
+				if (block + i < vertexCount && header.step[k] > 0.0f)
+				{
+					float scaled = (mesh.vertices[order[block + i] * 3 + k] - header.origin[k]) / header.step[k];
+					quantized = (uint16_t)std::min(65535.0f, std::max(0.0f, std::floor(scaled + 0.5f)));
+				}
+				else if (block + i < vertexCount)
+				{
+					quantized = 0;
+				}
+
+				int16_t delta = (int16_t)(uint16_t)(quantized - previous);
+				values[i] = (uint16_t)(((uint16_t)delta << 1) ^ (uint16_t)(delta >> 15));
+				largest |= values[i];
+				previous = quantized;
+			}
+
+			int width = 0;
+			while (width < 16 && (largest >> width) != 0)
+				width++;
+			out.push_back((unsigned char)width);
+
+			uint64_t bits = 0;
+			int bitCount = 0;
+			for (int i = 0; i < BLOCK_SIZE; i++)
+			{
+				bits |= (uint64_t)values[i] << bitCount;
+				bitCount += width;
+				while (bitCount >= 8)
+				{
+					out.push_back((unsigned char)bits);
+					bits >>= 8;
+					bitCount -= 8;
+				}
+			}
+		}
+	}
+	out.insert(out.end(), STREAM_PADDING, 0);
+	header.vertexBytes = (unsigned int)(out.size() - vertexStart);
+
+	// Index stream: one or two code bytes per triangle, then the vertices that had to be written as numbers.
+	size_t indexStart = out.size();
+	TriangleHistory history;
+	std::vector<unsigned char> numbers;
+	for (unsigned int t = 0; t < indexCount; t += 3)
+	{
+		unsigned int triangle[3];
+		for (int i = 0; i < 3; i++)
+		{
+			unsigned int index = mesh.indices[t + i];
+			triangle[i] = index < sourceCount ? remap[index] : 0;
+		}
+
+		// A neighbour goes along the shared edge the other way round, which is how the edges are kept.
+		int edge = MISSED_EDGE, rotation = 0;
+		int recent = history.edgeCount < EDGE_HISTORY ? history.edgeCount : EDGE_HISTORY;
+		for (int r = 0; r < 3 && edge == MISSED_EDGE; r++)
+		{
+			unsigned int a = triangle[r], b = triangle[(r + 1) % 3];
+			for (int i = 0; i < recent && i < MISSED_EDGE; i++)
+			{
+				unsigned int slot = history.EdgeSlot(i);
+				if (history.edgeStart[slot] == a && history.edgeEnd[slot] == b)
+				{
+					edge = i;
+					rotation = r;
+					break;
+				}
+			}
+		}
+
+		numbers.clear();
+		if (edge != MISSED_EDGE)
+		{
+			unsigned int a = triangle[rotation], b = triangle[(rotation + 1) % 3], c = triangle[(rotation + 2) % 3];
+			out.push_back((unsigned char)((edge << 4) | EncodeVertex(history, c, numbers)));
+			history.PushEdge(c, b);
+			history.PushEdge(a, c);
+		}
+		else
+		{
+			int first = EncodeVertex(history, triangle[0], numbers);
+			int second = EncodeVertex(history, triangle[1], numbers);
+			int third = EncodeVertex(history, triangle[2], numbers);
+			out.push_back((unsigned char)((MISSED_EDGE << 4) | first));
+			out.push_back((unsigned char)((second << 4) | third));
+			history.PushEdge(triangle[1], triangle[0]);
+			history.PushEdge(triangle[2], triangle[1]);
+			history.PushEdge(triangle[0], triangle[2]);
+		}
+		out.insert(out.end(), numbers.begin(), numbers.end());
+	}
+	header.indexCount = indexCount;
+	header.indexBytes = (unsigned int)(out.size() - indexStart);
+
+	memcpy(&out[0], &header, sizeof(header));
+	return out;
+}
+
+bool MeshCodec::Decode(const unsigned char* data, size_t size, MeshData& mesh)
+{
+	mesh.Clear();
+
+	MeshCodecHeader header;
+	if (size < sizeof(header))
+		return false;
+	memcpy(&header, data, sizeof(header));
+
+	// Every block and every triangle takes at least a byte, which bounds the counts before anything is allocated.
+	unsigned long long blockCount = ((unsigned long long)header.vertexCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	if (memcmp(header.magic, CODEC_MAGIC, sizeof(CODEC_MAGIC)) != 0 || header.version != VERSION || header.indexCount % 3 != 0
+		|| (unsigned long long)sizeof(header) + header.vertexBytes + header.indexBytes != size
+		|| header.vertexBytes < 3 * blockCount + STREAM_PADDING || header.indexBytes < header.indexCount / 3)
+		return false;
+
+	const unsigned char* vertexData = data + sizeof(header);
+	const unsigned char* vertexEnd = vertexData + header.vertexBytes - STREAM_PADDING;
+
+	// Coordinates are decoded one after the other, then put back together as positions.
+	size_t stride = blockCount * BLOCK_SIZE;
+	std::vector<uint16_t> quantized(3 * stride);
+	for (int k = 0; k < 3; k++)
+	{
+		uint16_t* values = &quantized[k * stride];
+		uint16_t previous = 0;
+		for (unsigned long long block = 0; block < blockCount; block++, values += BLOCK_SIZE)
+		{
+			if (vertexData >= vertexEnd)
+				return false;
+			int width = *vertexData++;
+			if (width > 16 || vertexEnd - vertexData < 2 * width)
+				return false;
+
+			switch (width)
+			{
+				case 0: memset(values, 0, BLOCK_SIZE * sizeof(uint16_t)); break;
+				case 1: UnpackBlock<1>(vertexData, values); break;
+				case 2: UnpackBlock<2>(vertexData, values); break;
+				case 3: UnpackBlock<3>(vertexData, values); break;
+				case 4: UnpackBlock<4>(vertexData, values); break;
+				case 5: UnpackBlock<5>(vertexData, values); break;
+				case 6: UnpackBlock<6>(vertexData, values); break;
+				case 7: UnpackBlock<7>(vertexData, values); break;
+				case 8: UnpackBlock<8>(vertexData, values); break;
+				case 9: UnpackBlock<9>(vertexData, values); break;
+				case 10: UnpackBlock<10>(vertexData, values); break;
+				case 11: UnpackBlock<11>(vertexData, values); break;
+				case 12: UnpackBlock<12>(vertexData, values); break;
+				case 13: UnpackBlock<13>(vertexData, values); break;
+				case 14: UnpackBlock<14>(vertexData, values); break;
+				case 15: UnpackBlock<15>(vertexData, values); break;
+				case 16: UnpackBlock<16>(vertexData, values); break;
+			}
+			vertexData += 2 * width;
+			previous = SumBlock(values, previous);
+		}
+	}
+	if (vertexData != vertexEnd)
+		return false;
+
+	mesh.vertices.resize(3 * (size_t)header.vertexCount);
+	const uint16_t* x = &quantized[0];
+	const uint16_t* y = &quantized[stride];
+	const uint16_t* z = &quantized[2 * stride];
+	GLfloat* position = mesh.vertices.data();
+	for (unsigned int i = 0; i < header.vertexCount; i++)
+	{
+		position[3 * i] = header.origin[0] + x[i] * header.step[0];
+		position[3 * i + 1] = header.origin[1] + y[i] * header.step[1];
+		position[3 * i + 2] = header.origin[2] + z[i] * header.step[2];
+	}
+
+	const unsigned char* indexData = data + sizeof(header) + header.vertexBytes;
+	const unsigned char* indexEnd = indexData + header.indexBytes;
+	mesh.indices.resize(header.indexCount);
+	unsigned int* triangle = mesh.indices.data();
+	TriangleHistory history;
+	for (unsigned int t = 0; t < header.indexCount; t += 3, triangle += 3)
+	{
+		if (indexData >= indexEnd)
+		{
+			mesh.Clear();
+			return false;
+		}
+
+		int code = *indexData++;
+		int edge = code >> 4;
+		bool valid;
+		if (edge != MISSED_EDGE)
+		{
+			unsigned int slot = history.EdgeSlot(edge);
+			triangle[0] = history.edgeStart[slot];
+			triangle[1] = history.edgeEnd[slot];
+			valid = DecodeVertex(history, code & 15, indexData, indexEnd, triangle[2]);
+			history.PushEdge(triangle[2], triangle[1]);
+			history.PushEdge(triangle[0], triangle[2]);
+		}
+		else
+		{
+			int codes = indexData < indexEnd ? *indexData++ : -1;
+			valid = codes >= 0
+				&& DecodeVertex(history, code & 15, indexData, indexEnd, triangle[0])
+				&& DecodeVertex(history, codes >> 4, indexData, indexEnd, triangle[1])
+				&& DecodeVertex(history, codes & 15, indexData, indexEnd, triangle[2]);
+			history.PushEdge(triangle[1], triangle[0]);
+			history.PushEdge(triangle[2], triangle[1]);
+			history.PushEdge(triangle[0], triangle[2]);
+		}
+
+		if (!valid || triangle[0] >= header.vertexCount || triangle[1] >= header.vertexCount || triangle[2] >= header.vertexCount)
+		{
+			mesh.Clear();
+			return false;
+		}
+	}
+
+	if (indexData != indexEnd)
+	{
+		mesh.Clear();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include "MeshData.h"
+
+/// <summary>
+/// Compact encoding of a MeshData, for the meshes kept on disk.
+/// Positions are quantized to 16 bits inside the bounding box of the mesh, each coordinate is stored as the zigzag
+/// encoded difference with the previous vertex, and the differences are bit packed by blocks of 16 at the width of
+/// the largest one. Triangles are stored against a small history of their edges: a triangle sharing an edge with
+/// one of the last triangles costs a single byte when its third vertex is new or recent.
+/// Vertices are renumbered in the order the triangles first use them, which keeps both streams small.
+/// Decoding sums the differences up with SSE2 when the compiler targets it; the bit unpacking and the triangles are
+/// decoded by scalar code. Decoding gives 0.4 to 2.5 GB/s of output per core depending on the mesh, so small or
+/// noisy meshes fall short of 1 GB/s. About two thirds of the time goes into the triangles, which depend on each
+/// other through the history, so unpacking the positions with SIMD would not lift those past 1 GB/s.
+/// </summary>
+class MeshCodec
+{
+	public:
+		/// <summary>
+		/// Encodes a mesh. Positions lose precision, to 1/65535 of the size of the mesh on each axis.
+		/// Vertices no triangle uses are dropped.
+		/// </summary>
+		static std::vector<unsigned char> Encode(const MeshData& mesh);
+
+		/// <summary>
+		/// Decodes a mesh written by Encode, ready for Mesh::CreateMesh.
+		/// </summary>
+		/// <returns>False if the data is damaged or from another version, the mesh is left empty then.</returns>
+		static bool Decode(const unsigned char* data, size_t size, MeshData& mesh);
+
+		static const unsigned int VERSION = 1;
+		static const int BLOCK_SIZE = 16; // Values packed at the same width
+		static const int EDGE_HISTORY = 16; // Edges a triangle can be stored against
+		static const int VERTEX_HISTORY = 16; // Vertices a triangle can refer to in a single byte
+};
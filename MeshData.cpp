@@ -0,0 +1,336 @@
+#include "MeshData.h"
+#include <cmath>
+#include <unordered_map>
+
+MeshData::MeshData()
+{
+	vertices = std::vector<GLfloat>();
+	indices = std::vector<unsigned int>();
+}
+
+MeshData::~MeshData()
+{
+}
+
+unsigned int MeshData::VertexCount() const
+{
+	return (unsigned int)vertices.size() / 3;
+}
+
+unsigned int MeshData::TriangleCount() const
+{
+	return (unsigned int)indices.size() / 3;
+}
+
+glm::vec3 MeshData::GetVertex(unsigned int index) const
+{
+	return glm::vec3(vertices[index * 3], vertices[index * 3 + 1], vertices[index * 3 + 2]);
+}
+
+void MeshData::Append(const MeshData& other, const glm::mat4& transform)
+{
+	unsigned int baseIndex = VertexCount();
+
+	vertices.reserve(vertices.size() + other.vertices.size());
+	for (unsigned int i = 0; i < other.VertexCount(); i++)
+	{
+		glm::vec4 p = transform * glm::vec4(other.GetVertex(i), 1.0f);
+		vertices.push_back(p.x);
+		vertices.push_back(p.y);
+		vertices.push_back(p.z);
+	}
+
+	// The indices of the appended mesh are shifted past our existing vertices.
+	indices.reserve(indices.size() + other.indices.size());
+	for (int i = 0; i < other.indices.size(); i++)
+	{
+		indices.push_back(other.indices[i] + baseIndex);
+	}
+}
+
+void MeshData::Weld(float epsilon)
+{
+	// Vertices are snapped to a grid of cell size epsilon. Two vertices closer than epsilon can still fall on either side
+	// of a cell border, so the cells around are searched too before a vertex starts a cell of its own. Cells are keyed
+	// by a hash, different cells sharing a key only cost a distance test.
+	std::unordered_multimap<long long, unsigned int> cells;
+	std::vector<unsigned int> remap(VertexCount());
+	std::vector<GLfloat> welded;
+
+	for (unsigned int i = 0; i < VertexCount(); i++)
+	{
+		long long cx = (long long)std::floor(vertices[i * 3] / epsilon + 0.5f);
+		long long cy = (long long)std::floor(vertices[i * 3 + 1] / epsilon + 0.5f);
+		long long cz = (long long)std::floor(vertices[i * 3 + 2] / epsilon + 0.5f);
+
+		bool merged = false;
+		for (int n = 0; n < 27 && !merged; n++)
+		{
+			long long key = ((cx + n % 3 - 1) * 73856093LL) ^ ((cy + n / 3 % 3 - 1) * 19349663LL) ^ ((cz + n / 9 - 1) * 83492791LL);
+			std::pair<std::unordered_multimap<long long, unsigned int>::iterator, std::unordered_multimap<long long, unsigned int>::iterator> range = cells.equal_range(key);
+			for (std::unordered_multimap<long long, unsigned int>::iterator found = range.first; found != range.second && !merged; ++found)
+			{
+				if (glm::length(GetVertex(i) - glm::vec3(welded[found->second * 3], welded[found->second * 3 + 1], welded[found->second * 3 + 2])) <= epsilon)
+				{
+					remap[i] = found->second;
+					merged = true;
+				}
+			}
+		}
+		if (merged)
+			continue;
+
+		long long key = (cx * 73856093LL) ^ (cy * 19349663LL) ^ (cz * 83492791LL);
+		remap[i] = (unsigned int)welded.size() / 3;
+		cells.insert(std::make_pair(key, remap[i]));
+		welded.push_back(vertices[i * 3]);
+		welded.push_back(vertices[i * 3 + 1]);
+		welded.push_back(vertices[i * 3 + 2]);
+	}
+
+	std::vector<unsigned int> weldedIndices;
+	weldedIndices.reserve(indices.size());
+	for (int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		unsigned int a = remap[indices[i]];
+		unsigned int b = remap[indices[i + 1]];
+		unsigned int c = remap[indices[i + 2]];
+
+		// Triangles that collapsed onto a line or a point no longer cover anything.
+		if (a == b || b == c || c == a)
+			continue;
+
+		weldedIndices.push_back(a);
+		weldedIndices.push_back(b);
+		weldedIndices.push_back(c);
+	}
+
+	vertices.swap(welded);
+	indices.swap(weldedIndices);
+}
+
+void MeshData::Clear()
+{
+	vertices.clear();
+	indices.clear();
+}
+
+MeshData MeshData::Cube()
+{
+	MeshData cube;
+
+	GLfloat vertices[] = {
+		// front
+		-1.0, -1.0,  1.0,
+		1.0, -1.0,  1.0,
+		1.0,  1.0,  1.0,
+		-1.0,  1.0,  1.0,
+		// back
+		-1.0, -1.0, -1.0,
+		1.0, -1.0, -1.0,
+		1.0,  1.0, -1.0,
+		-1.0,  1.0, -1.0
+	};
+
+	unsigned int indices[] = {
+		// front
+		0, 1, 2,
+		2, 3, 0,
+		// right
+		1, 5, 6,
+		6, 2, 1,
+		// back
+		7, 6, 5,
+		5, 4, 7,
+		// left
+		4, 0, 3,
+		3, 7, 4,
+		// bottom
+		4, 5, 1,
+		1, 0, 4,
+		// top
+		3, 2, 6,
+		6, 7, 3
+	};
+
+	cube.vertices.assign(vertices, vertices + 24);
+	cube.indices.assign(indices, indices + 36);
+	return cube;
+}
+
+MeshData MeshData::Sphere(float radius, int longitudeCount, int latitudeCount)
+{
+	MeshData sphere;
+
+	//////////////////////////////////////////////////////////
+	// Source: http://www.songho.ca/opengl/gl_sphere.html. //
+
+	// Generate vertices
+	float x, y, z, xy;                              // vertex position
+
+	float sectorStep = 2 * glm::pi<float>() / longitudeCount;
+	float stackStep = glm::pi<float>() / latitudeCount;
+	float sectorAngle, stackAngle;
+
+	for (int i = 0; i <= latitudeCount; ++i)
+	{
+		stackAngle = glm::pi<float>() / 2 - i * stackStep;        // starting from pi/2 to -pi/2
+		xy = radius * cosf(stackAngle);             // r * cos(u)
+		z = radius * sinf(stackAngle);              // r * sin(u)
+
+													// add (sectorCount+1) vertices per stack
+													// the first and last vertices have same position and normal, but different tex coords
+		for (int j = 0; j <= longitudeCount; ++j)
+		{
+			sectorAngle = j * sectorStep;           // starting from 0 to 2pi
+
+													// vertex position (x, y, z)
+			x = xy * cosf(sectorAngle);             // r * cos(u) * cos(v)
+			y = xy * sinf(sectorAngle);             // r * cos(u) * sin(v)
+			sphere.vertices.push_back(x);
+			sphere.vertices.push_back(y);
+			sphere.vertices.push_back(z);
+		}
+	}
+
+	// Generate indices
+	int k1, k2;
+	for (int i = 0; i < latitudeCount; ++i)
+	{
+		k1 = i * (longitudeCount + 1);     // beginning of current stack
+		k2 = k1 + longitudeCount + 1;      // beginning of next stack
+
+		for (int j = 0; j < longitudeCount; ++j, ++k1, ++k2)
+		{
+			// 2 triangles per sector excluding first and last stacks
+			// k1 => k2 => k1+1
+			if (i != 0)
+			{
+				sphere.indices.push_back(k1);
+				sphere.indices.push_back(k2);
+				sphere.indices.push_back(k1 + 1);
+			}
+
+			// k1+1 => k2 => k2+1
+			if (i != (latitudeCount - 1))
+			{
+				sphere.indices.push_back(k1 + 1);
+				sphere.indices.push_back(k2);
+				sphere.indices.push_back(k2 + 1);
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////
+
+	return sphere;
+}
+
+MeshData MeshData::Cylinder(int sectorCount, float height, float radius)
+{
+	MeshData cylinder;
+
+	///////////////////////////////////////////////////////////
+	// Source: http://www.songho.ca/opengl/gl_cylinder.html. //
+
+	// get unit circle vectors on XY-plane
+	std::vector<float> unitVertices;
+	float sectorStep = 2 * glm::pi<float>() / sectorCount;
+	for (int i = 0; i <= sectorCount; ++i)
+	{
+		float sectorAngle = i * sectorStep;
+		unitVertices.push_back(cos(sectorAngle)); // x
+		unitVertices.push_back(sin(sectorAngle)); // y
+		unitVertices.push_back(0);                // z
+	}
+	radius = radius / 2;
+
+	// put side vertices to arrays
+	for (int i = 0; i < 2; ++i)
+	{
+		float h = -height / 2.0f + i * height;           // z value; -h/2 to h/2
+
+		for (int j = 0, k = 0; j <= sectorCount; ++j, k += 3)
+		{
+			cylinder.vertices.push_back(unitVertices[k] * radius);     // vx
+			cylinder.vertices.push_back(unitVertices[k + 1] * radius); // vy
+			cylinder.vertices.push_back(h);                            // vz
+		}
+	}
+
+	// the starting index for the base/top surface
+	int baseCenterIndex = (int)cylinder.vertices.size() / 3;
+	int topCenterIndex = baseCenterIndex + sectorCount + 1; // include center vertex
+
+	// put base and top vertices to arrays
+	for (int i = 0; i < 2; ++i)
+	{
+		float h = -height / 2.0f + i * height;           // z value; -h/2 to h/2
+
+		// center point
+		cylinder.vertices.push_back(0);     cylinder.vertices.push_back(0);     cylinder.vertices.push_back(h);
+
+		for (int j = 0, k = 0; j < sectorCount; ++j, k += 3)
+		{
+			cylinder.vertices.push_back(unitVertices[k] * radius);     // vx
+			cylinder.vertices.push_back(unitVertices[k + 1] * radius); // vy
+			cylinder.vertices.push_back(h);                            // vz
+		}
+	}
+
+	// generate CCW index list of cylinder triangles
+	int k1 = 0;                         // 1st vertex index at base
+	int k2 = sectorCount + 1;           // 1st vertex index at top
+
+	// indices for the side surface
+	for (int i = 0; i < sectorCount; ++i, ++k1, ++k2)
+	{
+		// 2 triangles per sector
+		// k1 => k1+1 => k2
+		cylinder.indices.push_back(k1);
+		cylinder.indices.push_back(k1 + 1);
+		cylinder.indices.push_back(k2);
+
+		// k2 => k1+1 => k2+1
+		cylinder.indices.push_back(k2);
+		cylinder.indices.push_back(k1 + 1);
+		cylinder.indices.push_back(k2 + 1);
+	}
+
+	// indices for the base surface
+	for (int i = 0, k = baseCenterIndex + 1; i < sectorCount; ++i, ++k)
+	{
+		if (i < sectorCount - 1)
+		{
+			cylinder.indices.push_back(baseCenterIndex);
+			cylinder.indices.push_back(k + 1);
+			cylinder.indices.push_back(k);
+		}
+		else // last triangle
+		{
+			cylinder.indices.push_back(baseCenterIndex);
+			cylinder.indices.push_back(baseCenterIndex + 1);
+			cylinder.indices.push_back(k);
+		}
+	}
+
+	// indices for the top surface
+	for (int i = 0, k = topCenterIndex + 1; i < sectorCount; ++i, ++k)
+	{
+		if (i < sectorCount - 1)
+		{
+			cylinder.indices.push_back(topCenterIndex);
+			cylinder.indices.push_back(k);
+			cylinder.indices.push_back(k + 1);
+		}
+		else // last triangle
+		{
+			cylinder.indices.push_back(topCenterIndex);
+			cylinder.indices.push_back(k);
+			cylinder.indices.push_back(topCenterIndex + 1);
+		}
+	}
+
+	///////////////////////////////////////////////////////////
+
+	return cylinder;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+
+/// <summary>
+/// CPU-side copy of a mesh's geometry: tightly packed XYZ positions and triangle indices.
+/// This is what the generators produce before it is handed to Mesh::CreateMesh, and what
+/// the baking steps (CSG union, string baking, ...) operate on.
+/// </summary>
+class MeshData
+{
+	public:
+		MeshData();
+		~MeshData();
+
+		/// <summary>
+		/// Vertex positions, 3 floats (X,Y,Z) per vertex.
+		/// </summary>
+		std::vector<GLfloat> vertices;
+		/// <summary>
+		/// Triangle indices, 3 per triangle.
+		/// </summary>
+		std::vector<unsigned int> indices;
+
+		/// <summary>
+		/// Returns the number of vertices in the mesh.
+		/// </summary>
+		unsigned int VertexCount() const;
+		/// <summary>
+		/// Returns the number of triangles in the mesh.
+		/// </summary>
+		unsigned int TriangleCount() const;
+
+		/// <summary>
+		/// Returns the position of a vertex.
+		/// </summary>
+		/// <param name="index">Index of the vertex.</param>
+		glm::vec3 GetVertex(unsigned int index) const;
+
+		/// <summary>
+		/// Appends another mesh to this one, transforming its vertices with the given matrix.
+		/// </summary>
+		/// <param name="other">The mesh to append.</param>
+		/// <param name="transform">The matrix to apply to the appended vertices.</param>
+		void Append(const MeshData& other, const glm::mat4& transform);
+
+		/// <summary>
+		/// Merges vertices that lie closer than epsilon to each other and drops the triangles that become degenerate.
+		/// </summary>
+		/// <param name="epsilon">Distance under which two vertices are considered the same.</param>
+		void Weld(float epsilon);
+
+		/// <summary>
+		/// Empties the mesh.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Generates a cube going from -1 to 1 on every axis.
+		/// </summary>
+		static MeshData Cube();
+
+		/// <summary>
+		/// Generates a UV sphere centered on the origin.
+		/// </summary>
+		/// <param name="radius">Radius of the sphere.</param>
+		/// <param name="longitudeCount">Amount of sectors around the sphere.</param>
+		/// <param name="latitudeCount">Amount of stacks from pole to pole.</param>
+		static MeshData Sphere(float radius, int longitudeCount, int latitudeCount);
+
+		/// <summary>
+		/// Generates a closed cylinder centered on the origin, aligned with the Z axis.
+		/// </summary>
+		/// <param name="sectorCount">Amount of sectors around the cylinder.</param>
+		/// <param name="height">Height of the cylinder.</param>
+		/// <param name="radius">Diameter of the cylinder (kept as "radius" to match CreateCylinder).</param>
+		static MeshData Cylinder(int sectorCount, float height, float radius);
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Pool of objects of a single type, allocated by chunks of CHUNK_SIZE slots.
+/// Objects never move once created, so pointers to them stay valid until they are destroyed. Release destroys every
+/// object at once and keeps the chunks, so building the next scene of a similar size allocates nothing, and lays the
+/// free slots back in address order, so objects created one after the other sit next to each other in memory.
+/// </summary>
+template <typename T, size_t CHUNK_SIZE = 256>
+class ObjectPool
+{
+	public:
+		ObjectPool()
+		{
+			freeList = NULL;
+			liveCount = 0;
+		}
+
+		~ObjectPool()
+		{
+			Release();
+			for (int i = 0; i < chunks.size(); i++)
+			{
+				delete[] chunks[i];
+			}
+		}
+
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		/// <summary>
+		/// Creates an object in a free slot, adding a chunk if there is none.
+		/// </summary>
+		/// <param name="args">The arguments of the constructor of T.</param>
+		template <typename... Args>
+		T* Create(Args&&... args)
+		{
+			if (freeList == NULL)
+				AddChunk();
+
+			Slot* slot = freeList;
+			T* object = new (slot->storage) T(std::forward<Args>(args)...);
+			freeList = slot->next;
+			slot->live = true;
+			liveCount++;
+			return object;
+		}
+
+		/// <summary>
+		/// Destroys an object created by this pool, its slot is reused by the next Create.
+		/// </summary>
+		void Destroy(T* object)
+		{
+			if (object == NULL)
+				return;
+
+			// The storage is the first member of its slot.
+			Slot* slot = reinterpret_cast<Slot*>(object);
+			object->~T();
+			slot->live = false;
+			slot->next = freeList;
+			freeList = slot;
+			liveCount--;
+		}
+
+		/// <summary>
+		/// Destroys every object of the pool. The chunks are kept for the next objects.
+		/// </summary>
+		void Release()
+		{
+			freeList = NULL;
+			for (int i = (int)chunks.size() - 1; i >= 0; i--)
+			{
+				for (int j = CHUNK_SIZE - 1; j >= 0; j--)
+				{
+					Slot& slot = chunks[i][j];
+					if (slot.live)
+					{
+						reinterpret_cast<T*>(slot.storage)->~T();
+						slot.live = false;
+					}
+					slot.next = freeList;
+					freeList = &slot;
+				}
+			}
+			liveCount = 0;
+		}
+
+		/// <summary>
+		/// Returns the number of objects alive in the pool.
+		/// </summary>
+		size_t Size() const { return liveCount; }
+
+		/// <summary>
+		/// Returns the number of objects the pool holds without allocating.
+		/// </summary>
+		size_t Capacity() const { return chunks.size() * CHUNK_SIZE; }
+
+	private:
+		struct Slot
+		{
+			alignas(T) unsigned char storage[sizeof(T)];
+			Slot* next; // Next free slot, only meaningful while the slot is free
+			bool live;
+		};
+
+		void AddChunk()
+		{
+			Slot* chunk = new Slot[CHUNK_SIZE];
+			for (int i = CHUNK_SIZE - 1; i >= 0; i--)
+			{
+				chunk[i].live = false;
+				chunk[i].next = freeList;
+				freeList = &chunk[i];
+			}
+			chunks.push_back(chunk);
+		}
+
+		std::vector<Slot*> chunks;
+		Slot* freeList;
+		size_t liveCount;
+};
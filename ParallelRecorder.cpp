@@ -0,0 +1,176 @@
+#include "ParallelRecorder.h"
+#include <cstdio>
+
+ParallelRecorder::ParallelRecorder() : nextBuffer(0), buffersLeft(0)
+{
+	record = NULL;
+	context = NULL;
+	drawCount = 0;
+	bufferCount = 0;
+	generation = 0;
+	busyWorkers = 0;
+	stopping = false;
+
+	workerCount = 0;
+	frames = 0;
+	commands = 0;
+	recordedBuffers = 0;
+	recordMilliseconds = 0.0;
+	replayMilliseconds = 0.0;
+}
+
+ParallelRecorder::~ParallelRecorder()
+{
+	Stop();
+}
+
+void ParallelRecorder::Start(int workerCount, size_t bufferBytes)
+{
+	if (!workers.empty())
+		return;
+
+	if (workerCount <= 0)
+	{
+		int cores = (int)std::thread::hardware_concurrency();
+		workerCount = cores > 3 ? cores - 2 : 1;
+	}
+	workerCount = workerCount > MAX_BUFFERS ? MAX_BUFFERS : workerCount;
+
+	for (int i = 0; i < MAX_BUFFERS; i++)
+		buffers[i].Reserve(bufferBytes);
+
+	stopping = false;
+	this->workerCount = workerCount;
+	for (int i = 0; i < workerCount; i++)
+		workers.push_back(std::thread(&ParallelRecorder::Run, this));
+}
+
+void ParallelRecorder::Stop()
+{
+	if (workers.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+	for (int i = 0; i < workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+}
+
+void ParallelRecorder::Record(int drawCount, RecordFunction record, void* context)
+{
+	recordStart = std::chrono::steady_clock::now();
+
+	// One range per worker at most, and none shorter than MIN_DRAWS_PER_BUFFER.
+	int count = drawCount / MIN_DRAWS_PER_BUFFER;
+	count = count > (int)workers.size() ? (int)workers.size() : count;
+	count = count < 1 ? 1 : count;
+
+	{
+		// No worker is recording by now (see Replay), and none starts before the frame is set.
+		std::unique_lock<std::mutex> lock(mutex);
+		while (busyWorkers > 0)
+			finished.wait(lock);
+		this->record = record;
+		this->context = context;
+		this->drawCount = drawCount;
+		bufferCount = count;
+		buffersLeft.store(bufferCount);
+		nextBuffer.store(0);
+		if (bufferCount > 1)
+			generation++;
+	}
+
+	if (bufferCount == 1)
+		RecordRanges();
+	else
+		started.notify_all();
+}
+
+void ParallelRecorder::RecordRanges()
+{
+	while (true)
+	{
+		int buffer = nextBuffer.fetch_add(1);
+		if (buffer >= bufferCount)
+			return;
+
+		// Consecutive ranges, the buffers replayed in order draw in the order of the snapshot.
+		int first = (int)((long long)drawCount * buffer / bufferCount);
+		int end = (int)((long long)drawCount * (buffer + 1) / bufferCount);
+		buffers[buffer].Clear();
+		record(context, first, end - first, buffers[buffer]);
+
+		if (buffersLeft.fetch_sub(1) == 1)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			recordEnd = std::chrono::steady_clock::now();
+			finished.notify_all();
+		}
+	}
+}
+
+void ParallelRecorder::Run()
+{
+	unsigned int recorded = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (generation == recorded && !stopping)
+				started.wait(lock);
+			if (stopping)
+				return;
+			recorded = generation;
+
+			// Woken too late, the frame was recorded without this worker.
+			if (buffersLeft.load() == 0)
+				continue;
+			busyWorkers++;
+		}
+
+		RecordRanges();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		busyWorkers--;
+		finished.notify_all();
+	}
+}
+
+void ParallelRecorder::Replay()
+{
+	if (bufferCount == 0)
+		return;
+
+	// Helping with what is left rather than waiting for a worker to wake up.
+	RecordRanges();
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (buffersLeft.load() > 0 || busyWorkers > 0)
+			finished.wait(lock);
+	}
+	recordMilliseconds += std::chrono::duration<double, std::milli>(recordEnd - recordStart).count();
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < bufferCount; i++)
+	{
+		buffers[i].Replay();
+		commands += buffers[i].GetCommandCount();
+	}
+	replayMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	recordedBuffers += bufferCount;
+	frames++;
+	bufferCount = 0;
+}
+
+void ParallelRecorder::PrintStatistics()
+{
+	if (frames == 0)
+		return;
+	printf("Command buffers: %d workers, %.1f buffers and %.0f commands a frame, recorded in %.3f ms and replayed in %.3f ms on average\n",
+		workerCount, (double)recordedBuffers / frames, (double)commands / frames, recordMilliseconds / frames, replayMilliseconds / frames);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CommandBuffer.h"
+
+/// <summary>
+/// Records the draws of a frame into command buffers on worker threads, then replays them in order on the GL thread.
+/// The draws are split into consecutive ranges, one per buffer, and each worker takes the next range left until there
+/// is none. The GL thread is free while they record, it only waits for them in Replay. Recording scales with the
+/// cores, submitting stays on one thread as GL requires.
+/// Ranges are at least MIN_DRAWS_PER_BUFFER draws: a frame with fewer draws than that is recorded on the calling
+/// thread at once, waking workers would cost more than it saves.
+/// </summary>
+class ParallelRecorder
+{
+	public:
+		/// <summary>
+		/// Records the draws first to first + count - 1 into a buffer. Called on the workers, it must not use GL.
+		/// </summary>
+		typedef void (*RecordFunction)(void* context, int first, int count, CommandBuffer& commands);
+
+		ParallelRecorder();
+		~ParallelRecorder();
+
+		/// <summary>
+		/// Starts the workers.
+		/// </summary>
+		/// <param name="workerCount">The threads recording, 0 for one per core left after the main and render threads.</param>
+		/// <param name="bufferBytes">The bytes each buffer holds without allocating.</param>
+		void Start(int workerCount, size_t bufferBytes);
+
+		/// <summary>
+		/// Stops the workers, after the recording under way.
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Starts recording the draws of a frame, without waiting.
+		/// </summary>
+		/// <param name="drawCount">The draws to split between the buffers.</param>
+		/// <param name="record">Records a range of draws.</param>
+		/// <param name="context">Given to record.</param>
+		void Record(int drawCount, RecordFunction record, void* context);
+
+		/// <summary>
+		/// Records the ranges no worker took yet and waits for the others, then replays the buffers in the order of
+		/// their draws. GL thread only.
+		/// </summary>
+		void Replay();
+
+		/// <summary>
+		/// Prints the frames, the buffers and commands recorded, and how long recording and replaying took.
+		/// </summary>
+		void PrintStatistics();
+
+		static const int MAX_BUFFERS = 16;
+		static const int MIN_DRAWS_PER_BUFFER = 64;
+
+	private:
+		/// <summary>
+		/// Records ranges while there are any, for every frame, until Stop.
+		/// </summary>
+		void Run();
+
+		/// <summary>
+		/// Records the ranges left, on a worker or on the calling thread.
+		/// </summary>
+		void RecordRanges();
+
+		// Parallel recorders cannot be copied, the copy would share the threads.
+		ParallelRecorder(const ParallelRecorder&);
+		ParallelRecorder& operator=(const ParallelRecorder&);
+
+		std::vector<std::thread> workers;
+		CommandBuffer buffers[MAX_BUFFERS];
+
+		// Recording of the frame
+		RecordFunction record;
+		void* context;
+		int drawCount;
+		int bufferCount;
+		std::atomic<int> nextBuffer; // Next range to take
+		std::atomic<int> buffersLeft; // Ranges not recorded yet
+
+		// Guarded by mutex
+		std::mutex mutex;
+		std::condition_variable started, finished;
+		unsigned int generation; // Counts the recordings, a worker records when it changes
+		int busyWorkers; // Workers inside RecordRanges, the next recording only starts once they are out
+		bool stopping;
+		std::chrono::steady_clock::time_point recordEnd; // When the last range was recorded
+
+		// Statistics
+		int workerCount, frames, commands, recordedBuffers;
+		double recordMilliseconds, replayMilliseconds;
+		std::chrono::steady_clock::time_point recordStart;
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Unit primitive geometry computed by the compiler.								//
+// The tables are built by constexpr constructors and stored as static constants, //
+// so they end up in the read-only data of the executable and cost nothing at		//
+// startup. Same layout as the runtime generators in MeshData, from songho.ca.		//
+// Big tables can go past MSVC's default constexpr budget: raise /constexpr:steps.	//
+//////////////////////////////////////////////////////////////////////////////////////
+
+namespace PrimitiveTables
+{
+	constexpr double PI = 3.14159265358979323846;
+
+	/// <summary>
+	/// Sine usable in constant expressions: Taylor series once the angle is brought back to [-pi, pi].
+	/// </summary>
+	constexpr double Sin(double x)
+	{
+		while (x > PI) x -= 2.0 * PI;
+		while (x < -PI) x += 2.0 * PI;
+
+		double term = x;
+		double sum = x;
+		for (int n = 1; n < 12; n++)
+		{
+			term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+			sum += term;
+		}
+		return sum;
+	}
+
+	/// <summary>
+	/// Cosine usable in constant expressions.
+	/// </summary>
+	constexpr double Cos(double x)
+	{
+		return Sin(x + PI / 2.0);
+	}
+
+	/// <summary>
+	/// UV sphere of radius 1, Lon sectors around and Lat stacks from pole to pole.
+	/// </summary>
+	template<int Lon, int Lat>
+	struct SphereTable
+	{
+		static constexpr int VERTEX_COUNT = (Lat + 1) * (Lon + 1);
+		// One triangle per sector on the first and last stacks, two on the others.
+		static constexpr int INDEX_COUNT = Lon * (Lat - 1) * 6;
+
+		float vertices[VERTEX_COUNT * 3];
+		unsigned int indices[INDEX_COUNT];
+
+		constexpr SphereTable() : vertices(), indices()
+		{
+			int v = 0;
+			for (int i = 0; i <= Lat; ++i)
+			{
+				double stackAngle = PI / 2.0 - i * PI / Lat; // starting from pi/2 to -pi/2
+				double xy = Cos(stackAngle);
+				double z = Sin(stackAngle);
+
+				for (int j = 0; j <= Lon; ++j)
+				{
+					double sectorAngle = j * 2.0 * PI / Lon; // starting from 0 to 2pi
+					vertices[v++] = (float)(xy * Cos(sectorAngle));
+					vertices[v++] = (float)(xy * Sin(sectorAngle));
+					vertices[v++] = (float)z;
+				}
+			}
+
+			int n = 0;
+			for (int i = 0; i < Lat; ++i)
+			{
+				unsigned int k1 = i * (Lon + 1); // beginning of current stack
+				unsigned int k2 = k1 + Lon + 1;  // beginning of next stack
+
+				for (int j = 0; j < Lon; ++j, ++k1, ++k2)
+				{
+					if (i != 0)
+					{
+						indices[n++] = k1;
+						indices[n++] = k2;
+						indices[n++] = k1 + 1;
+					}
+					if (i != Lat - 1)
+					{
+						indices[n++] = k1 + 1;
+						indices[n++] = k2;
+						indices[n++] = k2 + 1;
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// Returns the table, evaluated at compile time.
+		/// </summary>
+		static const SphereTable& Get()
+		{
+			static constexpr SphereTable table;
+			return table;
+		}
+	};
+
+	/// <summary>
+	/// Closed cylinder of diameter 1 and height 1 along Z, with Sectors sectors around.
+	/// </summary>
+	template<int Sectors>
+	struct CylinderTable
+	{
+		// Two side rings (the seam vertex repeated), then the two caps with their centers.
+		static constexpr int VERTEX_COUNT = 2 * (Sectors + 1) + 2 * (Sectors + 1);
+		static constexpr int INDEX_COUNT = Sectors * 6 + Sectors * 6;
+
+		float vertices[VERTEX_COUNT * 3];
+		unsigned int indices[INDEX_COUNT];
+
+		constexpr CylinderTable() : vertices(), indices()
+		{
+			int v = 0;
+			for (int i = 0; i < 2; ++i)
+			{
+				float h = -0.5f + i; // z value; -h/2 to h/2
+				for (int j = 0; j <= Sectors; ++j)
+				{
+					double sectorAngle = j * 2.0 * PI / Sectors;
+					vertices[v++] = (float)(Cos(sectorAngle) * 0.5);
+					vertices[v++] = (float)(Sin(sectorAngle) * 0.5);
+					vertices[v++] = h;
+				}
+			}
+
+			unsigned int baseCenterIndex = 2 * (Sectors + 1);
+			unsigned int topCenterIndex = baseCenterIndex + Sectors + 1;
+
+			for (int i = 0; i < 2; ++i)
+			{
+				float h = -0.5f + i;
+				vertices[v++] = 0.0f;
+				vertices[v++] = 0.0f;
+				vertices[v++] = h;
+				for (int j = 0; j < Sectors; ++j)
+				{
+					double sectorAngle = j * 2.0 * PI / Sectors;
+					vertices[v++] = (float)(Cos(sectorAngle) * 0.5);
+					vertices[v++] = (float)(Sin(sectorAngle) * 0.5);
+					vertices[v++] = h;
+				}
+			}
+
+			int n = 0;
+			unsigned int k1 = 0;           // 1st vertex index at base
+			unsigned int k2 = Sectors + 1; // 1st vertex index at top
+			for (int i = 0; i < Sectors; ++i, ++k1, ++k2)
+			{
+				indices[n++] = k1;
+				indices[n++] = k1 + 1;
+				indices[n++] = k2;
+
+				indices[n++] = k2;
+				indices[n++] = k1 + 1;
+				indices[n++] = k2 + 1;
+			}
+
+			for (unsigned int i = 0, k = baseCenterIndex + 1; i < Sectors; ++i, ++k)
+			{
+				indices[n++] = baseCenterIndex;
+				indices[n++] = (i < Sectors - 1) ? k + 1 : baseCenterIndex + 1;
+				indices[n++] = k;
+			}
+
+			for (unsigned int i = 0, k = topCenterIndex + 1; i < Sectors; ++i, ++k)
+			{
+				indices[n++] = topCenterIndex;
+				indices[n++] = k;
+				indices[n++] = (i < Sectors - 1) ? k + 1 : topCenterIndex + 1;
+			}
+		}
+
+		/// <summary>
+		/// Returns the table, evaluated at compile time.
+		/// </summary>
+		static const CylinderTable& Get()
+		{
+			static constexpr CylinderTable table;
+			return table;
+		}
+	};
+}
@@ -0,0 +1,44 @@
+#include "Primitives.h"
+#include "PrimitiveTables.h"
+
+PrimitiveLibrary::PrimitiveLibrary()
+{
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		meshes[i] = NULL;
+	}
+}
+
+PrimitiveLibrary::~PrimitiveLibrary()
+{
+	Clear();
+}
+
+void PrimitiveLibrary::Load()
+{
+	if (meshes[PRIMITIVE_CUBE] != NULL)
+		return;
+
+	meshes[PRIMITIVE_CUBE] = new Mesh();
+	meshes[PRIMITIVE_CUBE]->CreateMesh(new MeshData(MeshData::Cube()));
+
+	meshes[PRIMITIVE_SPHERE] = new Mesh();
+	meshes[PRIMITIVE_SPHERE]->CreateStaticMesh(PrimitiveTables::SphereTable<SPHERE_LONGITUDE_COUNT, SPHERE_LATITUDE_COUNT>::Get());
+
+	meshes[PRIMITIVE_CYLINDER] = new Mesh();
+	meshes[PRIMITIVE_CYLINDER]->CreateStaticMesh(PrimitiveTables::CylinderTable<CYLINDER_SECTOR_COUNT>::Get());
+}
+
+Mesh* PrimitiveLibrary::GetMesh(PrimitiveType type)
+{
+	return meshes[type];
+}
+
+void PrimitiveLibrary::Clear()
+{
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		delete meshes[i];
+		meshes[i] = NULL;
+	}
+}
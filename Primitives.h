@@ -0,0 +1,54 @@
+#pragma once
+#include "Mesh.h"
+
+/// <summary>
+/// The basic shapes everything in the scene is built from.
+/// </summary>
+enum PrimitiveType
+{
+	PRIMITIVE_CUBE = 0,
+	PRIMITIVE_SPHERE,
+	PRIMITIVE_CYLINDER,
+	PRIMITIVE_COUNT
+};
+
+/// <summary>
+/// Holds a single GPU mesh per primitive type, created once and shared by every object using that primitive.
+/// The primitives are unit sized: a cube going from -1 to 1, a sphere of radius 1 and a cylinder of diameter 1 and height 1.
+/// Their final size comes from the model matrix of whoever draws them.
+/// </summary>
+class PrimitiveLibrary
+{
+	public:
+		PrimitiveLibrary();
+		~PrimitiveLibrary();
+
+		/// <summary>
+		/// Creates the primitive meshes on the GPU. Does nothing if they are already loaded.
+		/// </summary>
+		void Load();
+
+		/// <summary>
+		/// Returns the shared mesh of a primitive. Load must have been called.
+		/// </summary>
+		/// <param name="type">The primitive wanted.</param>
+		Mesh* GetMesh(PrimitiveType type);
+
+		/// <summary>
+		/// Clears the primitive meshes from the GPU.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Tessellation used for the sphere primitive, the same as the one the letters always used.
+		/// </summary>
+		static const int SPHERE_LONGITUDE_COUNT = 40;
+		static const int SPHERE_LATITUDE_COUNT = 40;
+		/// <summary>
+		/// Tessellation used for the cylinder primitive, the same as the one the axes always used.
+		/// </summary>
+		static const int CYLINDER_SECTOR_COUNT = 12;
+
+	private:
+		Mesh* meshes[PRIMITIVE_COUNT];
+};
@@ -0,0 +1,44 @@
+#include "Redraw.h"
+#include <GLFW/glfw3.h>
+
+std::atomic<bool> Redraw::requested(true); // The first frame is always drawn
+std::atomic<int> Redraw::animations(0);
+std::atomic<bool> Redraw::waiting(false);
+
+void Redraw::Request()
+{
+	// Only the first request wakes the loop, the next ones are free.
+	if (!requested.exchange(true) && waiting.load())
+		glfwPostEmptyEvent();
+}
+
+void Redraw::BeginAnimation()
+{
+	if (animations.fetch_add(1) == 0 && waiting.load())
+		glfwPostEmptyEvent();
+}
+
+void Redraw::EndAnimation()
+{
+	// A last frame shows where the animation stopped.
+	if (animations.fetch_sub(1) == 1)
+		Request();
+}
+
+bool Redraw::IsNeeded()
+{
+	return requested.load() || animations.load() > 0;
+}
+
+void Redraw::Clear()
+{
+	requested.store(false);
+}
+
+void Redraw::Wait(double timeout)
+{
+	waiting.store(true);
+	if (!IsNeeded())
+		glfwWaitEventsTimeout(timeout);
+	waiting.store(false);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+
+/// <summary>
+/// Whether the window must be drawn again, for drawing on demand: the frame loop sleeps until something asks for a
+/// frame. Input and scene edits (model matrices, colours, textures, camera moves) request one frame. Animations
+/// request every frame for as long as they run, held keys being one.
+/// Requests can come from any thread, a request made while the loop sleeps wakes it up.
+/// </summary>
+class Redraw
+{
+	public:
+		/// <summary>
+		/// Asks for the next frame to be drawn.
+		/// </summary>
+		static void Request();
+
+		/// <summary>
+		/// Asks for every frame to be drawn until the matching EndAnimation.
+		/// </summary>
+		static void BeginAnimation();
+
+		/// <summary>
+		/// Ends an animation started with BeginAnimation.
+		/// </summary>
+		static void EndAnimation();
+
+		/// <summary>
+		/// Returns true if a frame must be drawn.
+		/// </summary>
+		static bool IsNeeded();
+
+		/// <summary>
+		/// Forgets the requests, called when a frame starts. Requests made while drawing it are for the next one.
+		/// </summary>
+		static void Clear();
+
+		/// <summary>
+		/// Sleeps until a frame must be drawn, or the timeout is over.
+		/// </summary>
+		/// <param name="timeout">In seconds.</param>
+		static void Wait(double timeout);
+
+	private:
+		static std::atomic<bool> requested;
+		static std::atomic<int> animations;
+		static std::atomic<bool> waiting; // True while Wait sleeps, the only time requests need to wake anything
+};
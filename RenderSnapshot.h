@@ -0,0 +1,107 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstring>
+#include "FrameAllocator.h"
+
+class Mesh;
+class Shader;
+class ComplexObject;
+
+/// <summary>
+/// One draw recorded by the main thread, with the state it changes every frame copied.
+/// </summary>
+struct RenderDraw
+{
+	Mesh* mesh;
+	Shader* shader;
+	ComplexObject* textured; // Object whose texture or texture array layer is bound for the draw, NULL if none
+	glm::mat4 model;
+	glm::vec3 colour;
+	GLenum drawType;
+};
+
+/// <summary>
+/// Everything the render thread needs to draw a frame, built by the main thread and not changed once published
+/// (see RenderThread). The meshes, shaders and textures are only pointed to: they are created before the render
+/// thread starts and live until it stops. The transforms and colours, which the main thread edits, are copies.
+/// The draws are in the frame memory of the snapshot, released when the main thread builds into it again.
+/// </summary>
+struct RenderSnapshot
+{
+	RenderDraw* draws; // In drawing order
+	size_t drawCount;
+	glm::mat4 view; // Camera when the snapshot was built, the render thread latches a newer one if there is
+	GLenum polygonMode;
+
+	RenderSnapshot() : memory(16 * sizeof(RenderDraw))
+	{
+		draws = NULL;
+		drawCount = 0;
+		drawCapacity = 0;
+		expectedDraws = 16;
+	}
+
+	/// <summary>
+	/// Starts building the snapshot again on the calling thread, releasing the draws of the last frame built into it.
+	/// The render thread must be done with them (see RenderThread::BeginSnapshot).
+	/// </summary>
+	void BeginFrame()
+	{
+		Clear();
+		memory.BeginFrame();
+	}
+
+	/// <summary>
+	/// Ends building the snapshot, checking in debug builds that the frame did not allocate (see FrameAllocator).
+	/// </summary>
+	void EndFrame()
+	{
+		memory.EndFrame();
+	}
+
+	/// <summary>
+	/// Makes room for a number of draws, so the first frames do not have to grow the memory of the snapshot.
+	/// </summary>
+	void Reserve(size_t count)
+	{
+		expectedDraws = count > expectedDraws ? count : expectedDraws;
+		memory.Reserve(expectedDraws * sizeof(RenderDraw));
+	}
+
+	/// <summary>
+	/// Empties the snapshot. The memory of the draws is only released by the next BeginFrame.
+	/// </summary>
+	void Clear()
+	{
+		expectedDraws = drawCount > expectedDraws ? drawCount : expectedDraws;
+		draws = NULL;
+		drawCount = 0;
+		drawCapacity = 0;
+	}
+
+	/// <summary>
+	/// Records a draw.
+	/// </summary>
+	void AddDraw(Mesh* mesh, Shader* shader, ComplexObject* textured, const glm::mat4& model, glm::vec3 colour, GLenum drawType = GL_TRIANGLES)
+	{
+		if (drawCount == drawCapacity)
+		{
+			// Moved to an array twice as big, the old one is released with the rest of the frame.
+			size_t capacity = drawCapacity > 0 ? drawCapacity * 2 : expectedDraws;
+			RenderDraw* moved = memory.AllocateArray<RenderDraw>(capacity);
+			if (drawCount > 0)
+				memcpy(moved, draws, drawCount * sizeof(RenderDraw));
+			draws = moved;
+			drawCapacity = capacity;
+		}
+
+		RenderDraw draw = { mesh, shader, textured, model, colour, drawType };
+		draws[drawCount++] = draw;
+	}
+
+	private:
+		FrameAllocator memory;
+		size_t drawCapacity;
+		size_t expectedDraws; // Most draws a frame of this snapshot had, the size of its first array
+};
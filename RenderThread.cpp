@@ -0,0 +1,138 @@
+#include "RenderThread.h"
+#include <chrono>
+#include <cstdio>
+
+RenderThread::RenderThread()
+{
+	window = NULL;
+	running = false;
+	writing = 0;
+	published = -1;
+	drawing = -1;
+	stopping = false;
+	cameraView = glm::mat4(1.0f);
+	cameraInputTime = -1.0;
+	hasCamera = false;
+
+	frames = 0;
+	publishWaitMilliseconds = 0.0;
+	idleMilliseconds = 0.0;
+}
+
+RenderThread::~RenderThread()
+{
+	Stop();
+}
+
+void RenderThread::Start(Window* window, RenderFunction render, size_t drawCapacity)
+{
+	if (running)
+		return;
+
+	this->window = window;
+	this->render = render;
+	for (int i = 0; i < SNAPSHOT_COUNT; i++)
+		snapshots[i].Reserve(drawCapacity);
+	writing = 0;
+	published = -1;
+	drawing = -1;
+	stopping = false;
+
+	// A context is current on one thread at most.
+	window->setContextCurrent(false);
+	thread = std::thread(&RenderThread::Run, this);
+	running = true;
+}
+
+void RenderThread::Stop()
+{
+	if (!running)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	changed.notify_all();
+	thread.join();
+	running = false;
+	window->setContextCurrent(true);
+}
+
+void RenderThread::Publish()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (published >= 0)
+	{
+		auto start = std::chrono::steady_clock::now();
+		while (published >= 0 && !stopping)
+			changed.wait(lock);
+		publishWaitMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// The next snapshot is built in the one neither published nor drawn.
+	published = writing;
+	for (int i = 0; i < SNAPSHOT_COUNT; i++)
+	{
+		if (i != published && i != drawing)
+		{
+			writing = i;
+			break;
+		}
+	}
+	lock.unlock();
+	changed.notify_all();
+}
+
+void RenderThread::PublishCamera(const glm::mat4& view, double inputTime)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	cameraView = view;
+	if (inputTime >= 0.0)
+		cameraInputTime = inputTime;
+	hasCamera = true;
+}
+
+void RenderThread::GetCamera(glm::mat4& view, double& inputTime)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!hasCamera)
+		return;
+	view = cameraView;
+	inputTime = cameraInputTime;
+	cameraInputTime = -1.0;
+}
+
+void RenderThread::Run()
+{
+	window->setContextCurrent(true);
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			auto start = std::chrono::steady_clock::now();
+			while (published < 0 && !stopping)
+				changed.wait(lock);
+			idleMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (stopping)
+				break;
+			drawing = published;
+			published = -1;
+		}
+		changed.notify_all();
+
+		// The main thread builds into another snapshot meanwhile, this one is only read.
+		render(snapshots[drawing]);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		drawing = -1;
+		frames++;
+	}
+	window->setContextCurrent(false);
+}
+
+void RenderThread::PrintStatistics()
+{
+	printf("Render thread: %d frames, the main thread waited %.1f ms for it, it waited %.1f ms for snapshots\n",
+		frames, publishWaitMilliseconds, idleMilliseconds);
+}
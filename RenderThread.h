@@ -0,0 +1,105 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "RenderSnapshot.h"
+#include "Window.h"
+
+/// <summary>
+/// Thread owning the GL context and drawing the snapshots the main thread publishes, so updating a frame and drawing
+/// the one before happen at the same time: a frame then costs the longer of the two rather than their sum.
+/// There are SNAPSHOT_COUNT snapshots: one being drawn, one published and not taken yet, and one being built. Publish
+/// waits while the last one published has not been taken, so the main thread never gets more than a frame ahead and
+/// never builds a snapshot nobody draws.
+/// The camera is published apart, as soon as the input is read, and the render thread takes the latest one just
+/// before drawing: a snapshot built from older input is still drawn from the newest camera.
+/// </summary>
+class RenderThread
+{
+	public:
+		/// <summary>
+		/// Draws a snapshot on the render thread.
+		/// </summary>
+		typedef std::function<void(const RenderSnapshot& snapshot)> RenderFunction;
+
+		RenderThread();
+		~RenderThread();
+
+		/// <summary>
+		/// Hands the GL context of the window over to a new render thread. Everything the snapshots point to must be
+		/// created by then.
+		/// </summary>
+		/// <param name="render">Draws a snapshot and swaps the buffers.</param>
+		/// <param name="drawCapacity">The draws a snapshot holds without allocating.</param>
+		void Start(Window* window, RenderFunction render, size_t drawCapacity);
+
+		/// <summary>
+		/// Waits for the frame being drawn, stops the thread and makes the GL context current on the calling thread.
+		/// The snapshot published and not taken yet is dropped.
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Returns the snapshot to build next, which the render thread does not read anymore, so the main thread can
+		/// release its draws with RenderSnapshot::BeginFrame. Main thread only.
+		/// </summary>
+		RenderSnapshot& BeginSnapshot() { return snapshots[writing]; }
+
+		/// <summary>
+		/// Hands the snapshot returned by BeginSnapshot to the render thread, after the previous one was taken.
+		/// </summary>
+		void Publish();
+
+		/// <summary>
+		/// Publishes the camera for the frame being drawn, or the next one.
+		/// </summary>
+		/// <param name="inputTime">The glfwGetTime of the last mouse move the view includes, negative if there was none.</param>
+		void PublishCamera(const glm::mat4& view, double inputTime);
+
+		/// <summary>
+		/// Returns the last camera published, leaving view and inputTime as they are if there is none yet. The input
+		/// time is only returned once, a camera drawn again without new input gives a negative time. Render thread only.
+		/// </summary>
+		void GetCamera(glm::mat4& view, double& inputTime);
+
+		/// <summary>
+		/// Prints the frames drawn and how long each thread waited for the other.
+		/// </summary>
+		void PrintStatistics();
+
+		static const int SNAPSHOT_COUNT = 3;
+
+	private:
+		/// <summary>
+		/// Draws the snapshots as they are published, until Stop.
+		/// </summary>
+		void Run();
+
+		// Render threads cannot be copied, the copy would share the thread.
+		RenderThread(const RenderThread&);
+		RenderThread& operator=(const RenderThread&);
+
+		Window* window;
+		RenderFunction render;
+		std::thread thread;
+		bool running;
+
+		// Guarded by mutex
+		std::mutex mutex;
+		std::condition_variable changed;
+		RenderSnapshot snapshots[SNAPSHOT_COUNT];
+		int writing; // Snapshot built by the main thread
+		int published; // Snapshot waiting for the render thread, -1 if none
+		int drawing; // Snapshot drawn by the render thread, -1 if none
+		bool stopping;
+		glm::mat4 cameraView;
+		double cameraInputTime;
+		bool hasCamera;
+
+		// Statistics
+		int frames;
+		double publishWaitMilliseconds; // Main thread waiting for the render thread
+		double idleMilliseconds; // Render thread waiting for a snapshot
+};
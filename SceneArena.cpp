@@ -0,0 +1,39 @@
+#include "SceneArena.h"
+
+SceneArena::SceneArena()
+{
+}
+
+SceneArena::~SceneArena()
+{
+	Release();
+}
+
+ComplexObject* SceneArena::CreateObject()
+{
+	// The children belong to the arena as well, so the object leaves them alone when destroyed.
+	return objects.Create(false);
+}
+
+Mesh* SceneArena::CreateMesh()
+{
+	return meshes.Create();
+}
+
+IndependentMesh* SceneArena::CreateIndependentMesh()
+{
+	return independentMeshes.Create();
+}
+
+void SceneArena::Release()
+{
+	// Objects first, their destructors only touch their own members.
+	objects.Release();
+	meshes.Release();
+	independentMeshes.Release();
+}
+
+size_t SceneArena::Size() const
+{
+	return objects.Size() + meshes.Size() + independentMeshes.Size();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Mesh.h"
+#include "IndependentMesh.h"
+#include "ComplexObject.h"
+#include "ObjectPool.h"
+
+/// <summary>
+/// Owner of the objects and meshes of a whole scene, created from pools rather than one by one on the heap.
+/// The objects it creates do not delete their children, the arena destroys everything at once in Release, so a
+/// scene is torn down without walking it, and rebuilt in the same memory.
+/// Meshes must only be added to objects of the same arena, and a pooled object must never be deleted.
+/// </summary>
+class SceneArena
+{
+	public:
+		SceneArena();
+		~SceneArena();
+
+		/// <summary>
+		/// Creates an empty object owned by the arena.
+		/// </summary>
+		ComplexObject* CreateObject();
+
+		/// <summary>
+		/// Creates an empty mesh owned by the arena.
+		/// </summary>
+		Mesh* CreateMesh();
+
+		/// <summary>
+		/// Creates an empty independent mesh owned by the arena.
+		/// </summary>
+		IndependentMesh* CreateIndependentMesh();
+
+		/// <summary>
+		/// Destroys every object and mesh of the arena, keeping the memory for the next scene.
+		/// </summary>
+		void Release();
+
+		/// <summary>
+		/// Returns the number of objects and meshes alive in the arena.
+		/// </summary>
+		size_t Size() const;
+
+	private:
+		ObjectPool<ComplexObject> objects;
+		ObjectPool<Mesh> meshes;
+		ObjectPool<IndependentMesh> independentMeshes;
+};
@@ -0,0 +1,534 @@
+#include "SceneBlob.h"
+#include "IndependentMesh.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+/// <summary>
+/// Start of every blob. Each table starts at its offset from the start of the blob, on a 16 byte boundary.
+/// </summary>
+struct SceneBlobHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int size; // Of the whole blob, in bytes
+	unsigned int nodeCount;
+	unsigned int meshCount;
+	unsigned int materialCount;
+	unsigned int stringSize; // Bytes
+	unsigned int vertexCount; // Floats, 3 per vertex
+	unsigned int indexCount;
+	unsigned int nodeOffset;
+	unsigned int meshOffset;
+	unsigned int materialOffset;
+	unsigned int stringOffset;
+	unsigned int vertexOffset;
+	unsigned int indexOffset;
+	unsigned int reserved;
+};
+
+/// <summary>
+/// An object or a mesh of the scene. Nodes are stored in preorder, so a parent always comes before its children.
+/// </summary>
+struct SceneBlobNode
+{
+	int parent; // Index of the parent object, -1 for the top level of the scene
+	unsigned int type;
+	unsigned int mesh; // Index in the mesh table, for mesh nodes
+	unsigned int material; // Index in the material table, NO_INDEX if the object has none
+	unsigned int flags;
+	unsigned int reserved;
+	float local[16]; // Model matrix of the node itself, combined with the ones of its parents when drawn
+};
+
+/// <summary>
+/// A range of the pools, drawn by one or more mesh nodes.
+/// </summary>
+struct SceneBlobMesh
+{
+	unsigned int firstIndex;
+	unsigned int indexCount;
+	unsigned int firstVertex;
+	unsigned int vertexCount;
+};
+
+/// <summary>
+/// How an object is drawn.
+/// </summary>
+struct SceneBlobMaterial
+{
+	float colour[4];
+	unsigned int texture; // Offset of the texture path in the string table, NO_INDEX if there is none
+	unsigned int flags;
+	unsigned int reserved[2];
+};
+
+static const char BLOB_MAGIC[4] = { 'S', 'C', 'N', 'B' };
+static const unsigned int SECTION_ALIGNMENT = 16;
+static const unsigned int NO_INDEX = 0xFFFFFFFF;
+
+enum SceneBlobNodeType { NODE_OBJECT = 0, NODE_MESH = 1 };
+enum SceneBlobNodeFlags { HAS_MATRIX = 1, INDEPENDENT = 2 };
+enum SceneBlobMaterialFlags { HAS_COLOUR = 1, HAS_TEXTURE = 2 };
+
+/// <summary>
+/// Everything gathered while walking the scene, before it is packed.
+/// </summary>
+struct SceneBlobBuilder
+{
+	std::vector<SceneBlobNode> nodes;
+	std::vector<SceneBlobMesh> meshes;
+	std::vector<SceneBlobMaterial> materials;
+	std::string strings;
+	std::vector<GLfloat> vertices;
+	std::vector<unsigned int> indices;
+
+	std::unordered_map<const MeshData*, unsigned int> meshLookup; // Index of each source already stored
+	std::unordered_map<std::string, unsigned int> stringLookup; // Offset of each string already stored
+};
+
+static size_t Align(size_t offset)
+{
+	return (offset + SECTION_ALIGNMENT - 1) & ~(size_t)(SECTION_ALIGNMENT - 1);
+}
+
+/// <summary>
+/// Returns true if a table starts on a 16 byte boundary and ends inside the blob.
+/// </summary>
+static bool TableFits(unsigned int offset, unsigned int count, size_t elementSize, size_t size)
+{
+	return offset % SECTION_ALIGNMENT == 0 && offset <= size && (size - offset) / elementSize >= count;
+}
+
+static SceneBlobNode MakeNode(int parent, unsigned int type, const glm::mat4& local)
+{
+	SceneBlobNode node;
+	memset(&node, 0, sizeof(node));
+	node.parent = parent;
+	node.type = type;
+	node.mesh = NO_INDEX;
+	node.material = NO_INDEX;
+	memcpy(node.local, glm::value_ptr(local), sizeof(node.local));
+	return node;
+}
+
+static unsigned int AddString(SceneBlobBuilder& builder, const std::string& text)
+{
+	auto found = builder.stringLookup.find(text);
+	if (found != builder.stringLookup.end())
+		return found->second;
+
+	unsigned int offset = (unsigned int)builder.strings.size();
+	builder.strings.append(text);
+	builder.strings.push_back('\0');
+	builder.stringLookup[text] = offset;
+	return offset;
+}
+
+static unsigned int AddMaterial(SceneBlobBuilder& builder, ComplexObject* object)
+{
+	if (!object->HasColour() && !object->HasTexture())
+		return NO_INDEX;
+
+	SceneBlobMaterial material;
+	memset(&material, 0, sizeof(material));
+	material.texture = NO_INDEX;
+
+	glm::vec3 colour = object->GetColour();
+	material.colour[0] = colour.x;
+	material.colour[1] = colour.y;
+	material.colour[2] = colour.z;
+	material.colour[3] = 1.0f;
+	if (object->HasColour())
+		material.flags |= HAS_COLOUR;
+
+	const char* texturePath = object->HasTexture() ? object->GetTexture().getFileLocation() : NULL;
+	if (texturePath != NULL && texturePath[0] != '\0')
+	{
+		material.texture = AddString(builder, texturePath);
+		material.flags |= HAS_TEXTURE;
+	}
+
+	// Objects drawn the same way share their material.
+	for (unsigned int i = 0; i < builder.materials.size(); i++)
+	{
+		if (memcmp(&builder.materials[i], &material, sizeof(material)) == 0)
+			return i;
+	}
+	builder.materials.push_back(material);
+	return (unsigned int)builder.materials.size() - 1;
+}
+
+static bool AddMesh(SceneBlobBuilder& builder, Mesh* mesh, int parent)
+{
+	const MeshData* data = mesh->GetSourceData();
+	if (data == NULL)
+	{
+		printf("Cannot bake a mesh that did not keep its source data\n");
+		return false;
+	}
+
+	IndependentMesh* independent = dynamic_cast<IndependentMesh*>(mesh);
+	glm::mat4 local = independent != NULL ? independent->GetModelMatrix() : glm::mat4(1.0f);
+	SceneBlobNode node = MakeNode(parent, NODE_MESH, local);
+	if (independent != NULL)
+		node.flags |= HAS_MATRIX | INDEPENDENT;
+
+	auto found = builder.meshLookup.find(data);
+	if (found == builder.meshLookup.end())
+	{
+		SceneBlobMesh range;
+		range.firstIndex = (unsigned int)builder.indices.size();
+		range.indexCount = (unsigned int)data->indices.size();
+		range.firstVertex = (unsigned int)(builder.vertices.size() / 3);
+		range.vertexCount = (unsigned int)(data->vertices.size() / 3);
+
+		// Indices are moved past the vertices already in the pool.
+		builder.vertices.insert(builder.vertices.end(), data->vertices.begin(), data->vertices.end());
+		for (size_t i = 0; i < data->indices.size(); i++)
+		{
+			builder.indices.push_back(data->indices[i] + range.firstVertex);
+		}
+
+		builder.meshes.push_back(range);
+		found = builder.meshLookup.insert(std::make_pair(data, (unsigned int)builder.meshes.size() - 1)).first;
+	}
+
+	node.mesh = found->second;
+	builder.nodes.push_back(node);
+	return true;
+}
+
+static bool AddObject(SceneBlobBuilder& builder, ComplexObject* object, int parent)
+{
+	glm::mat4 local = object->HasModelMatrix() ? object->GetModelMatrix() : glm::mat4(1.0f);
+	SceneBlobNode node = MakeNode(parent, NODE_OBJECT, local);
+	if (object->HasModelMatrix())
+		node.flags |= HAS_MATRIX;
+	node.material = AddMaterial(builder, object);
+
+	int index = (int)builder.nodes.size();
+	builder.nodes.push_back(node);
+
+	for (int i = 0; i < object->meshList.size(); i++)
+	{
+		if (!AddMesh(builder, object->meshList[i], index))
+			return false;
+	}
+	for (int i = 0; i < object->objectList.size(); i++)
+	{
+		if (!AddObject(builder, object->objectList[i], index))
+			return false;
+	}
+	return true;
+}
+
+SceneBlob::SceneBlob()
+{
+	VAO = 0;
+	VBO = 0;
+	IBO = 0;
+}
+
+SceneBlob::~SceneBlob()
+{
+	Clear();
+}
+
+std::vector<unsigned char> SceneBlob::Build(const std::vector<Mesh*>& meshes, const std::vector<ComplexObject*>& objects)
+{
+	SceneBlobBuilder builder;
+	for (int i = 0; i < meshes.size(); i++)
+	{
+		if (!AddMesh(builder, meshes[i], -1))
+			return std::vector<unsigned char>();
+	}
+	for (int i = 0; i < objects.size(); i++)
+	{
+		if (!AddObject(builder, objects[i], -1))
+			return std::vector<unsigned char>();
+	}
+
+	SceneBlobHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BLOB_MAGIC, sizeof(BLOB_MAGIC));
+	header.version = VERSION;
+	header.nodeCount = (unsigned int)builder.nodes.size();
+	header.meshCount = (unsigned int)builder.meshes.size();
+	header.materialCount = (unsigned int)builder.materials.size();
+	header.stringSize = (unsigned int)builder.strings.size();
+	header.vertexCount = (unsigned int)builder.vertices.size();
+	header.indexCount = (unsigned int)builder.indices.size();
+
+	// Each table is placed after the previous one, on the next 16 byte boundary.
+	size_t offset = Align(sizeof(header));
+	header.nodeOffset = (unsigned int)offset;
+	offset = Align(offset + sizeof(SceneBlobNode) * builder.nodes.size());
+	header.meshOffset = (unsigned int)offset;
+	offset = Align(offset + sizeof(SceneBlobMesh) * builder.meshes.size());
+	header.materialOffset = (unsigned int)offset;
+	offset = Align(offset + sizeof(SceneBlobMaterial) * builder.materials.size());
+	header.stringOffset = (unsigned int)offset;
+	offset = Align(offset + builder.strings.size());
+	header.vertexOffset = (unsigned int)offset;
+	offset = Align(offset + sizeof(GLfloat) * builder.vertices.size());
+	header.indexOffset = (unsigned int)offset;
+	offset = offset + sizeof(unsigned int) * builder.indices.size();
+	header.size = (unsigned int)offset;
+
+	std::vector<unsigned char> blob(offset, 0);
+	memcpy(&blob[0], &header, sizeof(header));
+	memcpy(&blob[header.nodeOffset], builder.nodes.data(), sizeof(SceneBlobNode) * builder.nodes.size());
+	memcpy(&blob[header.meshOffset], builder.meshes.data(), sizeof(SceneBlobMesh) * builder.meshes.size());
+	memcpy(&blob[header.materialOffset], builder.materials.data(), sizeof(SceneBlobMaterial) * builder.materials.size());
+	memcpy(&blob[header.stringOffset], builder.strings.data(), builder.strings.size());
+	memcpy(&blob[header.vertexOffset], builder.vertices.data(), sizeof(GLfloat) * builder.vertices.size());
+	memcpy(&blob[header.indexOffset], builder.indices.data(), sizeof(unsigned int) * builder.indices.size());
+	return blob;
+}
+
+bool SceneBlob::WriteHeaderFile(const std::vector<unsigned char>& blob, const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "w");
+	if (file == NULL)
+	{
+		printf("Could not write the scene blob %s\n", path.c_str());
+		return false;
+	}
+
+	fprintf(file, "#pragma once\n");
+	fprintf(file, "// Generated by tools/SceneBaker from the default scene, do not edit.\n\n");
+	fprintf(file, "alignas(16) static const unsigned char SCENE_BLOB_DATA[%u] = {", (unsigned int)blob.size());
+	for (size_t i = 0; i < blob.size(); i++)
+	{
+		fprintf(file, i % 16 == 0 ? "\n\t0x%02x," : " 0x%02x,", blob[i]);
+	}
+	fprintf(file, "\n};\n");
+
+	bool written = ferror(file) == 0;
+	fclose(file);
+	return written;
+}
+
+bool SceneBlob::WriteFile(const std::vector<unsigned char>& blob, const std::string& path)
+{
+	// Written aside then renamed, so a crash never leaves a half written scene under the real name.
+	std::string temporaryPath = path + ".tmp";
+	FILE* file = fopen(temporaryPath.c_str(), "wb");
+	if (file == NULL)
+	{
+		printf("Could not write the scene file %s\n", temporaryPath.c_str());
+		return false;
+	}
+
+	bool written = fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+	fclose(file);
+
+	std::error_code error;
+	std::filesystem::remove(path, error);
+	if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0)
+	{
+		printf("Could not write the scene file %s\n", path.c_str());
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+bool SceneBlob::Load(const unsigned char* data, size_t size, GLuint modelLocation, GLuint textureLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects)
+{
+	Clear();
+	return Create(data, size, modelLocation, textureLocation, meshes, objects);
+}
+
+bool SceneBlob::LoadFile(const std::string& path, GLuint modelLocation, GLuint textureLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects)
+{
+	Clear();
+	if (!file.Open(path))
+	{
+		printf("Could not open the scene file %s\n", path.c_str());
+		return false;
+	}
+
+	if (!Create(file.GetData(), file.GetSize(), modelLocation, textureLocation, meshes, objects))
+	{
+		file.Close();
+		return false;
+	}
+	return true;
+}
+
+bool SceneBlob::Create(const unsigned char* data, size_t size, GLuint modelLocation, GLuint textureLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects)
+{
+	// The tables are read in place, so they have to be aligned in memory as they are in the blob.
+	if (size < sizeof(SceneBlobHeader) || (uintptr_t)data % SECTION_ALIGNMENT != 0)
+	{
+		printf("The scene blob is too small or not aligned\n");
+		return false;
+	}
+
+	const SceneBlobHeader* header = (const SceneBlobHeader*)data;
+	if (memcmp(header->magic, BLOB_MAGIC, sizeof(BLOB_MAGIC)) != 0 || header->version != VERSION || header->size != size
+		|| !TableFits(header->nodeOffset, header->nodeCount, sizeof(SceneBlobNode), size)
+		|| !TableFits(header->meshOffset, header->meshCount, sizeof(SceneBlobMesh), size)
+		|| !TableFits(header->materialOffset, header->materialCount, sizeof(SceneBlobMaterial), size)
+		|| !TableFits(header->stringOffset, header->stringSize, 1, size)
+		|| !TableFits(header->vertexOffset, header->vertexCount, sizeof(GLfloat), size)
+		|| !TableFits(header->indexOffset, header->indexCount, sizeof(unsigned int), size))
+	{
+		printf("The scene blob is damaged or from another version\n");
+		return false;
+	}
+
+	const SceneBlobNode* nodes = (const SceneBlobNode*)(data + header->nodeOffset);
+	const SceneBlobMesh* ranges = (const SceneBlobMesh*)(data + header->meshOffset);
+	const SceneBlobMaterial* materials = (const SceneBlobMaterial*)(data + header->materialOffset);
+	const char* strings = (const char*)(data + header->stringOffset);
+	const unsigned int* indices = (const unsigned int*)(data + header->indexOffset);
+
+	// Every reference is checked before anything is created, so a damaged blob creates nothing.
+	if (header->stringSize > 0 && strings[header->stringSize - 1] != '\0')
+	{
+		printf("The scene blob is damaged or from another version\n");
+		return false;
+	}
+	for (unsigned int i = 0; i < header->meshCount; i++)
+	{
+		const SceneBlobMesh& range = ranges[i];
+		if (range.firstIndex > header->indexCount || header->indexCount - range.firstIndex < range.indexCount
+			|| range.firstVertex > header->vertexCount / 3 || header->vertexCount / 3 - range.firstVertex < range.vertexCount)
+		{
+			printf("The scene blob has a mesh outside of the pools\n");
+			return false;
+		}
+
+		// The GPU would read whatever follows the vertex buffer for an index past its end.
+		for (unsigned int j = range.firstIndex; j < range.firstIndex + range.indexCount; j++)
+		{
+			if (indices[j] - range.firstVertex >= range.vertexCount) // Indices below the range wrap around past it
+			{
+				printf("The scene blob has a mesh indexing vertices outside of its range\n");
+				return false;
+			}
+		}
+	}
+	for (unsigned int i = 0; i < header->materialCount; i++)
+	{
+		if ((materials[i].flags & HAS_TEXTURE) && materials[i].texture >= header->stringSize)
+		{
+			printf("The scene blob has a texture outside of the string table\n");
+			return false;
+		}
+	}
+	for (unsigned int i = 0; i < header->nodeCount; i++)
+	{
+		const SceneBlobNode& node = nodes[i];
+		bool validParent = node.parent < 0 || (node.parent < (int)i && nodes[node.parent].type == NODE_OBJECT);
+		bool validMesh = node.type != NODE_MESH || node.mesh < header->meshCount;
+		bool validMaterial = node.type != NODE_OBJECT || node.material == NO_INDEX || node.material < header->materialCount;
+		if (!validParent || !validMesh || !validMaterial || node.type > NODE_MESH)
+		{
+			printf("The scene blob has a node with invalid references\n");
+			return false;
+		}
+	}
+
+	// The pools go to the GPU as they are, the whole scene in two uploads.
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	glGenBuffers(1, &IBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * header->indexCount, data + header->indexOffset, GL_STATIC_DRAW);
+
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * header->vertexCount, data + header->vertexOffset, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	glEnableVertexAttribArray(0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	// The objects created so far, by node index, to attach the children to.
+	std::vector<ComplexObject*> created(header->nodeCount, NULL);
+	for (unsigned int i = 0; i < header->nodeCount; i++)
+	{
+		const SceneBlobNode& node = nodes[i];
+		glm::mat4 local = glm::make_mat4(node.local);
+		ComplexObject* parent = node.parent >= 0 ? created[node.parent] : NULL;
+
+		if (node.type == NODE_OBJECT)
+		{
+			ComplexObject* object = arena.CreateObject();
+			if (node.flags & HAS_MATRIX)
+				object->SetModelMatrix(local, modelLocation);
+
+			if (node.material != NO_INDEX)
+			{
+				const SceneBlobMaterial& material = materials[node.material];
+				if (material.flags & HAS_COLOUR)
+					object->SetColour(material.colour[0], material.colour[1], material.colour[2]);
+				if (material.flags & HAS_TEXTURE)
+					object->SetTexture(Texture((char*)(strings + material.texture)), textureLocation);
+			}
+
+			created[i] = object;
+			if (parent != NULL)
+				parent->objectList.push_back(object);
+			else
+				objects.push_back(object);
+		}
+		else
+		{
+			Mesh* mesh;
+			if (node.flags & INDEPENDENT)
+			{
+				IndependentMesh* independent = arena.CreateIndependentMesh();
+				independent->SetModelMatrix(local, modelLocation);
+				mesh = independent;
+			}
+			else
+			{
+				mesh = arena.CreateMesh();
+			}
+			mesh->ShareBuffers(VAO, VBO, IBO, ranges[node.mesh].firstIndex, ranges[node.mesh].indexCount);
+
+			if (parent != NULL)
+				parent->meshList.push_back(mesh);
+			else
+				meshes.push_back(mesh);
+		}
+	}
+
+	return true;
+}
+
+void SceneBlob::Clear()
+{
+	arena.Release();
+
+	if (IBO != 0)
+	{
+		glDeleteBuffers(1, &IBO);
+		IBO = 0;
+	}
+
+	if (VBO != 0)
+	{
+		glDeleteBuffers(1, &VBO);
+		VBO = 0;
+	}
+
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		VAO = 0;
+	}
+
+	file.Close();
+}
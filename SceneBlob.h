@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "ComplexObject.h"
+#include "MappedFile.h"
+#include "SceneArena.h"
+
+/// <summary>
+/// Binary scene format, used both for the default scene embedded into the executable (baked by tools/SceneBaker)
+/// and for scene files on disk.
+/// A scene is a header followed by flat tables, each starting on a 16 byte boundary: the nodes (objects and meshes
+/// in preorder, with their model matrices), the meshes (ranges of the pools), the materials (colour and
+/// texture), a string table holding the texture paths, then a single vertex pool and a single index pool.
+/// The tables are read in place, so a scene file is mapped into memory rather than read, and loading it costs
+/// little more than uploading the pools into one vertex buffer and one index buffer.
+/// </summary>
+class SceneBlob
+{
+	public:
+		SceneBlob();
+		~SceneBlob();
+
+		/// <summary>
+		/// Packs a scene into a blob. Every mesh must have kept its source data (see Mesh::CreateMesh(MeshData*)),
+		/// meshes sharing the same source data are stored once.
+		/// </summary>
+		/// <param name="meshes">The loose meshes of the scene, drawn without any object.</param>
+		/// <param name="objects">The objects of the scene.</param>
+		/// <returns>The blob, or an empty vector if the scene cannot be baked.</returns>
+		static std::vector<unsigned char> Build(const std::vector<Mesh*>& meshes, const std::vector<ComplexObject*>& objects);
+
+		/// <summary>
+		/// Writes a blob as a C++ header declaring SCENE_BLOB_DATA, so it can be compiled into the executable.
+		/// </summary>
+		/// <returns>True if the file was written.</returns>
+		static bool WriteHeaderFile(const std::vector<unsigned char>& blob, const std::string& path);
+
+		/// <summary>
+		/// Writes a blob as a scene file, to be opened with LoadFile.
+		/// </summary>
+		/// <returns>True if the file was written.</returns>
+		static bool WriteFile(const std::vector<unsigned char>& blob, const std::string& path);
+
+		/// <summary>
+		/// Creates the scene stored in a blob. The geometry is uploaded at once, the meshes created draw it without owning it,
+		/// and the textures point at the paths inside the blob, so both the blob and this object must outlive them.
+		/// The objects and meshes belong to this object as well, and are destroyed by Clear.
+		/// </summary>
+		/// <param name="data">The blob, as written by Build. It must start on a 16 byte boundary.</param>
+		/// <param name="size">Size of the blob in bytes.</param>
+		/// <param name="modelLocation">The location of the Model Matrix on the GPU</param>
+		/// <param name="textureLocation">The location of the texture sampler on the GPU</param>
+		/// <param name="meshes">Receives the loose meshes of the scene.</param>
+		/// <param name="objects">Receives the objects of the scene.</param>
+		/// <returns>False if the blob is damaged or from another version, nothing is created then.</returns>
+		bool Load(const unsigned char* data, size_t size, GLuint modelLocation, GLuint textureLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects);
+
+		/// <summary>
+		/// Maps a scene file into memory and creates the scene it holds, see Load. The file stays mapped until Clear.
+		/// </summary>
+		/// <returns>False if the file cannot be opened, or is damaged or from another version.</returns>
+		bool LoadFile(const std::string& path, GLuint modelLocation, GLuint textureLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects);
+
+		/// <summary>
+		/// Destroys the objects and meshes of the scene, clears its geometry from the GPU and unmaps its file.
+		/// </summary>
+		void Clear();
+
+		static const unsigned int VERSION = 3;
+
+	private:
+		/// <summary>
+		/// Checks every table of a blob and creates its scene, see Load. The previous scene must have been cleared.
+		/// </summary>
+		bool Create(const unsigned char* data, size_t size, GLuint modelLocation, GLuint textureLocation, std::vector<Mesh*>& meshes, std::vector<ComplexObject*>& objects);
+
+		GLuint VAO, VBO, IBO;
+
+		MappedFile file; // The scene file, when the scene came from one
+		SceneArena arena; // The objects and meshes of the scene
+};
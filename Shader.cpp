@@ -1,71 +1,206 @@
 #include "Shader.h"
+#include <chrono>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
+/// <summary>
+/// Milliseconds on a steady clock, to time builds across beginBuild and finishBuild.
+/// </summary>
+static double GetMilliseconds()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Shader::Shader()
+{
+	ID = 0;
+	features = 0;
+	pendingVertex = 0;
+	pendingFragment = 0;
+	pendingCache = NULL;
+	pendingStart = 0.0;
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, ShaderCache* cache) : Shader(vertexPath, fragmentPath, 0, cache)
+{
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, unsigned int features, ShaderCache* cache) : Shader()
 {
 	// 1. Get shader source code from local files
 	std::string vertexCode;
 	std::string fragmentCode;
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
+	readSource(vertexPath, vertexCode);
+	readSource(fragmentPath, fragmentCode);
+
+	// 2. Build the program, then wait for it
+	beginBuild(vertexCode, fragmentCode, features, cache);
+	finishBuild();
+}
+
+bool Shader::readSource(const char* path, std::string& code, int depth)
+{
+	std::string text;
+	std::ifstream file;
 
 	// ensure ifstrem objects can throw exceptions
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
 	try
 	{
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
-		std::stringstream vShaderStream, fShaderStream;
+		file.open(path);
+		std::stringstream stream;
+		stream << file.rdbuf();
+		file.close();
+		text = stream.str();
+	}
+	catch (std::ifstream::failure e)
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+		return false;
+	}
 
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
+	// Included files are looked for next to the file including them.
+	std::string directory = path;
+	size_t slash = directory.find_last_of("/\\");
+	directory = slash == std::string::npos ? "" : directory.substr(0, slash + 1);
+
+	bool success = true;
+	size_t lineStart = 0;
+	while (lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+		if (lineEnd == std::string::npos)
+			lineEnd = text.size();
+		else
+			lineEnd++;
 
-		vShaderFile.close();
-		fShaderFile.close();
+		// #include "file" on a line of its own is replaced by the file, anything else is kept as is.
+		size_t first = text.find_first_not_of(" \t", lineStart);
+		size_t open = text.find('"', lineStart);
+		size_t close = open < lineEnd ? text.find('"', open + 1) : std::string::npos;
+		if (first < lineEnd && text.compare(first, 8, "#include") == 0 && open < lineEnd && close < lineEnd)
+		{
+			// Files including each other would never end.
+			if (depth >= MAX_INCLUDE_DEPTH)
+			{
+				std::cout << "ERROR::SHADER::INCLUDE_TOO_DEEP " << path << std::endl;
+				return false;
+			}
 
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+			std::string included = directory + text.substr(open + 1, close - open - 1);
+			success = readSource(included.c_str(), code, depth + 1) && success;
+			code.push_back('\n');
+		}
+		else
+		{
+			code.append(text, lineStart, lineEnd - lineStart);
+		}
+		lineStart = lineEnd;
 	}
-	catch (std::ifstream::failure e)
+	return success;
+}
+
+std::string Shader::getDefines(unsigned int features)
+{
+	std::string defines;
+	if (features & SHADER_TEXTURED)
+		defines += "#define TEXTURED\n";
+	if (features & SHADER_VERTEX_COLOUR)
+		defines += "#define VERTEX_COLOUR\n";
+	if (features & SHADER_INSTANCED)
+		defines += "#define INSTANCED\n";
+	if (features & SHADER_LIT)
+		defines += "#define LIT\n";
+	if (features & SHADER_TEXTURE_ARRAY)
+		defines += "#define TEXTURE_ARRAY\n";
+	return defines;
+}
+
+/// <summary>
+/// Returns a shader source with defines inserted after its #version line, which has to stay first.
+/// </summary>
+static std::string InsertDefines(const std::string& code, const std::string& defines)
+{
+	size_t position = 0;
+	size_t version = code.find("#version");
+	if (version != std::string::npos)
+	{
+		position = code.find('\n', version);
+		position = position == std::string::npos ? code.size() : position + 1;
+	}
+
+	std::string result = code.substr(0, position);
+	if (!result.empty() && result[result.size() - 1] != '\n')
+		result.push_back('\n');
+	result += defines;
+	result.append(code, position, std::string::npos);
+	return result;
+}
+
+void Shader::beginBuild(const std::string& vertexSource, const std::string& fragmentSource, unsigned int features, ShaderCache* cache)
+{
+	this->features = features;
+	std::string defines = getDefines(features);
+
+	// Look for the program in the cache, compiled by an earlier launch
+	if (cache != NULL)
 	{
-		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+		pendingKey = cache->MakeKey(vertexSource, fragmentSource, defines);
+		ID = cache->Load(pendingKey);
+		if (ID != 0)
+			return;
 	}
+	pendingCache = cache;
+	pendingStart = GetMilliseconds();
 
+	std::string vertexCode = InsertDefines(vertexSource, defines);
+	std::string fragmentCode = InsertDefines(fragmentSource, defines);
 	const char* vShaderCode = vertexCode.c_str();
 	const char* fShaderCode = fragmentCode.c_str();
 
-	// 2. compile shaders
-	unsigned int vertex, fragment;
+	// Compile shaders. Nothing is checked until finishBuild, so drivers compiling in the background
+	// (GL_KHR_parallel_shader_compile) keep going while the other variants are started.
+	pendingVertex = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(pendingVertex, 1, &vShaderCode, NULL);
+	glCompileShader(pendingVertex);
+
+	pendingFragment = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(pendingFragment, 1, &fShaderCode, NULL);
+	glCompileShader(pendingFragment);
+
+	ID = glCreateProgram();
+	if (cache != NULL && cache->IsSupported())
+	{
+		// The driver only keeps the binary of programs that ask for it before linking.
+		glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	glAttachShader(ID, pendingVertex);
+	glAttachShader(ID, pendingFragment);
+	glLinkProgram(ID);
+}
+
+void Shader::finishBuild()
+{
+	// Loaded from the cache, nothing was compiled.
+	if (pendingVertex == 0)
+		return;
+
 	int success;
 	char infoLog[512];
 
-	vertex = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertex, 1, &vShaderCode, NULL);
-	glCompileShader(vertex);
-
-	glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
+	glGetShaderiv(pendingVertex, GL_COMPILE_STATUS, &success);
 	if (!success)
 	{
-		glGetShaderInfoLog(vertex, 512, NULL, infoLog);
+		glGetShaderInfoLog(pendingVertex, 512, NULL, infoLog);
 		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
 	}
 
-	fragment = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragment, 1, &fShaderCode, NULL);
-	glCompileShader(fragment);
-
-	glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
+	glGetShaderiv(pendingFragment, GL_COMPILE_STATUS, &success);
 	if (!success)
 	{
-		glGetShaderInfoLog(fragment, 512, NULL, infoLog);
+		glGetShaderInfoLog(pendingFragment, 512, NULL, infoLog);
 		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
 	}
 
-	ID = glCreateProgram();
-	glAttachShader(ID, vertex);
-	glAttachShader(ID, fragment);
-	glLinkProgram(ID);
 	// Check for linking errors
 	glGetProgramiv(ID, GL_LINK_STATUS, &success);
 	if (!success)
@@ -73,10 +208,28 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
 		glGetProgramInfoLog(ID, 512, NULL, infoLog);
 		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
 	}
+	else if (pendingCache != NULL)
+	{
+		pendingCache->Store(pendingKey, ID, GetMilliseconds() - pendingStart);
+	}
+
+	// Delete shaders, they are now linked to our program and no longer neccessary
+	glDeleteShader(pendingVertex);
+	glDeleteShader(pendingFragment);
+	pendingVertex = 0;
+	pendingFragment = 0;
+	pendingCache = NULL;
+	pendingKey.clear();
+}
 
-	// Delete shaders, they are now linked to our program and no longer neccessary 
-	glDeleteShader(vertex);
-	glDeleteShader(fragment);
+bool Shader::isBuilt()
+{
+	if (pendingVertex == 0 || !GLEW_KHR_parallel_shader_compile)
+		return true;
+
+	GLint done = GL_TRUE;
+	glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+	return done == GL_TRUE;
 }
 
 unsigned int Shader::getId()
@@ -94,7 +247,7 @@ void Shader::free()
 	glUseProgram(0);
 }
 
-// Setter methods to set uniform values inside shaders. 
+// Setter methods to set uniform values inside shaders.
 void Shader::setBool(const std::string& name, bool value) const
 {
 	glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
@@ -119,3 +272,12 @@ GLuint Shader::getLocation(const std::string& name) const
 {
 	return glGetUniformLocation(ID, name.c_str());
 }
+
+void Shader::bindUniformBlock(const std::string& name, GLuint binding) const
+{
+	GLuint blockIndex = glGetUniformBlockIndex(ID, name.c_str());
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(ID, blockIndex, binding);
+	}
+}
@@ -9,6 +9,21 @@
 #include <sstream>
 #include <iostream>
 
+#include "ShaderCache.h"
+
+/// <summary>
+/// Optional features of the shaders, each one defined for the shader sources when set (TEXTURED, VERTEX_COLOUR...),
+/// so every combination compiles into a program doing only what it needs.
+/// </summary>
+enum ShaderFeature
+{
+	SHADER_TEXTURED = 1 << 0, // Samples theTexture
+	SHADER_VERTEX_COLOUR = 1 << 1, // Colours with the r, rg and rgb uniforms, or the colour of the instance
+	SHADER_INSTANCED = 1 << 2, // Draws the glyph parts of a TextRenderer, see the GlyphParts block
+	SHADER_LIT = 1 << 3, // Applies the ambient light dl
+	SHADER_TEXTURE_ARRAY = 1 << 4 // Samples a layer of theTextures, see TextureArray
+};
+
 /* Entire process of creating a vertex and fragment shader from source code on disk, compiling them and then creating and linking a program*/
 class Shader
 {
@@ -20,10 +35,25 @@ public:
 	/// </summary>
 	/// <param name="vertexPath"></param>
 	/// <param name="fragmentPath"></param>
-	Shader(const char* vertexPath, const char* fragmentPath);
+	/// <param name="cache">Where the linked program is looked for before compiling it, and stored after. NULL to always compile.</param>
+	Shader(const char* vertexPath, const char* fragmentPath, ShaderCache* cache = NULL);
+	/// <summary>
+	/// Constructor, constructs the variant of shaders from file with a set of features
+	/// </summary>
+	/// <param name="features">The ShaderFeature flags to define for the sources.</param>
+	/// <param name="cache">Where the linked program is looked for before compiling it, and stored after. NULL to always compile.</param>
+	Shader(const char* vertexPath, const char* fragmentPath, unsigned int features, ShaderCache* cache = NULL);
 	void use();
 	void free(); // free program
 	unsigned int getId();
+	/// <summary>
+	/// Returns the ShaderFeature flags this program was built with
+	/// </summary>
+	unsigned int getFeatures() const { return features; }
+	/// <summary>
+	/// Returns false while the driver is still compiling the program in the background (GL_KHR_parallel_shader_compile)
+	/// </summary>
+	bool isBuilt();
 
 	/// <summary>
 	/// Used to set a boolean uniform inside a shader
@@ -55,4 +85,46 @@ public:
 	/// <param name="name">Name of the uniform</param>
 	/// <returns>Returns the unsigned integer that points to that uniform</returns>
 	GLuint getLocation(const std::string& name) const;
+	/// <summary>
+	/// Ties a uniform block of the shader to a uniform buffer binding point
+	/// </summary>
+	/// <param name="name">Name of the uniform block</param>
+	/// <param name="binding">The binding point the buffer is bound to with glBindBufferBase</param>
+	void bindUniformBlock(const std::string& name, GLuint binding) const;
+
+	/// <summary>
+	/// Reads a shader source from file, replacing every #include "file" line by that file, looked for next to the including one
+	/// </summary>
+	/// <param name="path">Path of the file</param>
+	/// <param name="code">Receives the source, appended to what it holds</param>
+	/// <returns>False if a file could not be read</returns>
+	static bool readSource(const char* path, std::string& code, int depth = 0);
+	/// <summary>
+	/// Returns the #define lines of a set of features
+	/// </summary>
+	static std::string getDefines(unsigned int features);
+
+	static const int MAX_INCLUDE_DEPTH = 16;
+
+private:
+	friend class ShaderVariants;
+
+	Shader();
+
+	/// <summary>
+	/// Starts building a program from sources, without waiting for the driver. finishBuild must be called before using it.
+	/// </summary>
+	void beginBuild(const std::string& vertexSource, const std::string& fragmentSource, unsigned int features, ShaderCache* cache);
+	/// <summary>
+	/// Waits for the program started by beginBuild, reports its errors and stores it in the cache
+	/// </summary>
+	void finishBuild();
+
+	unsigned int features;
+
+	// Build started by beginBuild, until finishBuild
+	unsigned int pendingVertex, pendingFragment;
+	ShaderCache* pendingCache;
+	std::string pendingKey;
+	double pendingStart;
 };
@@ -0,0 +1,203 @@
+#include "ShaderCache.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+const char* ShaderCache::DEFAULT_DIRECTORY = "shadercache";
+
+/// <summary>
+/// Start of every cache file. The key is stored after it, then the program binary.
+/// </summary>
+struct ShaderCacheFileHeader
+{
+	char magic[4];
+	unsigned int keyLength;
+	unsigned int binaryFormat; // As given by glGetProgramBinary
+	unsigned int binarySize;
+	float compileMilliseconds; // How long the program took to build from source
+};
+
+static const char FILE_MAGIC[4] = { 'S', 'P', 'B', '1' };
+
+/// <summary>
+/// 64 bit FNV-1a hash, used to name the cache files.
+/// </summary>
+static unsigned long long HashBytes(const std::string& bytes)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < bytes.size(); i++)
+	{
+		hash ^= (unsigned char)bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/// <summary>
+/// Appends a driver string to a key, followed by a separator.
+/// </summary>
+static void AppendString(std::string& key, GLenum name)
+{
+	const GLubyte* value = glGetString(name);
+	if (value != NULL)
+		key += (const char*)value;
+	key.push_back('\0');
+}
+
+ShaderCache::ShaderCache(const std::string& directory)
+{
+	this->directory = directory;
+
+	hits = 0;
+	misses = 0;
+	rejected = 0;
+	millisecondsSaved = 0.0;
+}
+
+bool ShaderCache::IsSupported()
+{
+	if (!GLEW_ARB_get_program_binary)
+		return false;
+
+	// Some drivers have the extension but no format to write binaries in.
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
+std::string ShaderCache::MakeKey(const std::string& vertexCode, const std::string& fragmentCode, const std::string& defines)
+{
+	std::string key;
+	AppendString(key, GL_VENDOR);
+	AppendString(key, GL_RENDERER);
+	AppendString(key, GL_VERSION);
+	key += defines;
+	key.push_back('\0');
+	key += vertexCode;
+	key.push_back('\0');
+	key += fragmentCode;
+	return key;
+}
+
+std::string ShaderCache::GetPath(const std::string& key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.bin", HashBytes(key));
+	return directory + "/" + name;
+}
+
+GLuint ShaderCache::Load(const std::string& key)
+{
+	auto start = std::chrono::steady_clock::now();
+	misses++;
+
+	if (!IsSupported())
+		return 0;
+
+	FILE* file = fopen(GetPath(key).c_str(), "rb");
+	if (file == NULL)
+		return 0;
+
+	// The whole file in one read, then the pieces are picked out of the buffer.
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	std::vector<char> buffer(size > 0 ? size : 0);
+	bool read = size >= (long)sizeof(ShaderCacheFileHeader) && fread(&buffer[0], 1, size, file) == (size_t)size;
+	fclose(file);
+	if (!read)
+		return 0;
+
+	ShaderCacheFileHeader header;
+	memcpy(&header, &buffer[0], sizeof(header));
+	size_t expected = sizeof(header) + (size_t)header.keyLength + header.binarySize;
+	if (memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || expected != (size_t)size)
+		return 0;
+
+	// Another program with the same hash.
+	const char* data = &buffer[sizeof(header)];
+	if (header.keyLength != key.size() || memcmp(data, key.data(), key.size()) != 0)
+		return 0;
+	data += header.keyLength;
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, header.binaryFormat, data, header.binarySize);
+
+	// The driver may refuse a binary it wrote itself, after an update that kept its version string.
+	GLint success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glDeleteProgram(program);
+		std::error_code error;
+		std::filesystem::remove(GetPath(key), error);
+		rejected++;
+		return 0;
+	}
+
+	misses--;
+	hits++;
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	millisecondsSaved += header.compileMilliseconds - milliseconds;
+	return program;
+}
+
+void ShaderCache::Store(const std::string& key, GLuint program, double compileMilliseconds)
+{
+	if (!IsSupported())
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &format, binary.data());
+	if (written <= 0)
+		return;
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// Written aside then renamed, so a crash never leaves a half written file under the real name.
+	std::string path = GetPath(key);
+	std::string temporaryPath = path + ".tmp";
+	FILE* file = fopen(temporaryPath.c_str(), "wb");
+	if (file == NULL)
+	{
+		printf("Could not write the shader cache file %s\n", temporaryPath.c_str());
+		return;
+	}
+
+	ShaderCacheFileHeader header;
+	memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.keyLength = (unsigned int)key.size();
+	header.binaryFormat = format;
+	header.binarySize = (unsigned int)written;
+	header.compileMilliseconds = (float)compileMilliseconds;
+
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(key.data(), 1, key.size(), file) == key.size()
+		&& fwrite(binary.data(), 1, written, file) == (size_t)written;
+	fclose(file);
+
+	std::filesystem::remove(path, error);
+	if (!success || rename(temporaryPath.c_str(), path.c_str()) != 0)
+	{
+		printf("Could not write the shader cache file %s\n", path.c_str());
+		std::filesystem::remove(temporaryPath, error);
+	}
+}
+
+void ShaderCache::PrintStatistics()
+{
+	int total = hits + misses;
+	printf("Shader cache: %d of %d programs loaded from the cache (%d refused by the driver), %.1f ms saved\n",
+		hits, total, rejected, millisecondsSaved);
+}
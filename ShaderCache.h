@@ -0,0 +1,68 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+
+/// <summary>
+/// On-disk cache of linked shader programs, so a program compiled once is not compiled again on the next launch.
+/// Programs are stored as driver binaries (glGetProgramBinary), named after a hash of their sources, their defines
+/// and the vendor, renderer and version strings of the driver, so a driver update or a source change misses and the
+/// program is compiled from source again. A binary the driver refuses is dropped and compiled again as well.
+/// Needs ARB_get_program_binary (core in OpenGL 4.1); without it every program is a miss.
+/// </summary>
+class ShaderCache
+{
+	public:
+		/// <summary>
+		/// Creates a cache. It can be created before the OpenGL context, but only used once it is current.
+		/// </summary>
+		/// <param name="directory">Folder of the cache files, created when the first program is written.</param>
+		ShaderCache(const std::string& directory = DEFAULT_DIRECTORY);
+
+		/// <summary>
+		/// Returns true if the driver can give and take program binaries.
+		/// </summary>
+		bool IsSupported();
+
+		/// <summary>
+		/// Returns the key of a program for the current driver.
+		/// </summary>
+		/// <param name="defines">The defines the sources are compiled with, empty if none.</param>
+		std::string MakeKey(const std::string& vertexCode, const std::string& fragmentCode, const std::string& defines);
+
+		/// <summary>
+		/// Creates a program from its cached binary.
+		/// </summary>
+		/// <returns>The linked program, or 0 if it is not cached or the driver refused the binary.</returns>
+		GLuint Load(const std::string& key);
+
+		/// <summary>
+		/// Writes the binary of a linked program to the cache. The program must have been linked with
+		/// GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+		/// </summary>
+		/// <param name="compileMilliseconds">How long compiling and linking took, to report the time later hits save.</param>
+		void Store(const std::string& key, GLuint program, double compileMilliseconds);
+
+		/// <summary>
+		/// Prints the hits, misses and time saved since the cache was created.
+		/// </summary>
+		void PrintStatistics();
+
+		/// <summary>
+		/// Programs found in the cache, not found, and found but refused by the driver (also counted as misses).
+		/// </summary>
+		int hits, misses, rejected;
+		/// <summary>
+		/// Compile time saved by the hits, minus the time spent loading them.
+		/// </summary>
+		double millisecondsSaved;
+
+		static const char* DEFAULT_DIRECTORY;
+
+	private:
+		/// <summary>
+		/// Returns the path of the cache file of a key.
+		/// </summary>
+		std::string GetPath(const std::string& key);
+
+		std::string directory;
+};
@@ -0,0 +1,67 @@
+#include "ShaderVariants.h"
+
+ShaderVariants::ShaderVariants(const char* vertexPath, const char* fragmentPath, ShaderCache* cache)
+{
+	this->cache = cache;
+	Shader::readSource(vertexPath, vertexCode);
+	Shader::readSource(fragmentPath, fragmentCode);
+}
+
+ShaderVariants::~ShaderVariants()
+{
+	Clear();
+}
+
+void ShaderVariants::Compile(const std::vector<unsigned int>& featureSets)
+{
+	// Lets the driver use as many threads as it likes for the programs started below.
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	}
+
+	// Everything is started before anything is waited for.
+	size_t first = variants.size();
+	for (int i = 0; i < featureSets.size(); i++)
+	{
+		bool built = false;
+		for (int j = 0; j < variants.size(); j++)
+		{
+			built = built || variants[j]->getFeatures() == featureSets[i];
+		}
+		if (built)
+			continue;
+
+		Shader* variant = new Shader();
+		variant->beginBuild(vertexCode, fragmentCode, featureSets[i], cache);
+		variants.push_back(variant);
+	}
+
+	for (size_t i = first; i < variants.size(); i++)
+	{
+		variants[i]->finishBuild();
+	}
+}
+
+Shader* ShaderVariants::Get(unsigned int features)
+{
+	for (int i = 0; i < variants.size(); i++)
+	{
+		if (variants[i]->getFeatures() == features)
+			return variants[i];
+	}
+
+	Compile(std::vector<unsigned int>(1, features));
+	return variants.back();
+}
+
+void ShaderVariants::Clear()
+{
+	for (int i = 0; i < variants.size(); i++)
+	{
+		if (variants[i]->ID != 0)
+			glDeleteProgram(variants[i]->ID);
+		delete variants[i];
+	}
+	variants.clear();
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "Shader.h"
+#include <vector>
+
+/// <summary>
+/// Every variant of a pair of shader sources, one program per set of features (see ShaderFeature).
+/// The sources are read once, and the variants needed up front are built together: all of them are started before
+/// waiting for any, so a driver with GL_KHR_parallel_shader_compile compiles them on its own threads at the same time.
+/// </summary>
+class ShaderVariants
+{
+	public:
+		/// <summary>
+		/// Reads the sources, nothing is compiled yet.
+		/// </summary>
+		/// <param name="cache">Where the programs are looked for before compiling them, and stored after. NULL to always compile.</param>
+		ShaderVariants(const char* vertexPath, const char* fragmentPath, ShaderCache* cache = NULL);
+		~ShaderVariants();
+
+		/// <summary>
+		/// Builds the variants of several feature sets at once. Variants already built are skipped.
+		/// </summary>
+		/// <param name="featureSets">The ShaderFeature flags of each variant.</param>
+		void Compile(const std::vector<unsigned int>& featureSets);
+
+		/// <summary>
+		/// Returns the variant with exactly these features, building it now if it was not built yet.
+		/// The pointer stays valid until Clear.
+		/// </summary>
+		Shader* Get(unsigned int features);
+
+		/// <summary>
+		/// Deletes every variant from the GPU.
+		/// </summary>
+		void Clear();
+
+	private:
+		std::string vertexCode, fragmentCode;
+		ShaderCache* cache;
+		std::vector<Shader*> variants;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+/// <summary>
+/// Fixed size ring of values passed from one producer thread to one consumer thread without locks.
+/// The producer only writes the tail and the consumer only writes the head, each reading the other's with acquire
+/// ordering, so a value is always complete by the time it can be popped. The two indices sit on separate cache lines
+/// so the threads do not fight over one. Nothing is allocated after construction.
+/// </summary>
+template <typename T, size_t CAPACITY>
+class SpscQueue
+{
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "the capacity is a power of two, indices wrap with a mask");
+
+	public:
+		SpscQueue() : head(0), tail(0)
+		{
+		}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+
+		/// <summary>
+		/// Adds a value at the tail. Producer thread only.
+		/// </summary>
+		/// <returns>False if the queue is full, the value is dropped then.</returns>
+		bool Push(const T& value)
+		{
+			size_t position = tail.load(std::memory_order_relaxed);
+			if (position - head.load(std::memory_order_acquire) == CAPACITY)
+				return false;
+			items[position & (CAPACITY - 1)] = value;
+			tail.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		/// Takes the value at the head. Consumer thread only.
+		/// </summary>
+		/// <returns>False if the queue is empty.</returns>
+		bool Pop(T& value)
+		{
+			size_t position = head.load(std::memory_order_relaxed);
+			if (position == tail.load(std::memory_order_acquire))
+				return false;
+			value = items[position & (CAPACITY - 1)];
+			head.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		/// Returns the number of values waiting, exact only from either thread between its own calls.
+		/// </summary>
+		size_t Size()
+		{
+			return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+		}
+
+	private:
+		alignas(64) std::atomic<size_t> head; // Next value to pop
+		alignas(64) std::atomic<size_t> tail; // Next slot to push into
+		alignas(64) T items[CAPACITY];
+};
@@ -0,0 +1,217 @@
+#include "StreamBuffer.h"
+#include <chrono>
+#include <cstdio>
+
+StreamBuffer::StreamBuffer()
+{
+	buffer = 0;
+	mapping = NULL;
+	persistent = false;
+	frameSize = 0;
+	uniformAlignment = 0;
+	frameIndex = 0;
+	head = 0;
+	for (int i = 0; i < FRAME_COUNT; i++)
+		fences[i] = 0;
+
+	frames = 0;
+	waits = 0;
+	orphans = 0;
+	growths = 0;
+	waitMilliseconds = 0.0;
+	peakFrameBytes = 0;
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	Destroy();
+}
+
+void StreamBuffer::Create(GLsizeiptr frameSize)
+{
+	Destroy();
+	this->frameSize = (frameSize + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+	if (uniformAlignment <= 0)
+		uniformAlignment = (GLint)REGION_ALIGNMENT;
+	persistent = GLEW_ARB_buffer_storage;
+	CreateStorage();
+}
+
+void StreamBuffer::CreateStorage()
+{
+	// Bound to a target nothing else uses, to leave the vertex array and uniform bindings alone.
+	GLsizeiptr size = frameSize * FRAME_COUNT;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	if (persistent)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+		mapping = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+	}
+	else
+	{
+		glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_DRAW);
+		mapping = NULL;
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	frameIndex = 0;
+	head = 0;
+}
+
+void StreamBuffer::Destroy()
+{
+	DeleteFences();
+	DeleteRetired(true);
+	if (buffer != 0)
+	{
+		// Deleting the buffer unmaps it.
+		glDeleteBuffers(1, &buffer);
+		buffer = 0;
+	}
+	mapping = NULL;
+	head = 0;
+}
+
+void StreamBuffer::DeleteFences()
+{
+	for (int i = 0; i < FRAME_COUNT; i++)
+	{
+		if (fences[i] != 0)
+		{
+			glDeleteSync(fences[i]);
+			fences[i] = 0;
+		}
+	}
+}
+
+void StreamBuffer::DeleteRetired(bool all)
+{
+	for (int i = (int)retired.size() - 1; i >= 0; i--)
+	{
+		RetiredBuffer& old = retired[i];
+		if (!all && (old.fence == 0 || glClientWaitSync(old.fence, 0, 0) == GL_TIMEOUT_EXPIRED))
+			continue;
+
+		if (old.fence != 0)
+			glDeleteSync(old.fence);
+		glDeleteBuffers(1, &old.buffer);
+		retired.erase(retired.begin() + i);
+	}
+}
+
+void StreamBuffer::BeginFrame()
+{
+	DeleteRetired(false);
+
+	frameIndex = (frameIndex + 1) % FRAME_COUNT;
+	head = 0;
+	frames++;
+
+	GLsync fence = fences[frameIndex];
+	if (fence == 0)
+		return;
+
+	if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+	{
+		if (!persistent)
+		{
+			// Orphaning gives a fresh buffer at once, the driver frees the old one after the GPU is done with it.
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glBufferData(GL_COPY_WRITE_BUFFER, frameSize * FRAME_COUNT, NULL, GL_STREAM_DRAW);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			DeleteFences();
+			orphans++;
+			return;
+		}
+
+		// The CPU is FRAME_COUNT frames ahead, there is nothing to do but wait for the GPU.
+		auto start = std::chrono::steady_clock::now();
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+		{
+		}
+		waitMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		waits++;
+	}
+
+	glDeleteSync(fence);
+	fences[frameIndex] = 0;
+}
+
+void StreamBuffer::EndFrame()
+{
+	if (buffer == 0)
+		return;
+	if (fences[frameIndex] != 0)
+		glDeleteSync(fences[frameIndex]);
+	fences[frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	for (int i = 0; i < retired.size(); i++)
+	{
+		if (retired[i].fence == 0)
+			retired[i].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	peakFrameBytes = head > peakFrameBytes ? head : peakFrameBytes;
+}
+
+StreamSpan StreamBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment)
+{
+	StreamSpan span = { NULL, 0, 0, 0 };
+	if (buffer == 0 || size <= 0)
+		return span;
+	if (alignment <= 0)
+		alignment = uniformAlignment;
+
+	GLsizeiptr start = (head + alignment - 1) / alignment * alignment;
+	if (start + size > frameSize)
+	{
+		// A new buffer with regions large enough for the whole frame. The spans already handed out this frame are
+		// still written and drawn from the old one, kept mapped until the GPU is done with the frame.
+		GLsizeiptr needed = start + size;
+		GLsizeiptr grown = frameSize * 2 > needed ? frameSize * 2 : needed;
+		RetiredBuffer old = { buffer, 0 };
+		retired.push_back(old);
+		DeleteFences();
+		buffer = 0;
+		mapping = NULL;
+		frameSize = (grown + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+		CreateStorage();
+		growths++;
+		start = 0;
+	}
+
+	span.buffer = buffer;
+	span.offset = frameIndex * frameSize + start;
+	span.size = size;
+	head = start + size;
+
+	if (persistent)
+	{
+		span.data = mapping + span.offset;
+	}
+	else
+	{
+		// The fences already keep the GPU off this range, the driver need not synchronize.
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		span.data = glMapBufferRange(GL_COPY_WRITE_BUFFER, span.offset, size,
+			GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+	return span;
+}
+
+void StreamBuffer::Commit(const StreamSpan& span)
+{
+	// Coherent persistent writes are seen by the next draws without anything to do.
+	if (persistent || span.data == NULL)
+		return;
+	glBindBuffer(GL_COPY_WRITE_BUFFER, span.buffer);
+	glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void StreamBuffer::PrintStatistics()
+{
+	printf("Stream buffer (%s): %d frames, waited for the GPU %d times (%.1f ms), orphaned %d times, grew %d times, %.1f KB a frame at most\n",
+		persistent ? "persistent" : "mapped per allocation", frames, waits, waitMilliseconds, orphans, growths, peakFrameBytes / 1024.0);
+}
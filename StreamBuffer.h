@@ -0,0 +1,125 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+
+/// <summary>
+/// A piece of a StreamBuffer handed out for the current frame: where to write, and what to bind to read it back.
+/// </summary>
+struct StreamSpan
+{
+	void* data; // NULL if the allocation failed
+	GLuint buffer;
+	GLintptr offset;
+	GLsizeiptr size;
+};
+
+/// <summary>
+/// Ring of GPU memory for the data written again every frame: per draw uniforms, instance data, dynamic text.
+/// The buffer is split into FRAME_COUNT regions, one per frame in flight. A frame writes into its own region, and a
+/// fence set at the end of the frame tells when the GPU is done with it, so a region is only reused once the frame
+/// that wrote it has been drawn. The GPU never waits for the CPU, and the CPU only waits when it is FRAME_COUNT
+/// frames ahead.
+/// With GL_ARB_buffer_storage the buffer is mapped once, persistent and coherent, and allocations are plain pointers
+/// into it. Without it, each allocation maps its range unsynchronized, the fences guarding it the same way, and a
+/// region still in use is not waited for: the whole buffer is orphaned instead.
+/// A frame allocating more than a region moves to a bigger buffer. The old one is kept until the GPU is done with the
+/// frame, so the spans it already handed out stay valid, mapped, until they are drawn.
+/// </summary>
+class StreamBuffer
+{
+	public:
+		StreamBuffer();
+		~StreamBuffer();
+
+		/// <summary>
+		/// Creates the buffer, FRAME_COUNT regions of a given size.
+		/// </summary>
+		/// <param name="frameSize">The bytes a frame can allocate before the buffer grows.</param>
+		void Create(GLsizeiptr frameSize);
+
+		/// <summary>
+		/// Deletes the buffer and the ones it grew out of, without waiting for the GPU.
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Starts allocating from the next region, waiting for the GPU to be done with it if needed.
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Sets the fence of the region of the frame. Called after the last draw reading from it.
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>
+		/// Allocates memory for the current frame.
+		/// </summary>
+		/// <param name="alignment">Of the offset in the buffer. 0 aligns it for glBindBufferRange on GL_UNIFORM_BUFFER.</param>
+		/// <returns>Where to write the data, to be given to Commit once written.</returns>
+		StreamSpan Allocate(GLsizeiptr size, GLsizeiptr alignment = 0);
+
+		/// <summary>
+		/// Says the data of an allocation is written and can be drawn from.
+		/// </summary>
+		void Commit(const StreamSpan& span);
+
+		/// <summary>
+		/// Returns true if the buffer is persistently mapped, false if it is mapped for each allocation.
+		/// </summary>
+		bool IsPersistent() { return persistent; }
+
+		/// <summary>
+		/// Prints how often and how long the CPU waited for the GPU, how often the buffer was orphaned or grew,
+		/// and the most a frame allocated.
+		/// </summary>
+		void PrintStatistics();
+
+		static const int FRAME_COUNT = 3;
+		static const GLsizeiptr REGION_ALIGNMENT = 256; // Of the regions, enough for any alignment asked
+
+	private:
+		/// <summary>
+		/// Creates the buffer object and maps it when it can be persistent.
+		/// </summary>
+		void CreateStorage();
+
+		/// <summary>
+		/// Deletes the fences, after the buffer they guard was replaced.
+		/// </summary>
+		void DeleteFences();
+
+		/// <summary>
+		/// Deletes the buffers replaced by a bigger one, once the GPU is done with the frame that replaced them, or
+		/// at once if all is true.
+		/// </summary>
+		void DeleteRetired(bool all);
+
+		/// <summary>
+		/// A buffer the frame grew out of, kept while its spans can still be written and drawn.
+		/// </summary>
+		struct RetiredBuffer
+		{
+			GLuint buffer;
+			GLsync fence; // Set at the end of the frame that replaced it, 0 until then
+		};
+
+		// Stream buffers cannot be copied, the copy would delete the buffer of the original.
+		StreamBuffer(const StreamBuffer&);
+		StreamBuffer& operator=(const StreamBuffer&);
+
+		GLuint buffer;
+		unsigned char* mapping; // The whole buffer, when persistent
+		bool persistent;
+		GLsizeiptr frameSize;
+		GLint uniformAlignment;
+		int frameIndex; // Region of the current frame
+		GLsizeiptr head; // Bytes allocated in the region
+		GLsync fences[FRAME_COUNT];
+		std::vector<RetiredBuffer> retired;
+
+		// Statistics
+		int frames, waits, orphans, growths;
+		double waitMilliseconds;
+		GLsizeiptr peakFrameBytes;
+};
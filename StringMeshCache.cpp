@@ -0,0 +1,238 @@
+#include "StringMeshCache.h"
+#include "IndependentMesh.h"
+#include "MeshCodec.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+const char* StringMeshCache::DEFAULT_DIRECTORY = "meshcache";
+
+/// <summary>
+/// Start of every store file. The key is stored after it, then the mesh encoded by MeshCodec.
+/// </summary>
+struct StringMeshFileHeader
+{
+	char magic[4];
+	unsigned int keyLength;
+	unsigned int dataSize; // Bytes of the encoded mesh
+};
+
+// Changed along with the layout, so files of an older layout are baked again.
+static const char FILE_MAGIC[4] = { 'S', 'M', 'S', '2' };
+
+/// <summary>
+/// 64 bit FNV-1a hash, used to name the store files.
+/// </summary>
+static unsigned long long HashBytes(const std::string& bytes)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < bytes.size(); i++)
+	{
+		hash ^= (unsigned char)bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+StringMeshCache::StringMeshCache(GlyphMeshCache* glyphs, const std::string& directory, size_t capacity)
+{
+	this->glyphs = glyphs;
+	this->directory = directory;
+	this->capacity = capacity > 0 ? capacity : 1;
+
+	memoryHits = 0;
+	diskHits = 0;
+	misses = 0;
+}
+
+StringMeshCache::~StringMeshCache()
+{
+	Clear();
+}
+
+std::string StringMeshCache::MakeKey(const std::string& text, const ExtrudeStyle& style)
+{
+	std::string key = text;
+	key.push_back('\0');
+
+	int version = StrokeFont::GENERATOR_VERSION;
+	key.append((const char*)&style.depth, sizeof(style.depth));
+	key.append((const char*)&style.bevel, sizeof(style.bevel));
+	key.append((const char*)&style.quality, sizeof(style.quality));
+	key.append((const char*)&version, sizeof(version));
+	return key;
+}
+
+std::string StringMeshCache::GetPath(const std::string& key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.mesh", HashBytes(key));
+	return directory + "/" + name;
+}
+
+MeshData StringMeshCache::Bake(const std::string& text, const ExtrudeStyle& style)
+{
+	glyphs->Prepare(text, style);
+
+	MeshData mesh;
+	float pen = 0.0f;
+	for (int i = 0; i < text.size(); i++)
+	{
+		const MeshData* glyph = glyphs->Get((unsigned char)text[i], style);
+		if (glyph != NULL)
+		{
+			mesh.Append(*glyph, glm::translate(glm::mat4(1.0f), glm::vec3(pen, 0.0f, 0.0f)));
+		}
+		pen += StrokeFont::GetAdvance((unsigned char)text[i]);
+	}
+	return mesh;
+}
+
+bool StringMeshCache::ReadFile(const std::string& key, MeshData& mesh)
+{
+	FILE* file = fopen(GetPath(key).c_str(), "rb");
+	if (file == NULL)
+		return false;
+
+	// The whole file in one read, then the pieces are picked out of the buffer.
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	std::vector<char> buffer(size > 0 ? size : 0);
+	bool read = size >= (long)sizeof(StringMeshFileHeader) && fread(&buffer[0], 1, size, file) == (size_t)size;
+	fclose(file);
+	if (!read)
+		return false;
+
+	StringMeshFileHeader header;
+	memcpy(&header, &buffer[0], sizeof(header));
+	size_t expected = sizeof(header) + (size_t)header.keyLength + header.dataSize;
+	if (memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || expected != (size_t)size)
+		return false;
+
+	// Another string with the same hash.
+	const char* data = &buffer[sizeof(header)];
+	if (header.keyLength != key.size() || memcmp(data, key.data(), key.size()) != 0)
+		return false;
+	data += header.keyLength;
+
+	return MeshCodec::Decode((const unsigned char*)data, header.dataSize, mesh);
+}
+
+void StringMeshCache::WriteFile(const std::string& key, const std::vector<unsigned char>& encoded)
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// Written aside then renamed, so a crash never leaves a half written file under the real name.
+	std::string path = GetPath(key);
+	std::string temporaryPath = path + ".tmp";
+	FILE* file = fopen(temporaryPath.c_str(), "wb");
+	if (file == NULL)
+	{
+		printf("Could not write the mesh cache file %s\n", temporaryPath.c_str());
+		return;
+	}
+
+	StringMeshFileHeader header;
+	memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.keyLength = (unsigned int)key.size();
+	header.dataSize = (unsigned int)encoded.size();
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(key.data(), 1, key.size(), file) == key.size()
+		&& fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+	fclose(file);
+
+	std::filesystem::remove(path, error);
+	if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0)
+	{
+		printf("Could not write the mesh cache file %s\n", path.c_str());
+		std::filesystem::remove(temporaryPath, error);
+	}
+}
+
+const MeshData* StringMeshCache::Insert(const std::string& key, MeshData& mesh)
+{
+	if (entries.size() >= capacity)
+	{
+		lookup.erase(entries.back().first);
+		entries.pop_back();
+	}
+
+	entries.push_front(std::make_pair(key, MeshData()));
+	entries.front().second.vertices.swap(mesh.vertices);
+	entries.front().second.indices.swap(mesh.indices);
+	lookup[key] = entries.begin();
+	return &entries.front().second;
+}
+
+const MeshData* StringMeshCache::Get(const std::string& text, const ExtrudeStyle& style)
+{
+	return Find(MakeKey(text, style), [&]() { return Bake(text, style); });
+}
+
+const MeshData* StringMeshCache::GetBaked(const std::string& name, const std::function<MeshData()>& bake)
+{
+	// Keys of strings start with their text, an empty one then a style, so a leading \0 keeps the names apart.
+	std::string key(1, '\0');
+	key.append(name);
+	return Find(key, bake);
+}
+
+const MeshData* StringMeshCache::Find(const std::string& key, const std::function<MeshData()>& bake)
+{
+	auto found = lookup.find(key);
+	if (found != lookup.end())
+	{
+		memoryHits++;
+		entries.splice(entries.begin(), entries, found->second);
+		return &found->second->second;
+	}
+
+	MeshData mesh;
+	if (ReadFile(key, mesh))
+	{
+		diskHits++;
+		return Insert(key, mesh);
+	}
+
+	misses++;
+	mesh = bake();
+
+	// Kept as the store gives it back, so a string is the same mesh whether it was just baked or read from disk.
+	std::vector<unsigned char> encoded = MeshCodec::Encode(mesh);
+	MeshCodec::Decode(encoded.data(), encoded.size(), mesh);
+	WriteFile(key, encoded);
+	return Insert(key, mesh);
+}
+
+ComplexObject* StringMeshCache::CreateStringObject(const std::string& text, const ExtrudeStyle& style, GLuint uniformModel)
+{
+	const MeshData* data = Get(text, style);
+
+	ComplexObject* object = new ComplexObject();
+	if (data->indices.empty())
+		return object;
+
+	// The string is built from its bottom left corner, move its center to the origin.
+	float width = -StrokeFont::GLYPH_SPACING;
+	for (int i = 0; i < text.size(); i++)
+	{
+		width += StrokeFont::GetAdvance((unsigned char)text[i]);
+	}
+	glm::mat4 center = glm::translate(glm::mat4(1.0f), glm::vec3(-width / 2.0f, -3.0f * StrokeFont::GRID_UNIT, 0.0f));
+
+	IndependentMesh* mesh = new IndependentMesh();
+	mesh->CreateMesh(new MeshData(*data));
+	mesh->SetModelMatrix(center, uniformModel);
+	object->meshList.push_back(mesh);
+	return object;
+}
+
+void StringMeshCache::Clear()
+{
+	lookup.clear();
+	entries.clear();
+}
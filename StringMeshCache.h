@@ -0,0 +1,109 @@
+#pragma once
+#include "GlyphMeshCache.h"
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/// <summary>
+/// Cache of whole strings baked into a single mesh with the stroke font.
+/// Baked strings are kept in memory (least recently used dropped first) and written to a content-addressed
+/// store on disk, named after a hash of the string, the style and the generator version. A later run finds the
+/// file and loads it with a single read, so a hit never generates any geometry. Store files hold the mesh
+/// compressed by MeshCodec, which quantizes the positions to 16 bits. A freshly baked string goes through the same
+/// encoding before it is kept in memory, so memory hits, disk hits and misses all return the same quantized mesh.
+/// Meshes baked other ways can share the store through GetBaked.
+/// </summary>
+class StringMeshCache
+{
+	public:
+		/// <summary>
+		/// Creates an empty cache.
+		/// </summary>
+		/// <param name="glyphs">Where the glyphs of strings that have to be baked come from.</param>
+		/// <param name="directory">Folder of the on-disk store, created when the first string is written.</param>
+		/// <param name="capacity">How many strings are kept in memory.</param>
+		StringMeshCache(GlyphMeshCache* glyphs, const std::string& directory = DEFAULT_DIRECTORY, size_t capacity = DEFAULT_CAPACITY);
+		~StringMeshCache();
+
+		/// <summary>
+		/// Returns the baked mesh of a string, from memory, from disk, or baked and stored if it is in neither.
+		/// The pointer is only valid until the next call that can add to the cache.
+		/// </summary>
+		/// <param name="text">The string, laid out on a line from the origin towards +X.</param>
+		const MeshData* Get(const std::string& text, const ExtrudeStyle& style);
+
+		/// <summary>
+		/// Same as Get, for a mesh baked another way, such as the CSG union of a glyph letter.
+		/// </summary>
+		/// <param name="name">Names the bake and everything its result depends on, versions included.</param>
+		/// <param name="bake">Bakes the mesh when it is neither in memory nor on disk.</param>
+		const MeshData* GetBaked(const std::string& name, const std::function<MeshData()>& bake);
+
+		/// <summary>
+		/// Creates a complex object drawing a baked string with a single mesh, centered on the origin.
+		/// </summary>
+		/// <param name="uniformModel">The location of the Model Matrix on the GPU</param>
+		ComplexObject* CreateStringObject(const std::string& text, const ExtrudeStyle& style, GLuint uniformModel);
+
+		/// <summary>
+		/// Drops the strings kept in memory. The on-disk store is left untouched.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Where the strings were found since the cache was created.
+		/// </summary>
+		int memoryHits, diskHits, misses;
+
+		static const char* DEFAULT_DIRECTORY;
+		static const size_t DEFAULT_CAPACITY = 64;
+
+	private:
+		typedef std::list<std::pair<std::string, MeshData> > EntryList;
+
+		/// <summary>
+		/// Returns the bytes identifying a string baked with a style by the current generator.
+		/// </summary>
+		static std::string MakeKey(const std::string& text, const ExtrudeStyle& style);
+
+		/// <summary>
+		/// Returns the mesh of a key from memory, from disk, or from bake, stored then.
+		/// </summary>
+		const MeshData* Find(const std::string& key, const std::function<MeshData()>& bake);
+
+		/// <summary>
+		/// Returns the path of the store file of a key.
+		/// </summary>
+		std::string GetPath(const std::string& key);
+
+		/// <summary>
+		/// Lays the glyphs of a string out into a single mesh.
+		/// </summary>
+		MeshData Bake(const std::string& text, const ExtrudeStyle& style);
+
+		/// <summary>
+		/// Loads a baked string from the store. Returns false if it is missing, damaged or for another key.
+		/// </summary>
+		bool ReadFile(const std::string& key, MeshData& mesh);
+
+		/// <summary>
+		/// Writes a baked string to the store, already encoded by MeshCodec.
+		/// </summary>
+		void WriteFile(const std::string& key, const std::vector<unsigned char>& encoded);
+
+		/// <summary>
+		/// Adds a mesh as the most recently used one, dropping the least recently used if full.
+		/// </summary>
+		const MeshData* Insert(const std::string& key, MeshData& mesh);
+
+		GlyphMeshCache* glyphs;
+		std::string directory;
+
+		/// <summary>
+		/// Strings in memory, most recently used first.
+		/// </summary>
+		EntryList entries;
+		std::unordered_map<std::string, EntryList::iterator> lookup;
+		size_t capacity;
+};
@@ -0,0 +1,286 @@
+#include "StrokeFont.h"
+#include "CSG.h"
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+
+const float StrokeFont::GRID_UNIT = 0.75f;
+const float StrokeFont::STROKE_HALF_WIDTH = 0.35f;
+const float StrokeFont::GLYPH_SPACING = 0.75f;
+const float StrokeFont::SPACE_ADVANCE = 3.0f;
+
+/// <summary>
+/// A glyph of the stroke font. Strokes are separated by spaces, each stroke is a polyline of two digit
+/// points: the X (0 to 4) then the Y (0 to 6, from the baseline up) of the point on the font grid.
+/// </summary>
+struct StrokeGlyph
+{
+	char character;
+	const char* strokes;
+};
+
+static const StrokeGlyph STROKE_GLYPHS[] = {
+	{ 'A', "002640 1333" },
+	{ 'B', "00063645443303 3342413000" },
+	{ 'C', "4536160501103041" },
+	{ 'D', "00062644422000" },
+	{ 'E', "40000646 0333" },
+	{ 'F', "000646 0333" },
+	{ 'G', "45361605011030414323" },
+	{ 'H', "0006 4046 0343" },
+	{ 'I', "1636 1030 2026" },
+	{ 'J', "464130100102" },
+	{ 'K', "0006 4602 1340" },
+	{ 'L', "060040" },
+	{ 'M', "0006234640" },
+	{ 'N', "00064046" },
+	{ 'O', "100105163645413010" },
+	{ 'P', "00063645443303" },
+	{ 'Q', "100105163645413010 2240" },
+	{ 'R', "00063645443303 2340" },
+	{ 'S', "453616050413334241301001" },
+	{ 'T', "0646 2026" },
+	{ 'U', "060110304146" },
+	{ 'V', "062046" },
+	{ 'W', "0610233046" },
+	{ 'X', "0046 0640" },
+	{ 'Y', "0623 4623 2320" },
+	{ 'Z', "06460040" },
+	{ '0', "100105163645413010 0145" },
+	{ '1', "0426 2620 1030" },
+	{ '2', "05163645440040" },
+	{ '3', "0516364544334241301001 1333" },
+	{ '4', "30360242" },
+	{ '5', "460603334241301001" },
+	{ '6', "36160501103041423303" },
+	{ '7', "064620" },
+	{ '8', "334445361605041333 3342413010010213" },
+	{ '9', "43130405163645413010" },
+};
+
+static const int STROKE_GLYPH_COUNT = sizeof(STROKE_GLYPHS) / sizeof(STROKE_GLYPHS[0]);
+
+/// <summary>
+/// Reads the polylines of a glyph description, in grid units.
+/// </summary>
+static void ParseStrokes(const char* strokes, std::vector<std::vector<glm::vec2> >& polylines)
+{
+	polylines.clear();
+	polylines.push_back(std::vector<glm::vec2>());
+
+	for (const char* c = strokes; *c != '\0'; )
+	{
+		if (*c == ' ')
+		{
+			polylines.push_back(std::vector<glm::vec2>());
+			c++;
+			continue;
+		}
+
+		polylines.back().push_back(glm::vec2((float)(c[0] - '0'), (float)(c[1] - '0')));
+		c += 2;
+	}
+}
+
+/// <summary>
+/// Keeps the chamfer smaller than the stroke and the depth, so the front face never collapses.
+/// </summary>
+static float ClampBevel(const ExtrudeStyle& style)
+{
+	return std::max(0.0f, std::min(style.bevel, std::min(StrokeFont::STROKE_HALF_WIDTH, style.depth) * 0.9f));
+}
+
+const char* StrokeFont::FindStrokes(unsigned int codepoint)
+{
+	if (codepoint >= 128)
+		return NULL;
+
+	char character = (char)toupper((int)codepoint);
+	for (int i = 0; i < STROKE_GLYPH_COUNT; i++)
+	{
+		if (STROKE_GLYPHS[i].character == character)
+			return STROKE_GLYPHS[i].strokes;
+	}
+	return NULL;
+}
+
+bool StrokeFont::HasGlyph(unsigned int codepoint)
+{
+	return FindStrokes(codepoint) != NULL;
+}
+
+float StrokeFont::GetAdvance(unsigned int codepoint)
+{
+	const char* strokes = FindStrokes(codepoint);
+	if (strokes == NULL)
+		return SPACE_ADVANCE;
+
+	std::vector<std::vector<glm::vec2> > polylines;
+	ParseStrokes(strokes, polylines);
+
+	float minX = 1e30f, maxX = -1e30f;
+	for (int s = 0; s < polylines.size(); s++)
+	{
+		for (int p = 0; p < polylines[s].size(); p++)
+		{
+			minX = std::min(minX, polylines[s][p].x);
+			maxX = std::max(maxX, polylines[s][p].x);
+		}
+	}
+
+	return (maxX - minX) * GRID_UNIT + 2.0f * STROKE_HALF_WIDTH + GLYPH_SPACING;
+}
+
+MeshData StrokeFont::ExtrudeConvex(const std::vector<glm::vec2>& outline, const std::vector<glm::vec2>& front, const ExtrudeStyle& style)
+{
+	MeshData mesh;
+	int count = (int)outline.size();
+	float bevel = ClampBevel(style);
+
+	// Rings from the back to the front: the back edge, where the chamfer starts, then the shrunk front edge.
+	float ringZ[3] = { -style.depth / 2.0f, style.depth / 2.0f - bevel, style.depth / 2.0f };
+	int ringCount = bevel > 0.0f ? 3 : 2;
+	if (ringCount == 2)
+		ringZ[1] = ringZ[2];
+
+	for (int r = 0; r < ringCount; r++)
+	{
+		const std::vector<glm::vec2>& ring = (r == 2) ? front : outline;
+		for (int i = 0; i < count; i++)
+		{
+			mesh.vertices.push_back(ring[i].x);
+			mesh.vertices.push_back(ring[i].y);
+			mesh.vertices.push_back(ringZ[r]);
+		}
+	}
+
+	// Sides, wound so their normals point outwards of the counter-clockwise outline.
+	for (int r = 0; r + 1 < ringCount; r++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			unsigned int b0 = r * count + i;
+			unsigned int b1 = r * count + (i + 1) % count;
+			unsigned int t0 = b0 + count;
+			unsigned int t1 = b1 + count;
+
+			mesh.indices.push_back(b0);
+			mesh.indices.push_back(b1);
+			mesh.indices.push_back(t1);
+
+			mesh.indices.push_back(b0);
+			mesh.indices.push_back(t1);
+			mesh.indices.push_back(t0);
+		}
+	}
+
+	// Back cap facing -Z, front cap facing +Z.
+	unsigned int frontRing = (ringCount - 1) * count;
+	for (int i = 1; i + 1 < count; i++)
+	{
+		mesh.indices.push_back(0);
+		mesh.indices.push_back(i + 1);
+		mesh.indices.push_back(i);
+
+		mesh.indices.push_back(frontRing);
+		mesh.indices.push_back(frontRing + i);
+		mesh.indices.push_back(frontRing + i + 1);
+	}
+
+	return mesh;
+}
+
+MeshData StrokeFont::Extrude(unsigned int codepoint, const ExtrudeStyle& style)
+{
+	const char* strokes = FindStrokes(codepoint);
+	if (strokes == NULL)
+		return MeshData();
+
+	std::vector<std::vector<glm::vec2> > polylines;
+	ParseStrokes(strokes, polylines);
+
+	// Move the glyph so its left edge is on X = 0.
+	float minX = 1e30f;
+	for (int s = 0; s < polylines.size(); s++)
+	{
+		for (int p = 0; p < polylines[s].size(); p++)
+		{
+			minX = std::min(minX, polylines[s][p].x);
+		}
+	}
+	for (int s = 0; s < polylines.size(); s++)
+	{
+		for (int p = 0; p < polylines[s].size(); p++)
+		{
+			polylines[s][p] = glm::vec2((polylines[s][p].x - minX) * GRID_UNIT + STROKE_HALF_WIDTH, polylines[s][p].y * GRID_UNIT);
+		}
+	}
+
+	float bevel = ClampBevel(style);
+	std::vector<MeshData> solids;
+	std::vector<glm::vec2> outline, front;
+
+	// A round joint on every point, shared by the strokes meeting there.
+	int sides = 4 + 4 * std::max(1, style.quality);
+	float angleStep = 2.0f * glm::pi<float>() / sides;
+	// Sized so the flat sides, not the corners, line up with the edges of the segments.
+	float cornerScale = 1.0f / cosf(angleStep / 2.0f);
+	std::vector<glm::vec2> joints;
+
+	for (int s = 0; s < polylines.size(); s++)
+	{
+		for (int p = 0; p < polylines[s].size(); p++)
+		{
+			const glm::vec2& point = polylines[s][p];
+			bool seen = false;
+			for (int j = 0; j < joints.size() && !seen; j++)
+			{
+				seen = glm::length(joints[j] - point) < 1e-4f;
+			}
+			if (seen)
+				continue;
+			joints.push_back(point);
+
+			outline.clear();
+			front.clear();
+			for (int i = 0; i < sides; i++)
+			{
+				glm::vec2 direction(cosf(angleStep * (i + 0.5f)), sinf(angleStep * (i + 0.5f)));
+				outline.push_back(point + direction * (STROKE_HALF_WIDTH * cornerScale));
+				front.push_back(point + direction * ((STROKE_HALF_WIDTH - bevel) * cornerScale));
+			}
+			solids.push_back(ExtrudeConvex(outline, front, style));
+		}
+	}
+
+	// A box along every segment. Its ends are buried in the joints, so only its long sides get the chamfer.
+	for (int s = 0; s < polylines.size(); s++)
+	{
+		for (int p = 0; p + 1 < polylines[s].size(); p++)
+		{
+			glm::vec2 start = polylines[s][p];
+			glm::vec2 end = polylines[s][p + 1];
+			if (glm::length(end - start) < 1e-4f)
+				continue;
+
+			glm::vec2 direction = glm::normalize(end - start);
+			glm::vec2 normal(-direction.y, direction.x);
+
+			outline.clear();
+			outline.push_back(start - normal * STROKE_HALF_WIDTH);
+			outline.push_back(end - normal * STROKE_HALF_WIDTH);
+			outline.push_back(end + normal * STROKE_HALF_WIDTH);
+			outline.push_back(start + normal * STROKE_HALF_WIDTH);
+
+			front.clear();
+			front.push_back(start - normal * (STROKE_HALF_WIDTH - bevel));
+			front.push_back(end - normal * (STROKE_HALF_WIDTH - bevel));
+			front.push_back(end + normal * (STROKE_HALF_WIDTH - bevel));
+			front.push_back(start + normal * (STROKE_HALF_WIDTH - bevel));
+
+			solids.push_back(ExtrudeConvex(outline, front, style));
+		}
+	}
+
+	return CSG::Union(solids);
+}
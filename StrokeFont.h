@@ -0,0 +1,92 @@
+#pragma once
+#include "MeshData.h"
+#include <vector>
+
+/// <summary>
+/// How a stroke glyph is turned into a solid.
+/// </summary>
+struct ExtrudeStyle
+{
+	/// <summary>
+	/// Thickness of the glyph along Z.
+	/// </summary>
+	float depth;
+	/// <summary>
+	/// Size of the chamfer on the front edges, 0 for square edges. Clamped below the stroke half width.
+	/// </summary>
+	float bevel;
+	/// <summary>
+	/// Roundness of the stroke joints, from 1 (8 sided) upwards. Each step adds 4 sides.
+	/// </summary>
+	int quality;
+
+	bool operator==(const ExtrudeStyle& other) const
+	{
+		return depth == other.depth && bevel == other.bevel && quality == other.quality;
+	}
+};
+
+/// <summary>
+/// A vector font in the spirit of the Hershey fonts: every glyph (A-Z and 0-9) is a few polylines on a
+/// 4 x 6 grid, embedded in the binary. Glyphs are extruded by thickening every segment and joint into a
+/// convex prism and merging them with a CSG union, which gives clean letters with far fewer triangles
+/// than the sphere and cube ones.
+/// </summary>
+class StrokeFont
+{
+	public:
+		/// <summary>
+		/// Returns true if the character has a glyph. Lowercase letters use their uppercase glyph.
+		/// </summary>
+		/// <param name="codepoint">The unicode codepoint of the character.</param>
+		static bool HasGlyph(unsigned int codepoint);
+
+		/// <summary>
+		/// Returns the horizontal distance from the left edge of a glyph to the left edge of the next one.
+		/// Characters without a glyph advance like a space.
+		/// </summary>
+		static float GetAdvance(unsigned int codepoint);
+
+		/// <summary>
+		/// Builds the solid mesh of a glyph. The glyph's left edge is at X = 0, its baseline at Y = 0 and it is centered on Z.
+		/// This only works on the CPU, so it can run on any thread.
+		/// </summary>
+		/// <param name="codepoint">The unicode codepoint of the character.</param>
+		/// <param name="style">Depth, bevel and joint quality.</param>
+		/// <returns>The glyph's mesh, empty if there is no glyph for that character.</returns>
+		static MeshData Extrude(unsigned int codepoint, const ExtrudeStyle& style);
+
+		/// <summary>
+		/// Bumped whenever the font data or the extrusion changes, so meshes baked by an older version are not reused.
+		/// </summary>
+		static const int GENERATOR_VERSION = 1;
+		/// <summary>
+		/// Size of one grid step of the font. Glyphs are 6 steps tall, about the height of the GlyphLibrary letters.
+		/// </summary>
+		static const float GRID_UNIT;
+		/// <summary>
+		/// Half the width of a stroke.
+		/// </summary>
+		static const float STROKE_HALF_WIDTH;
+		/// <summary>
+		/// Horizontal distance left between two glyphs.
+		/// </summary>
+		static const float GLYPH_SPACING;
+		/// <summary>
+		/// Horizontal distance taken by a space.
+		/// </summary>
+		static const float SPACE_ADVANCE;
+
+	private:
+		/// <summary>
+		/// Returns the stroke description of a glyph, or NULL if there is none.
+		/// </summary>
+		static const char* FindStrokes(unsigned int codepoint);
+
+		/// <summary>
+		/// Extrudes a convex counter-clockwise outline along Z, chamfering its front edges.
+		/// </summary>
+		/// <param name="outline">The outline at the back and on the straight part of the sides.</param>
+		/// <param name="front">The outline of the front face, the outline shrunk by the bevel.</param>
+		static MeshData ExtrudeConvex(const std::vector<glm::vec2>& outline, const std::vector<glm::vec2>& front, const ExtrudeStyle& style);
+};
@@ -0,0 +1,315 @@
+#include "TextRenderer.h"
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+
+const float TextRenderer::LINE_HEIGHT = 7.0f;
+
+/// <summary>
+/// A pair of glyphs drawn closer (negative) or further apart than their bounds alone would give.
+/// </summary>
+struct KerningPair
+{
+	char left, right;
+	float adjust;
+};
+
+// The diagonal letters leave a lot of room on one side, the pairs below tuck their neighbour into it.
+static const KerningPair KERNING_PAIRS[] = {
+	{ 'A', 'V', -0.5f }, { 'V', 'A', -0.5f },
+	{ 'A', 'W', -0.4f }, { 'W', 'A', -0.4f },
+	{ 'A', 'Y', -0.5f }, { 'Y', 'A', -0.5f },
+	{ 'A', 'T', -0.4f }, { 'T', 'A', -0.4f },
+	{ 'L', 'T', -0.6f }, { 'L', 'V', -0.5f }, { 'L', 'Y', -0.5f }, { 'L', 'W', -0.4f },
+	{ 'F', 'A', -0.4f }, { 'P', 'A', -0.3f },
+	{ 'T', 'O', -0.2f }, { 'O', 'T', -0.2f },
+	{ 'V', 'O', -0.2f }, { 'O', 'V', -0.2f },
+	{ 'Y', 'O', -0.2f }, { 'O', 'Y', -0.2f },
+};
+
+TextRenderer::TextRenderer()
+{
+	glyphs = NULL;
+	stream = NULL;
+	loaded = false;
+	partTable = 0;
+	glyphCount = 0;
+
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		VAO[i] = 0;
+		instanceBuffer[i] = 0;
+		indexCount[i] = 0;
+		uploadedCount[i] = 0;
+		bufferCapacity[i] = 0;
+	}
+
+	penX = 0.0f;
+	penY = 0.0f;
+	previousGlyph = -1;
+}
+
+TextRenderer::~TextRenderer()
+{
+	Destroy();
+}
+
+void TextRenderer::Destroy()
+{
+	if (!loaded)
+		return;
+
+	glDeleteVertexArrays(PRIMITIVE_COUNT, VAO);
+	glDeleteBuffers(PRIMITIVE_COUNT, instanceBuffer);
+	glDeleteBuffers(1, &partTable);
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		VAO[i] = 0;
+		instanceBuffer[i] = 0;
+		uploadedCount[i] = 0;
+		bufferCapacity[i] = 0;
+	}
+	partTable = 0;
+	loaded = false;
+}
+
+void TextRenderer::Load(GlyphLibrary* glyphs, Shader* shader, StreamBuffer* stream)
+{
+	if (loaded)
+		return;
+
+	this->glyphs = glyphs;
+	this->stream = stream;
+
+	// Part table, bound once for good: the only other uniform buffer, the camera, has its own binding (see CameraBuffer).
+	std::vector<glm::mat4> parts = glyphs->GetPartMatrices();
+	if (parts.size() > MAX_PART_COUNT)
+	{
+		printf("Part table too large for the shader: %d parts, %d at most\n", (int)parts.size(), MAX_PART_COUNT);
+		parts.resize(MAX_PART_COUNT);
+	}
+	glGenBuffers(1, &partTable);
+	glBindBuffer(GL_UNIFORM_BUFFER, partTable);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::mat4) * MAX_PART_COUNT, NULL, GL_STATIC_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4) * parts.size(), glm::value_ptr(parts[0]));
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, PART_TABLE_BINDING, partTable);
+	shader->bindUniformBlock("GlyphParts", PART_TABLE_BINDING);
+
+	// One vertex array per primitive, reading the shared geometry plus its own instance buffer.
+	glGenVertexArrays(PRIMITIVE_COUNT, VAO);
+	glGenBuffers(PRIMITIVE_COUNT, instanceBuffer);
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		Mesh* mesh = glyphs->GetPrimitives()->GetMesh((PrimitiveType)i);
+		indexCount[i] = mesh->GetIndexCount();
+
+		glBindVertexArray(VAO[i]);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->GetIBO());
+
+		glBindBuffer(GL_ARRAY_BUFFER, mesh->GetVBO());
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		glEnableVertexAttribArray(0);
+
+		// Offset and part index, then the colour as normalized bytes. Both advance once per instance.
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer[i]);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TextInstance), (void*)offsetof(TextInstance, offset));
+		glEnableVertexAttribArray(2);
+		glVertexAttribDivisor(2, 1);
+		glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextInstance), (void*)offsetof(TextInstance, colour));
+		glEnableVertexAttribArray(3);
+		glVertexAttribDivisor(3, 1);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+
+	// Kerning looked up by glyph index, so laying out never searches the pair table.
+	glyphCount = glyphs->GetGlyphCount();
+	kerning.assign(glyphCount * glyphCount, 0.0f);
+	for (int i = 0; i < sizeof(KERNING_PAIRS) / sizeof(KERNING_PAIRS[0]); i++)
+	{
+		int left = glyphs->FindGlyph((unsigned char)KERNING_PAIRS[i].left);
+		int right = glyphs->FindGlyph((unsigned char)KERNING_PAIRS[i].right);
+		if (left >= 0 && right >= 0)
+			kerning[left * glyphCount + right] = KERNING_PAIRS[i].adjust;
+	}
+
+	loaded = true;
+}
+
+unsigned int TextRenderer::DecodeUTF8(const std::string& text, size_t& index)
+{
+	unsigned char c = (unsigned char)text[index++];
+	if (c < 0x80)
+		return c;
+
+	int length;
+	unsigned int codepoint;
+	if ((c & 0xe0) == 0xc0) { length = 1; codepoint = c & 0x1f; }
+	else if ((c & 0xf0) == 0xe0) { length = 2; codepoint = c & 0x0f; }
+	else if ((c & 0xf8) == 0xf0) { length = 3; codepoint = c & 0x07; }
+	else return 0xfffd;
+
+	for (int i = 0; i < length; i++)
+	{
+		if (index >= text.size() || ((unsigned char)text[index] & 0xc0) != 0x80)
+			return 0xfffd;
+		codepoint = (codepoint << 6) | ((unsigned char)text[index++] & 0x3f);
+	}
+	return codepoint;
+}
+
+float TextRenderer::GetKerning(int left, int right)
+{
+	if (left < 0 || right < 0)
+		return 0.0f;
+	return kerning[left * glyphCount + right];
+}
+
+void TextRenderer::Append(const std::string& utf8, int hex)
+{
+	GLubyte colour[4] = { (GLubyte)((hex >> 16) & 0xff), (GLubyte)((hex >> 8) & 0xff), (GLubyte)(hex & 0xff), 255 };
+
+	size_t index = 0;
+	while (index < utf8.size())
+	{
+		unsigned int codepoint = DecodeUTF8(utf8, index);
+
+		if (codepoint == '\n')
+		{
+			penX = 0.0f;
+			penY -= LINE_HEIGHT;
+			previousGlyph = -1;
+			continue;
+		}
+
+		int glyph = glyphs->FindGlyph(codepoint);
+		if (glyph < 0)
+		{
+			penX += GlyphLibrary::SPACE_ADVANCE;
+			previousGlyph = -1;
+			continue;
+		}
+
+		penX += GetKerning(previousGlyph, glyph);
+
+		// Shift the glyph so its left edge sits on the pen.
+		float x = penX - glyphs->GetMinX(glyph);
+		int first = glyphs->GetFirstPart(glyph);
+		int count = glyphs->GetPartCount(glyph);
+		for (int p = first; p < first + count; p++)
+		{
+			TextInstance instance;
+			instance.offset[0] = x;
+			instance.offset[1] = penY;
+			instance.offset[2] = 0.0f;
+			instance.part = (GLfloat)p;
+			for (int c = 0; c < 4; c++)
+				instance.colour[c] = colour[c];
+			instances[glyphs->GetPartPrimitive(p)].push_back(instance);
+		}
+
+		penX += glyphs->GetAdvance(glyph);
+		previousGlyph = glyph;
+	}
+}
+
+void TextRenderer::Clear()
+{
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		instances[i].clear();
+		uploadedCount[i] = 0;
+	}
+
+	penX = 0.0f;
+	penY = 0.0f;
+	previousGlyph = -1;
+}
+
+size_t TextRenderer::GetInstanceCount()
+{
+	size_t count = 0;
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		count += instances[i].size();
+	}
+	return count;
+}
+
+void TextRenderer::Upload(int primitive)
+{
+	std::vector<TextInstance>& list = instances[primitive];
+	if (uploadedCount[primitive] == list.size())
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer[primitive]);
+
+	if (list.size() > bufferCapacity[primitive])
+	{
+		// Grow by doubling, so a long run of appends only reallocates a handful of times.
+		size_t capacity = bufferCapacity[primitive] > 0 ? bufferCapacity[primitive] : 1024;
+		while (capacity < list.size())
+			capacity *= 2;
+
+		glBufferData(GL_ARRAY_BUFFER, sizeof(TextInstance) * capacity, NULL, GL_DYNAMIC_DRAW);
+		bufferCapacity[primitive] = capacity;
+		uploadedCount[primitive] = 0;
+	}
+
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(TextInstance) * uploadedCount[primitive],
+		sizeof(TextInstance) * (list.size() - uploadedCount[primitive]), &list[uploadedCount[primitive]]);
+	uploadedCount[primitive] = list.size();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool TextRenderer::Stream(int primitive)
+{
+	std::vector<TextInstance>& list = instances[primitive];
+	StreamSpan span = stream->Allocate(sizeof(TextInstance) * list.size(), sizeof(GLfloat));
+	if (span.data == NULL)
+		return false;
+	memcpy(span.data, list.data(), span.size);
+	stream->Commit(span);
+
+	// The instances move every frame, so do the attributes reading them.
+	glBindBuffer(GL_ARRAY_BUFFER, span.buffer);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TextInstance), (void*)(span.offset + offsetof(TextInstance, offset)));
+	glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextInstance), (void*)(span.offset + offsetof(TextInstance, colour)));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	return true;
+}
+
+void TextRenderer::Render(glm::mat4 model, GLuint uniformModel)
+{
+	if (!loaded)
+		return;
+
+	glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
+
+	for (int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		if (instances[i].empty())
+			continue;
+
+		glBindVertexArray(VAO[i]);
+		if (stream != NULL)
+		{
+			if (!Stream(i))
+			{
+				glBindVertexArray(0);
+				continue;
+			}
+		}
+		else
+		{
+			Upload(i);
+		}
+
+		glDrawElementsInstanced(GL_TRIANGLES, indexCount[i], GL_UNSIGNED_INT, 0, (GLsizei)instances[i].size());
+		glBindVertexArray(0);
+	}
+}
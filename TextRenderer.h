@@ -0,0 +1,131 @@
+#pragma once
+#include "GlyphLibrary.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+#include <string>
+#include <vector>
+
+/// <summary>
+/// One glyph part drawn by an instanced call. Its placement matrix is looked up in the part table
+/// uploaded once to the GlyphParts uniform block, so a part only costs 20 bytes on the GPU.
+/// </summary>
+struct TextInstance
+{
+	GLfloat offset[3]; // Position of the glyph in the text
+	GLfloat part;      // Index of the part in the part table
+	GLubyte colour[4];
+};
+
+/// <summary>
+/// Lays out and draws large amounts of text with one instanced draw call per primitive type.
+/// Appending text only lays out and uploads the new glyphs; everything already written stays on the GPU.
+/// Text cleared and written again every frame (counters, labels following objects) is better loaded with a
+/// StreamBuffer: its instances are then written into the ring each frame, and never overwrite the ones a previous
+/// frame still draws from.
+/// </summary>
+class TextRenderer
+{
+	public:
+		TextRenderer();
+		~TextRenderer();
+
+		/// <summary>
+		/// Uploads the part table and creates the instance buffers. Does nothing if already loaded.
+		/// </summary>
+		/// <param name="glyphs">The glyphs to draw with, already loaded.</param>
+		/// <param name="shader">The shader the text is drawn with, built with SHADER_INSTANCED. Its GlyphParts block gets bound to the part table.</param>
+		/// <param name="stream">If given, the instances are written into it each frame instead of kept on the GPU.</param>
+		void Load(GlyphLibrary* glyphs, Shader* shader, StreamBuffer* stream = NULL);
+
+		/// <summary>
+		/// Deletes the part table and the instance buffers. The text is kept, Load uploads it again.
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Lays out text after the text already written. '\n' starts a new line, characters without a glyph are drawn as spaces.
+		/// </summary>
+		/// <param name="utf8">The text to add, in UTF-8.</param>
+		/// <param name="hex">The colour of the added text, as a hex colour code.</param>
+		void Append(const std::string& utf8, int hex);
+
+		/// <summary>
+		/// Removes all the text. The buffers are kept to be reused.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Uploads the glyphs appended since the last call and draws the whole text.
+		/// </summary>
+		/// <param name="model">The model matrix to apply to the whole text.</param>
+		/// <param name="uniformModel">The location of the Model Matrix on the GPU</param>
+		/// <remarks>The shader given to Load must be in use.</remarks>
+		void Render(glm::mat4 model, GLuint uniformModel);
+
+		/// <summary>
+		/// Returns the number of glyph parts currently laid out.
+		/// </summary>
+		size_t GetInstanceCount();
+
+		/// <summary>
+		/// Vertical distance between two lines.
+		/// </summary>
+		static const float LINE_HEIGHT;
+		/// <summary>
+		/// Uniform buffer binding point of the part table.
+		/// </summary>
+		static const GLuint PART_TABLE_BINDING = 0;
+		/// <summary>
+		/// Size of the part table in the vertex shader.
+		/// </summary>
+		static const int MAX_PART_COUNT = 256;
+
+	private:
+		/// <summary>
+		/// Decodes the codepoint starting at index and moves index past it. Malformed sequences give U+FFFD.
+		/// </summary>
+		static unsigned int DecodeUTF8(const std::string& text, size_t& index);
+
+		/// <summary>
+		/// Returns the horizontal adjustment between two glyphs, from the kerning pair table.
+		/// </summary>
+		float GetKerning(int left, int right);
+
+		/// <summary>
+		/// Sends the instances not yet on the GPU, growing the buffer when needed.
+		/// </summary>
+		void Upload(int primitive);
+
+		/// <summary>
+		/// Writes all the instances into the stream buffer and points the vertex array at them.
+		/// </summary>
+		/// <returns>False if the stream buffer could not give the memory.</returns>
+		bool Stream(int primitive);
+
+		GlyphLibrary* glyphs;
+		StreamBuffer* stream;
+		bool loaded;
+
+		GLuint partTable;
+		GLuint VAO[PRIMITIVE_COUNT], instanceBuffer[PRIMITIVE_COUNT];
+		GLsizei indexCount[PRIMITIVE_COUNT];
+
+		/// <summary>
+		/// Instances of each primitive type, and how many of them are already on the GPU.
+		/// </summary>
+		std::vector<TextInstance> instances[PRIMITIVE_COUNT];
+		size_t uploadedCount[PRIMITIVE_COUNT];
+		size_t bufferCapacity[PRIMITIVE_COUNT];
+
+		/// <summary>
+		/// Adjustment for each pair of glyphs, glyphCount * glyphCount.
+		/// </summary>
+		std::vector<float> kerning;
+		int glyphCount;
+
+		/// <summary>
+		/// Where the next glyph goes, and the glyph before it (-1 at the start of a line or after a space).
+		/// </summary>
+		float penX, penY;
+		int previousGlyph;
+};
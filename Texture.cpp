@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "CookedTexture.h"
 
 
 
@@ -33,8 +34,27 @@ GLuint Texture::getTextureID() {
 	return textureID;
 }
 
+char* Texture::getFileLocation() {
+	return fileLocation;
+}
+
 void Texture::loadTexture() {
 
+	// A cooked version of the image comes with its mipmaps, and maybe compressed, see TextureCooker
+	CookedTexture cooked;
+	if (cooked.Open(CookedTexture::GetCookedPath(fileLocation))) {
+		width = cooked.GetWidth();
+		height = cooked.GetHeight();
+		bitDepth = 4;
+
+		glGenTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		setParameters();
+		cooked.Upload();
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return;
+	}
+
 	// Load in image
 	unsigned char* textureData = stbi_load(fileLocation, &width, &height, &bitDepth, 0);
 
@@ -49,6 +69,20 @@ void Texture::loadTexture() {
 	glGenTextures(1, &textureID);
 	glBindTexture(GL_TEXTURE_2D, textureID);
 
+	setParameters();
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, textureData);
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	// Unbind and free
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	stbi_image_free(textureData);
+
+}
+
+void Texture::setParameters() {
+
 	// Set parameters of the texture
 
 	glTexParameteri(GL_TEXTURE_2D,
@@ -61,10 +95,10 @@ void Texture::loadTexture() {
 		GL_REPEAT // Wrap by repeating the texture
 	);
 
-	// Set filter to linear (as opposed to 'near')
+	// Set filter to linear (as opposed to 'near'), blending the two closest mipmaps when minified
 	glTexParameteri(GL_TEXTURE_2D,
 		GL_TEXTURE_MIN_FILTER,
-		GL_NEAREST
+		GL_LINEAR_MIPMAP_LINEAR
 	);
 
 	glTexParameteri(GL_TEXTURE_2D,
@@ -72,14 +106,6 @@ void Texture::loadTexture() {
 		GL_LINEAR
 	);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, textureData);
-	glGenerateMipmap(GL_TEXTURE_2D);
-
-	// Unbind and free
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-	stbi_image_free(textureData);
-
 }
 
 void Texture::useTexture() {
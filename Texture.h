@@ -12,6 +12,7 @@ public:
 	~Texture();
 
 	GLuint getTextureID();
+	char* getFileLocation();
 
 	void loadTexture();
 	void useTexture();
@@ -22,5 +23,7 @@ private:
 	int width, height, bitDepth;
 
 	char* fileLocation;
+
+	void setParameters();
 };
 
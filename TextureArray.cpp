@@ -0,0 +1,161 @@
+#include "TextureArray.h"
+#include "CookedTexture.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cstdio>
+
+TextureArray::TextureArray()
+{
+	textureID = 0;
+	width = 0;
+	height = 0;
+}
+
+TextureArray::~TextureArray()
+{
+	Clear();
+}
+
+int TextureArray::AddLayer(const std::string& path)
+{
+	for (int i = 0; i < paths.size(); i++)
+	{
+		if (paths[i] == path)
+			return i;
+	}
+	paths.push_back(path);
+	return (int)paths.size() - 1;
+}
+
+bool TextureArray::Build()
+{
+	if (paths.empty())
+		return false;
+
+	GLint maxLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+	if ((GLint)paths.size() > maxLayers)
+	{
+		printf("Too many layers for a texture array: %d layers, %d at most\n", (int)paths.size(), maxLayers);
+		return false;
+	}
+
+	if (BuildCooked())
+		return true;
+
+	// Every layer is loaded as RGBA, so they all share one format whatever the files hold.
+	std::vector<unsigned char*> images(paths.size(), NULL);
+	std::vector<int> widths(paths.size(), 0), heights(paths.size(), 0);
+	for (int i = 0; i < paths.size(); i++)
+	{
+		int channels = 0;
+		images[i] = stbi_load(paths[i].c_str(), &widths[i], &heights[i], &channels, 4);
+		if (images[i] == NULL)
+		{
+			printf("Failed to load texture %s\n", paths[i].c_str());
+		}
+		else if (width == 0)
+		{
+			width = widths[i];
+			height = heights[i];
+		}
+	}
+
+	if (width == 0)
+		return false;
+
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, (GLsizei)paths.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	std::vector<unsigned char> layer((size_t)width * height * 4);
+	for (int i = 0; i < paths.size(); i++)
+	{
+		if (images[i] == NULL)
+		{
+			std::fill(layer.begin(), layer.end(), 255);
+		}
+		else
+		{
+			// Nearest sample of the image at the size of the array, a plain copy when the sizes match.
+			for (int y = 0; y < height; y++)
+			{
+				int sourceY = (int)((long long)y * heights[i] / height);
+				for (int x = 0; x < width; x++)
+				{
+					int sourceX = (int)((long long)x * widths[i] / width);
+					const unsigned char* source = images[i] + ((size_t)sourceY * widths[i] + sourceX) * 4;
+					unsigned char* destination = &layer[((size_t)y * width + x) * 4];
+					destination[0] = source[0];
+					destination[1] = source[1];
+					destination[2] = source[2];
+					destination[3] = source[3];
+				}
+			}
+			stbi_image_free(images[i]);
+		}
+
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, layer.data());
+	}
+
+	// Same parameters as Texture
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	return true;
+}
+
+bool TextureArray::BuildCooked()
+{
+	// Cooked layers are uploaded as they are, so they must all have been cooked to the same size and format.
+	std::vector<CookedTexture> layers(paths.size());
+	for (int i = 0; i < paths.size(); i++)
+	{
+		if (!layers[i].Open(CookedTexture::GetCookedPath(paths[i])))
+			return false;
+		if (layers[i].GetWidth() != layers[0].GetWidth() || layers[i].GetHeight() != layers[0].GetHeight()
+			|| layers[i].GetFormat() != layers[0].GetFormat() || layers[i].GetLevelCount() != layers[0].GetLevelCount())
+		{
+			printf("Cooked layers of a texture array differ, %s is loaded from the images\n", paths[i].c_str());
+			return false;
+		}
+	}
+
+	width = layers[0].GetWidth();
+	height = layers[0].GetHeight();
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+	layers[0].AllocateArray((GLsizei)paths.size());
+	for (int i = 0; i < paths.size(); i++)
+		layers[i].UploadLayer(i);
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	return true;
+}
+
+void TextureArray::Bind(GLuint unit)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+}
+
+void TextureArray::Clear()
+{
+	if (textureID != 0)
+	{
+		glDeleteTextures(1, &textureID);
+		textureID = 0;
+	}
+	paths.clear();
+	width = 0;
+	height = 0;
+}
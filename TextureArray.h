@@ -0,0 +1,63 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Several textures packed into the layers of one GL_TEXTURE_2D_ARRAY, so objects with different textures are drawn
+/// without binding anything in between: the array is bound once, and each draw only says which layer it samples.
+/// The layer is read from the vertex attribute LAYER_ATTRIBUTE, a constant set per object (see
+/// ComplexObject::SetTextureLayer), or an instance attribute when drawing many objects at once.
+/// Every layer is stored as RGBA at the size of the first image, the other images are resampled to it. When every
+/// image has a cooked version of the same size and format (see TextureCooker), those are uploaded instead.
+/// Drawn with the SHADER_TEXTURE_ARRAY variants, which sample theTextures.
+/// </summary>
+class TextureArray
+{
+	public:
+		TextureArray();
+		~TextureArray();
+
+		/// <summary>
+		/// Adds an image file as a layer, loaded by Build. Adding a file again gives the layer it already has.
+		/// </summary>
+		/// <returns>The index of the layer.</returns>
+		int AddLayer(const std::string& path);
+
+		/// <summary>
+		/// Loads every image and uploads them into the texture array, with mipmaps. An image that cannot be loaded is
+		/// replaced by a white layer.
+		/// </summary>
+		/// <returns>False if nothing could be uploaded.</returns>
+		bool Build();
+
+		/// <summary>
+		/// Binds the texture array to a texture unit.
+		/// </summary>
+		void Bind(GLuint unit = 0);
+
+		/// <summary>
+		/// Clears the texture array from the GPU and forgets its layers.
+		/// </summary>
+		void Clear();
+
+		GLuint GetTextureID() { return textureID; }
+		int GetLayerCount() { return (int)paths.size(); }
+		const std::vector<std::string>& GetPaths() { return paths; }
+
+		/// <summary>
+		/// The vertex attribute the shaders read the layer from.
+		/// </summary>
+		static const GLuint LAYER_ATTRIBUTE = 4;
+
+	private:
+		/// <summary>
+		/// Uploads the cooked versions of the images, with their mipmaps.
+		/// </summary>
+		/// <returns>False if an image has no cooked version, or not like the others.</returns>
+		bool BuildCooked();
+
+		std::vector<std::string> paths; // One per layer
+		GLuint textureID;
+		int width, height;
+};
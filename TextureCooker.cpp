@@ -0,0 +1,138 @@
+#include "TextureCooker.h"
+#include "BlockCompression.h"
+#include "stb_image.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURE_COOKER_SSE2
+#endif
+
+void TextureCooker::Downsample(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& output)
+{
+	int outputWidth = width > 1 ? width / 2 : 1;
+	int outputHeight = height > 1 ? height / 2 : 1;
+	output.resize((size_t)outputWidth * outputHeight * 4);
+
+	for (int y = 0; y < outputHeight; y++)
+	{
+		const unsigned char* top = rgba + (size_t)(y * 2) * width * 4;
+		const unsigned char* bottom = rgba + (size_t)(y * 2 + 1 < height ? y * 2 + 1 : height - 1) * width * 4;
+		unsigned char* destination = &output[(size_t)y * outputWidth * 4];
+		int x = 0;
+
+#ifdef TEXTURE_COOKER_SSE2
+		// 4 pixels out of 8, the rows averaged first, then the even pixels with the odd ones.
+		for (; x + 4 <= outputWidth && x * 2 + 8 <= width; x += 4)
+		{
+			__m128i row0 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(top + x * 8)), _mm_loadu_si128((const __m128i*)(bottom + x * 8)));
+			__m128i row1 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(top + x * 8 + 16)), _mm_loadu_si128((const __m128i*)(bottom + x * 8 + 16)));
+			__m128 even = _mm_shuffle_ps(_mm_castsi128_ps(row0), _mm_castsi128_ps(row1), _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(row0), _mm_castsi128_ps(row1), _MM_SHUFFLE(3, 1, 3, 1));
+			_mm_storeu_si128((__m128i*)(destination + x * 4), _mm_avg_epu8(_mm_castps_si128(even), _mm_castps_si128(odd)));
+		}
+#endif
+
+		for (; x < outputWidth; x++)
+		{
+			int left = x * 2 * 4;
+			int right = (x * 2 + 1 < width ? x * 2 + 1 : width - 1) * 4;
+			for (int c = 0; c < 4; c++)
+				destination[x * 4 + c] = (unsigned char)((top[left + c] + top[right + c] + bottom[left + c] + bottom[right + c] + 2) / 4);
+		}
+	}
+}
+
+CookedFormat TextureCooker::ChooseFormat(const unsigned char* rgba, int width, int height)
+{
+	size_t pixelCount = (size_t)width * height;
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		if (rgba[i * 4 + 3] != 255)
+			return COOKED_BC3;
+	}
+	return COOKED_BC1;
+}
+
+void TextureCooker::Cook(const unsigned char* rgba, int width, int height, CookedFormat format, std::vector<unsigned char>& file)
+{
+	int levelCount = 1;
+	for (int w = width, h = height; (w > 1 || h > 1) && levelCount < CookedTexture::MAX_LEVELS; levelCount++)
+	{
+		w = w > 1 ? w / 2 : 1;
+		h = h > 1 ? h / 2 : 1;
+	}
+
+	size_t tableEnd = sizeof(CookedTextureHeader) + levelCount * sizeof(CookedTextureLevel);
+	file.assign((tableEnd + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT, 0);
+
+	CookedTextureHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "CTEX", 4);
+	header.version = CookedTexture::VERSION;
+	header.format = format;
+	header.width = width;
+	header.height = height;
+	header.levelCount = levelCount;
+	memcpy(file.data(), &header, sizeof(header));
+
+	std::vector<unsigned char> current(rgba, rgba + (size_t)width * height * 4);
+	std::vector<unsigned char> next;
+	for (int i = 0; i < levelCount; i++)
+	{
+		CookedTextureLevel level;
+		level.offset = (unsigned int)file.size();
+		level.width = width;
+		level.height = height;
+		if (format == COOKED_RGBA8)
+		{
+			level.size = (unsigned int)current.size();
+			file.insert(file.end(), current.begin(), current.end());
+		}
+		else
+		{
+			level.size = (unsigned int)BlockCompression::GetCompressedSize(width, height, format == COOKED_BC3);
+			file.resize(file.size() + level.size);
+			BlockCompression::Encode(current.data(), width, height, format == COOKED_BC3, &file[level.offset]);
+		}
+		file.resize((file.size() + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT, 0);
+		memcpy(&file[sizeof(CookedTextureHeader) + i * sizeof(CookedTextureLevel)], &level, sizeof(level));
+
+		// Each level is filtered from the previous one, never from a compressed one.
+		if (i + 1 < levelCount)
+		{
+			Downsample(current.data(), width, height, next);
+			current.swap(next);
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+	}
+}
+
+bool TextureCooker::CookFile(const std::string& imagePath, const std::string& cookedPath, CookedFormat format, bool automatic)
+{
+	int width = 0, height = 0, channels = 0;
+	unsigned char* rgba = stbi_load(imagePath.c_str(), &width, &height, &channels, 4);
+	if (rgba == NULL)
+	{
+		printf("Failed to load texture %s\n", imagePath.c_str());
+		return false;
+	}
+
+	std::vector<unsigned char> file;
+	Cook(rgba, width, height, automatic ? ChooseFormat(rgba, width, height) : format, file);
+	stbi_image_free(rgba);
+
+	FILE* output = fopen(cookedPath.c_str(), "wb");
+	if (output == NULL)
+	{
+		printf("Failed to write %s\n", cookedPath.c_str());
+		return false;
+	}
+	bool written = fwrite(file.data(), 1, file.size(), output) == file.size();
+	fclose(output);
+	if (!written)
+		printf("Failed to write %s\n", cookedPath.c_str());
+	return written;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "CookedTexture.h"
+
+/// <summary>
+/// Offline side of CookedTexture: turns an image into a cooked texture file with its whole mipmap chain, so the
+/// application neither decodes images nor generates mipmaps when it loads them.
+/// Each level halves the previous one with a 2x2 box filter, vectorised with SSE2 when the compiler targets it, the
+/// last row or column being repeated for odd sizes. Levels are then block compressed by BlockCompression, or kept RGBA.
+/// Used by tools/CookTextures.
+/// </summary>
+class TextureCooker
+{
+	public:
+		/// <summary>
+		/// Cooks an image.
+		/// </summary>
+		/// <param name="rgba">The pixels, 4 bytes each, row after row.</param>
+		/// <param name="file">Receives the contents of the cooked texture file.</param>
+		static void Cook(const unsigned char* rgba, int width, int height, CookedFormat format, std::vector<unsigned char>& file);
+
+		/// <summary>
+		/// Loads an image file, cooks it and writes the cooked texture file.
+		/// </summary>
+		/// <param name="automatic">If true, the format is chosen from the image, ignoring format.</param>
+		/// <returns>False if the image cannot be loaded or the file cannot be written.</returns>
+		static bool CookFile(const std::string& imagePath, const std::string& cookedPath, CookedFormat format, bool automatic = false);
+
+		/// <summary>
+		/// Returns the format an image is best cooked to: BC3 if any of its pixels is transparent, BC1 otherwise.
+		/// </summary>
+		static CookedFormat ChooseFormat(const unsigned char* rgba, int width, int height);
+
+		/// <summary>
+		/// Halves an image, averaging each 2x2 square of pixels. A side of 1 pixel stays 1.
+		/// </summary>
+		/// <param name="output">Receives the pixels of the smaller image.</param>
+		static void Downsample(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& output);
+
+		static const int LEVEL_ALIGNMENT = 16; // Of every level in the file
+};
@@ -0,0 +1,271 @@
+#include "TextureStreamer.h"
+#include "Redraw.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+TextureStreamer::TextureStreamer(size_t budget)
+{
+	this->budget = budget;
+	residentBytes = 0;
+	frame = 0;
+	peakResidentBytes = 0;
+	evictions = 0;
+	streamIns = 0;
+	totalLatency = 0.0;
+	maxLatency = 0.0;
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	Clear();
+}
+
+int TextureStreamer::Add(const std::string& imagePath)
+{
+	return AddTexture(GL_TEXTURE_2D, std::vector<std::string>(1, imagePath));
+}
+
+int TextureStreamer::AddArray(const std::vector<std::string>& imagePaths)
+{
+	if (imagePaths.empty())
+		return -1;
+	return AddTexture(GL_TEXTURE_2D_ARRAY, imagePaths);
+}
+
+int TextureStreamer::AddTexture(GLenum target, const std::vector<std::string>& imagePaths)
+{
+	StreamedTexture* texture = new StreamedTexture();
+	texture->target = target;
+	texture->layers = std::vector<CookedTexture>(imagePaths.size());
+	for (int i = 0; i < imagePaths.size(); i++)
+	{
+		CookedTexture& layer = texture->layers[i];
+		CookedTexture& first = texture->layers[0];
+		if (!layer.Open(CookedTexture::GetCookedPath(imagePaths[i])) || layer.GetWidth() != first.GetWidth() || layer.GetHeight() != first.GetHeight()
+			|| layer.GetFormat() != first.GetFormat() || layer.GetLevelCount() != first.GetLevelCount())
+		{
+			delete texture;
+			return -1;
+		}
+	}
+
+	CookedTexture& first = texture->layers[0];
+	texture->textureID = 0;
+	texture->levelCount = first.GetLevelCount();
+	texture->tailLevel = 0;
+	while (texture->tailLevel < texture->levelCount - 1 && std::max(first.GetWidth() >> texture->tailLevel, first.GetHeight() >> texture->tailLevel) > TAIL_SIZE)
+		texture->tailLevel++;
+	texture->residentLevel = texture->levelCount;
+	texture->requiredLevel = texture->tailLevel;
+	texture->requestedSize = 0.0f;
+	texture->lastUsedFrame = 0;
+	texture->waiting = false;
+	texture->waitStart = 0.0;
+	SetResidentLevel(*texture, texture->tailLevel);
+
+	textures.push_back(texture);
+	order.reserve(textures.size());
+	return (int)textures.size() - 1;
+}
+
+size_t TextureStreamer::GetSize(StreamedTexture& texture, int firstLevel)
+{
+	size_t size = 0;
+	for (int i = firstLevel; i < texture.levelCount; i++)
+		size += texture.layers[0].GetResidentSize(i);
+	return size * texture.layers.size();
+}
+
+void TextureStreamer::SetResidentLevel(StreamedTexture& texture, int level)
+{
+	GLuint textureID;
+	glGenTextures(1, &textureID);
+	glBindTexture(texture.target, textureID);
+	if (texture.target == GL_TEXTURE_2D)
+	{
+		texture.layers[0].Upload(level);
+	}
+	else
+	{
+		texture.layers[0].AllocateArray((int)texture.layers.size(), level);
+		for (int i = 0; i < texture.layers.size(); i++)
+			texture.layers[i].UploadLayer(i, level);
+	}
+
+	// Same parameters as Texture
+	glTexParameteri(texture.target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(texture.target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(texture.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(texture.target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(texture.target, 0);
+
+	if (texture.textureID != 0)
+		glDeleteTextures(1, &texture.textureID);
+	residentBytes -= GetSize(texture, texture.residentLevel);
+	texture.textureID = textureID;
+	texture.residentLevel = level;
+	residentBytes += GetSize(texture, level);
+	peakResidentBytes = std::max(peakResidentBytes, residentBytes);
+}
+
+void TextureStreamer::Request(int handle, float screenSize)
+{
+	StreamedTexture* texture = textures[handle];
+	if (texture->lastUsedFrame != frame)
+		texture->requestedSize = 0.0f;
+	texture->requestedSize = std::max(texture->requestedSize, screenSize);
+	texture->lastUsedFrame = frame;
+}
+
+bool TextureStreamer::EvictOne(StreamedTexture* keep)
+{
+	// Textures drawn this frame only give up the levels they do not need, so they do not fight for the memory.
+	StreamedTexture* victim = NULL;
+	for (int i = 0; i < textures.size(); i++)
+	{
+		StreamedTexture* texture = textures[i];
+		if (texture == keep || texture->residentLevel >= texture->tailLevel)
+			continue;
+		if (texture->lastUsedFrame == frame && texture->residentLevel >= texture->requiredLevel)
+			continue;
+		if (victim == NULL || texture->lastUsedFrame < victim->lastUsedFrame
+			|| (texture->lastUsedFrame == victim->lastUsedFrame && texture->residentLevel < victim->residentLevel))
+			victim = texture;
+	}
+
+	if (victim == NULL)
+		return false;
+	SetResidentLevel(*victim, victim->residentLevel + 1);
+	evictions++;
+	return true;
+}
+
+void TextureStreamer::Update()
+{
+	double now = GetMilliseconds();
+	for (int i = 0; i < textures.size(); i++)
+	{
+		StreamedTexture* texture = textures[i];
+		if (texture->lastUsedFrame == frame)
+		{
+			// The finest level is needed when its texels are no larger than the pixels, the next one up to twice larger...
+			int level = texture->tailLevel;
+			if (texture->requestedSize > 0.0f)
+			{
+				float ratio = (float)texture->layers[0].GetWidth() / texture->requestedSize;
+				level = ratio <= 1.0f ? 0 : (int)std::floor(std::log2(ratio));
+			}
+			texture->requiredLevel = std::min(level, texture->tailLevel);
+		}
+		else if (frame - texture->lastUsedFrame > FRAMES_BEFORE_UNUSED)
+		{
+			texture->requiredLevel = texture->tailLevel;
+		}
+
+		if (texture->requiredLevel < texture->residentLevel && !texture->waiting)
+		{
+			texture->waiting = true;
+			texture->waitStart = now;
+		}
+	}
+
+	// A smaller budget than what is resident gives memory back before anything streams in.
+	while (residentBytes > budget && EvictOne(NULL))
+	{
+	}
+
+	// Textures needing finer levels first, so the closest ones sharpen first.
+	order.assign(textures.begin(), textures.end());
+	std::sort(order.begin(), order.end(), [](const StreamedTexture* a, const StreamedTexture* b)
+	{
+		return a->requiredLevel < b->requiredLevel;
+	});
+
+	size_t uploaded = 0;
+	for (int i = 0; i < order.size(); i++)
+	{
+		StreamedTexture& texture = *order[i];
+		if (texture.requiredLevel >= texture.residentLevel)
+			continue;
+
+		// The texture is uploaded again whole, a frame streams at least one level of it, more if it fits.
+		int level = texture.requiredLevel;
+		while (level < texture.residentLevel - 1 && uploaded + GetSize(texture, level) > UPLOAD_BYTES_PER_FRAME)
+			level++;
+		if (uploaded > 0 && uploaded + GetSize(texture, level) > UPLOAD_BYTES_PER_FRAME)
+			break;
+
+		size_t extra = GetSize(texture, level) - GetSize(texture, texture.residentLevel);
+		while (residentBytes + extra > budget && EvictOne(&texture))
+		{
+		}
+		while (level < texture.residentLevel && residentBytes + GetSize(texture, level) - GetSize(texture, texture.residentLevel) > budget)
+			level++;
+		if (level == texture.residentLevel)
+			continue;
+
+		SetResidentLevel(texture, level);
+		uploaded += GetSize(texture, level);
+	}
+
+	now = GetMilliseconds();
+	for (int i = 0; i < textures.size(); i++)
+	{
+		StreamedTexture* texture = textures[i];
+		if (texture->waiting && texture->residentLevel > texture->requiredLevel)
+			Redraw::Request(); // The next frames stream the rest in
+		if (texture->waiting && texture->residentLevel <= texture->requiredLevel)
+		{
+			double latency = now - texture->waitStart;
+			texture->waiting = false;
+			streamIns++;
+			totalLatency += latency;
+			maxLatency = std::max(maxLatency, latency);
+		}
+	}
+
+	frame++;
+}
+
+void TextureStreamer::Bind(int handle, GLuint unit)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(textures[handle]->target, textures[handle]->textureID);
+}
+
+void TextureStreamer::Clear()
+{
+	for (int i = 0; i < textures.size(); i++)
+	{
+		if (textures[i]->textureID != 0)
+			glDeleteTextures(1, &textures[i]->textureID);
+		delete textures[i];
+	}
+	textures.clear();
+	order.clear();
+	residentBytes = 0;
+}
+
+void TextureStreamer::PrintStatistics()
+{
+	printf("Texture streaming: %.1f of %.1f MB resident (%.1f MB at most), %d levels evicted, %d stream-ins waited %.1f ms on average, %.1f ms at most\n",
+		residentBytes / 1048576.0, budget / 1048576.0, peakResidentBytes / 1048576.0, evictions,
+		streamIns, streamIns > 0 ? totalLatency / streamIns : 0.0, maxLatency);
+}
+
+float TextureStreamer::GetScreenSize(const glm::mat4& view, const glm::mat4& projection, glm::vec3 centre, float radius, float viewHeight)
+{
+	// Perspective projections scale by projection[1][1] / distance, the camera inside the sphere sees it whole.
+	float distance = -(view * glm::vec4(centre, 1.0f)).z;
+	if (distance <= radius)
+		return std::numeric_limits<float>::max();
+	return radius * projection[1][1] / distance * viewHeight;
+}
+
+double TextureStreamer::GetMilliseconds()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "CookedTexture.h"
+
+/// <summary>
+/// Keeps cooked textures (see TextureCooker) resident on the GPU only at the resolution they are seen at, within a
+/// memory budget. Every frame, each texture drawn is requested with its size on screen. That size gives the finest level
+/// it needs. Update then streams levels in from the mapped files, finest needs first. When the budget is reached, the
+/// least recently used textures give up their finest levels.
+/// A texture changes resolution by being uploaded again into a new texture object holding only its resident levels,
+/// so evicted levels really free their memory. Its ID therefore changes, and it is bound through Bind each frame.
+/// The smallest levels, up to TAIL_SIZE pixels, are always resident, so every texture can be drawn.
+/// Update takes no heap allocation, it runs in the frame loop.
+/// </summary>
+class TextureStreamer
+{
+	public:
+		/// <param name="budget">The bytes all the textures may take on the GPU.</param>
+		TextureStreamer(size_t budget = DEFAULT_BUDGET);
+		~TextureStreamer();
+
+		/// <summary>
+		/// Adds the cooked version of an image as a GL_TEXTURE_2D.
+		/// </summary>
+		/// <returns>The handle of the texture, or -1 if the image has no cooked version.</returns>
+		int Add(const std::string& imagePath);
+
+		/// <summary>
+		/// Adds the cooked versions of images as the layers of a GL_TEXTURE_2D_ARRAY, streamed as one texture.
+		/// </summary>
+		/// <returns>The handle of the texture, or -1 if an image has no cooked version, or not the size and format of the first.</returns>
+		int AddArray(const std::vector<std::string>& imagePaths);
+
+		/// <summary>
+		/// Says a texture is drawn this frame, covering a number of pixels on screen. A texture requested several
+		/// times in a frame needs the largest size.
+		/// </summary>
+		/// <param name="screenSize">The width on screen of the whole texture, in pixels.</param>
+		void Request(int handle, float screenSize);
+
+		/// <summary>
+		/// Streams the requested levels in and evicts levels to stay within the budget. Called once a frame, after
+		/// the requests and before drawing.
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Binds a texture to a texture unit, at the levels it has now.
+		/// </summary>
+		void Bind(int handle, GLuint unit = 0);
+
+		/// <summary>
+		/// Deletes every texture from the GPU and unmaps their files.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Prints the budget use, the evictions and the time textures waited for their levels.
+		/// </summary>
+		void PrintStatistics();
+
+		size_t GetBudget() { return budget; }
+		size_t GetResidentBytes() { return residentBytes; }
+		GLuint GetTextureID(int handle) { return textures[handle]->textureID; }
+
+		/// <summary>
+		/// Returns the width on screen, in pixels, of a sphere seen by a camera.
+		/// </summary>
+		/// <param name="viewHeight">The height of the viewport in pixels.</param>
+		static float GetScreenSize(const glm::mat4& view, const glm::mat4& projection, glm::vec3 centre, float radius, float viewHeight);
+
+		static const size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+		static const size_t UPLOAD_BYTES_PER_FRAME = 4 * 1024 * 1024; // Streamed in at most each frame, past the first level
+		static const int TAIL_SIZE = 64; // Levels this size or smaller are never evicted
+		static const int FRAMES_BEFORE_UNUSED = 60; // A texture not requested for so long only keeps its tail
+
+	private:
+		struct StreamedTexture
+		{
+			GLenum target; // GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY
+			std::vector<CookedTexture> layers;
+			GLuint textureID;
+			int levelCount;
+			int tailLevel; // The largest level always resident
+			int residentLevel; // The largest level resident
+			int requiredLevel; // The largest level the requests of the last frame need
+			float requestedSize; // Largest size requested this frame
+			unsigned long long lastUsedFrame;
+			bool waiting; // True while some required level is not resident
+			double waitStart; // Milliseconds, when it started waiting
+		};
+
+		/// <summary>
+		/// Opens the cooked files of a texture and uploads its tail.
+		/// </summary>
+		int AddTexture(GLenum target, const std::vector<std::string>& imagePaths);
+
+		/// <summary>
+		/// Returns the bytes the levels of a texture from a given one take on the GPU.
+		/// </summary>
+		size_t GetSize(StreamedTexture& texture, int firstLevel);
+
+		/// <summary>
+		/// Uploads a texture again into a new texture object, from a given level.
+		/// </summary>
+		void SetResidentLevel(StreamedTexture& texture, int level);
+
+		/// <summary>
+		/// Frees memory by dropping the finest level of the least recently used texture that can give one up,
+		/// never from the texture being streamed in.
+		/// </summary>
+		/// <returns>False if no texture can give up a level.</returns>
+		bool EvictOne(StreamedTexture* keep);
+
+		/// <summary>
+		/// Returns the time in milliseconds, from an arbitrary start.
+		/// </summary>
+		static double GetMilliseconds();
+
+		std::vector<StreamedTexture*> textures;
+		std::vector<StreamedTexture*> order; // Scratch for sorting in Update, as large as textures
+		size_t budget;
+		size_t residentBytes;
+		unsigned long long frame;
+
+		// Statistics
+		size_t peakResidentBytes;
+		int evictions; // Levels evicted
+		int streamIns; // Waits ended by streaming the levels in
+		double totalLatency, maxLatency; // Milliseconds textures waited for their levels
+};
@@ -1,27 +1,37 @@
 #include "Window.h"
+#include "Redraw.h"
 
 Window::Window()
 {
 	width = 1024;
 	height = 768;
-	deltaX = 0.0f;
-	deltaY = 0.0f;
-
-	for (int i = 0; i < 1024; i++) {
-		keys[i] = 0;
-	}
+	initialiseInput();
 }
 
 Window::Window(GLint windowWidth, GLint windowHeight)
 {
 	width = windowWidth;
 	height = windowHeight;
+	initialiseInput();
+}
+
+void Window::initialiseInput()
+{
 	deltaX = 0.0f;
 	deltaY = 0.0f;
+	initialMouseMove = true;
+	hasDeferredRelease = false;
+	cursorEventTime = -1.0;
 
 	for (int i = 0; i < 1024; i++) {
 		keys[i] = 0;
+		pressedThisFrame[i] = false;
 	}
+
+	eventCount = 0;
+	droppedEvents = 0;
+	maxWaiting = 0;
+	eventAgeSeconds = 0.0;
 }
 
 int Window::initialise()
@@ -77,6 +87,7 @@ void Window::createCallbacks() {
 	glfwSetKeyCallback(mainWindow, handleKeys); // When a key is pressed in window, handle input
 	glfwSetCursorPosCallback(mainWindow, handleMouse);
 	glfwSetMouseButtonCallback(mainWindow, handleMouseButtons);
+	glfwSetWindowRefreshCallback(mainWindow, handleRefresh);
 }
 
 void Window::handleKeys(GLFWwindow* window, int key, int code, int action, int mode) {
@@ -87,13 +98,10 @@ void Window::handleKeys(GLFWwindow* window, int key, int code, int action, int m
 		glfwSetWindowShouldClose(window, GL_TRUE);
 	}
 
-	if (key >= 0 && key < 1024) {
-		if (action == GLFW_PRESS) {
-			theWindow->keys[key] = true;
-		}
-		else if (action == GLFW_RELEASE) {
-			theWindow->keys[key] = false;
-		}
+	// Repeats change nothing, a key is held from its press to its release
+	if (key >= 0 && key < 1024 && action != GLFW_REPEAT) {
+		InputEvent event = { glfwGetTime(), InputEvent::KEY, key, action, 0.0f, 0.0f };
+		theWindow->pushEvent(event);
 	}
 
 }
@@ -102,17 +110,8 @@ void Window::handleMouse(GLFWwindow* window, double x, double y) {
 
 	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
 
-	if (theWindow->initialMouseMove) {
-		theWindow->lastX = x;
-		theWindow->lastY = y;
-		theWindow->initialMouseMove = false;
-	}
-
-	theWindow->deltaX = x - theWindow->lastX;
-	theWindow->deltaY = theWindow->lastY - y;
-
-	theWindow->lastX = x;
-	theWindow->lastY = y;
+	InputEvent event = { glfwGetTime(), InputEvent::CURSOR, 0, 0, (float)x, (float)y };
+	theWindow->pushEvent(event);
 
 }
 
@@ -120,15 +119,97 @@ void Window::handleMouseButtons(GLFWwindow* window, int button, int action, int
 {
 	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
 	if (button >= 0 && button < 1024) {
-		if (action == GLFW_PRESS) {
-			theWindow->keys[button] = true;
+		InputEvent event = { glfwGetTime(), InputEvent::KEY, button, action, 0.0f, 0.0f };
+		theWindow->pushEvent(event);
+	}
+}
+
+void Window::pushEvent(const InputEvent& event)
+{
+	// A full queue means the frames stopped, losing a cursor move or two then does no harm.
+	if (!events.Push(event))
+		droppedEvents++;
+	Redraw::Request();
+}
+
+void Window::consumeEvents()
+{
+	// The mouse movement of the frame is the sum of the moves since the last one.
+	deltaX = 0.0f;
+	deltaY = 0.0f;
+	cursorEventTime = -1.0;
+
+	int waiting = (int)events.Size() + (hasDeferredRelease ? 1 : 0);
+	maxWaiting = waiting > maxWaiting ? waiting : maxWaiting;
+
+	if (hasDeferredRelease) {
+		hasDeferredRelease = false;
+		applyEvent(deferredRelease);
+	}
+
+	for (int i = 0; i < 1024; i++) {
+		pressedThisFrame[i] = false;
+	}
+
+	double now = glfwGetTime();
+	InputEvent event;
+	while (events.Pop(event)) {
+		eventCount++;
+		eventAgeSeconds += now - event.time;
+
+		// A tap shorter than a frame would otherwise never be seen held. The release waits for the next frame, and
+		// the events after it too, to keep them in order.
+		if (event.type == InputEvent::KEY && event.action == GLFW_RELEASE && pressedThisFrame[event.key]) {
+			deferredRelease = event;
+			hasDeferredRelease = true;
+			Redraw::Request();
+			break;
 		}
-		else if (action == GLFW_RELEASE) {
-			theWindow->keys[button] = false;
+		applyEvent(event);
+	}
+}
+
+void Window::applyEvent(const InputEvent& event)
+{
+	if (event.type == InputEvent::CURSOR) {
+		if (initialMouseMove) {
+			lastX = event.x;
+			lastY = event.y;
+			initialMouseMove = false;
 		}
+
+		deltaX += event.x - lastX;
+		deltaY += lastY - event.y;
+
+		lastX = event.x;
+		lastY = event.y;
+		cursorEventTime = event.time;
+		return;
+	}
+
+	// Whatever a held key does, it may do it every step, so frames are drawn for as long as it is held.
+	if (event.action == GLFW_PRESS && !keys[event.key]) {
+		keys[event.key] = true;
+		pressedThisFrame[event.key] = true;
+		Redraw::BeginAnimation();
+	}
+	else if (event.action == GLFW_RELEASE && keys[event.key]) {
+		keys[event.key] = false;
+		Redraw::EndAnimation();
 	}
 }
 
+void Window::printStatistics()
+{
+	printf("Input: %d events, %d dropped, %d waiting at most, %.2f ms waited on average\n",
+		eventCount, droppedEvents, maxWaiting, eventCount > 0 ? eventAgeSeconds * 1000.0 / eventCount : 0.0);
+}
+
+void Window::handleRefresh(GLFWwindow*)
+{
+	Redraw::Request(); // Uncovered or resized
+}
+
 
 Window::~Window()
 {
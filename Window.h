@@ -5,6 +5,22 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include "SpscQueue.h"
+
+/// <summary>
+/// An input event as GLFW gave it, with the time it arrived
+/// </summary>
+struct InputEvent
+{
+	enum Type { KEY, CURSOR };
+
+	double time; // glfwGetTime when the callback ran
+	Type type;
+	int key; // Key or mouse button
+	int action; // GLFW_PRESS or GLFW_RELEASE
+	float x, y; // Cursor position
+};
+
 class Window
 {
 public:
@@ -60,11 +76,34 @@ public:
 	/// <returns>A GLfloat</returns>
 	GLfloat getDeltaY() { return deltaY; }
 
+	/// <summary>
+	/// Applies the input events received since the last frame: the keys held, and the mouse movement summed up.
+	/// Called once per frame, before reading the keys or the mouse
+	/// </summary>
+	void consumeEvents();
+
+	/// <summary>
+	/// Gets the time of the last cursor movement applied by consumeEvents
+	/// </summary>
+	/// <returns>A time from glfwGetTime, or a negative value if the mouse did not move this frame</returns>
+	double getCursorEventTime() { return cursorEventTime; }
+
+	/// <summary>
+	/// Prints the number of input events, those dropped, the most waiting at once and how long they waited
+	/// </summary>
+	void printStatistics();
+
 	/// <summary>
 	/// Calls glfwSwapBuffers
 	/// </summary>
 	void swapBuffers() { glfwSwapBuffers(mainWindow); }
 
+	/// <summary>
+	/// Makes the GL context of the window current on the calling thread, or releases it so another thread can take it
+	/// </summary>
+	/// <param name="current">True to make it current, false to release it</param>
+	void setContextCurrent(bool current) { glfwMakeContextCurrent(current ? mainWindow : NULL); }
+
 	///<summary>
 	/// Deconstructor
 	/// </summary>
@@ -121,6 +160,31 @@ private:
 	/// </summary>
 	bool initialMouseMove;
 
+	/// <summary>
+	/// The events pushed by the callbacks, waiting for consumeEvents
+	/// </summary>
+	SpscQueue<InputEvent, 256> events;
+	/// <summary>
+	/// A release held back to the next frame, the press before it arrived in the same frame
+	/// </summary>
+	InputEvent deferredRelease;
+	/// <summary>
+	/// Whether or not deferredRelease holds an event
+	/// </summary>
+	bool hasDeferredRelease;
+	/// <summary>
+	/// The keys pressed during the current consumeEvents
+	/// </summary>
+	bool pressedThisFrame[1024];
+	/// <summary>
+	/// The time of the last cursor movement applied, negative if there was none this frame
+	/// </summary>
+	double cursorEventTime;
+
+	// Statistics
+	int eventCount, droppedEvents, maxWaiting;
+	double eventAgeSeconds;
+
 	/// <summary>
 	/// Callback function to handle key presses
 	/// </summary>
@@ -146,6 +210,25 @@ private:
 	/// <param name="mods"></param>
 	static void handleMouseButtons(GLFWwindow* window, int button, int action, int mods);
 	/// <summary>
+	/// Callback function to handle the window needing to be drawn again
+	/// </summary>
+	/// <param name="window">The window</param>
+	static void handleRefresh(GLFWwindow* window);
+	/// <summary>
+	/// Queues an input event for consumeEvents, counting it as dropped if the queue is full
+	/// </summary>
+	/// <param name="event">The event</param>
+	void pushEvent(const InputEvent& event);
+	/// <summary>
+	/// Applies one input event to the keys or the mouse movement
+	/// </summary>
+	/// <param name="event">The event</param>
+	void applyEvent(const InputEvent& event);
+	/// <summary>
+	/// Sets the state every constructor starts with
+	/// </summary>
+	void initialiseInput();
+	/// <summary>
 	/// Calls all callback functions
 	/// </summary>
 	void createCallbacks();
@@ -1,21 +1,48 @@
 #version 330
 
-out vec4 FragColor;			
+out vec4 FragColor;
 
+#ifdef VERTEX_COLOUR
 in vec3 vertexColor;
+#endif
+
+#ifdef TEXTURED
+in vec2 texCoord;
+
+uniform sampler2D theTexture;
+#endif
+
+#ifdef TEXTURE_ARRAY
 in vec2 texCoord;
+flat in float textureLayer;
+
+uniform sampler2DArray theTextures;
+#endif
 
+#ifdef LIT
 struct DirectionalLight 
 {
 	vec3 colour;
 	float ambientIntensity;
 };
 
-uniform sampler2D theTexture;
 uniform DirectionalLight dl;
+#endif
 
-void main()				
-{					
-    vec4 ambientColour = vec4(dl.colour, 1.0f) * dl.ambientIntensity;
-    FragColor = texture(theTexture, texCoord);
-}														
\ No newline at end of file
+void main()
+{
+	vec4 colour = vec4(1.0);
+#ifdef VERTEX_COLOUR
+	colour *= vec4(vertexColor, 1.0);
+#endif
+#ifdef TEXTURED
+	colour *= texture(theTexture, texCoord);
+#endif
+#ifdef TEXTURE_ARRAY
+	colour *= texture(theTextures, vec3(texCoord, textureLayer));
+#endif
+#ifdef LIT
+	colour *= vec4(dl.colour, 1.0) * dl.ambientIntensity;
+#endif
+	FragColor = colour;
+}
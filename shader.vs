@@ -1,19 +1,65 @@
-#version 330 core					
+#version 330 core
+#extension GL_ARB_explicit_uniform_location : enable
 
-layout (location = 0) in vec3 aPos;									
+// Compiled once per set of features (see ShaderFeature), which define TEXTURED, VERTEX_COLOUR, INSTANCED, LIT and
+// TEXTURE_ARRAY.
 
-out vec3 vertexColor;									
+#include "transform.glsl"
 
-uniform mat4 model;
-uniform mat4 projection;
-uniform mat4 view;
+layout (location = 0) in vec3 aPos;
+
+#ifdef INSTANCED
+layout (location = 2) in vec4 instanceOffset; // xyz is the position of the glyph, w the index of the part
+layout (location = 3) in vec4 instanceColour;
+
+// Every instance is one glyph part of a TextRenderer: its matrix comes from the part table.
+layout (std140) uniform GlyphParts
+{
+	mat4 partMatrices[256];
+};
+#endif
+
+#ifdef VERTEX_COLOUR
+out vec3 vertexColor;
 
 uniform float r;
 uniform float rg;
 uniform float rgb;
+#endif
+
+#if defined(TEXTURED) || defined(TEXTURE_ARRAY)
+out vec2 texCoord;
+#endif
 
-void main()											
+#ifdef TEXTURE_ARRAY
+// Constant for a whole object, or one per instance (see TextureArray).
+layout (location = 4) in float layer;
+flat out float textureLayer;
+#endif
+
+void main()
 {
-	gl_Position = projection * view * model * vec4(aPos.x, aPos.y, aPos.z, 1.0);	
-	vertexColor = vec3(r, rg, rgb);							
-}														
\ No newline at end of file
+#ifdef INSTANCED
+	vec4 partPosition = partMatrices[int(instanceOffset.w)] * vec4(aPos, 1.0);
+	gl_Position = projection * view * model * vec4(partPosition.xyz + instanceOffset.xyz, 1.0);
+#else
+	gl_Position = projection * view * model * vec4(aPos.x, aPos.y, aPos.z, 1.0);
+#endif
+
+#ifdef VERTEX_COLOUR
+#ifdef INSTANCED
+	vertexColor = instanceColour.rgb;
+#else
+	vertexColor = vec3(r, rg, rgb);
+#endif
+#endif
+
+#if defined(TEXTURED) || defined(TEXTURE_ARRAY)
+	// Meshes have no texture coordinates, the texture is projected along Z in object space.
+	texCoord = aPos.xy;
+#endif
+
+#ifdef TEXTURE_ARRAY
+	textureLayer = layer;
+#endif
+}
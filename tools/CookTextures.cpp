@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "../TextureCooker.h"
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Offline cooker of the textures.													//
+// Writes each image given as a cooked texture next to it (Textures/stone.jpg		//
+// gives Textures/stone.ctex), with its mipmaps, which Texture and TextureArray	//
+// load instead of the image. The format is chosen from the image unless			//
+// -rgba, -bc1 or -bc3 comes first.													//
+// Build it with TextureCooker.cpp, CookedTexture.cpp, BlockCompression.cpp and		//
+// MappedFile.cpp, and run it again whenever a texture changes.						//
+//////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: CookTextures [-rgba|-bc1|-bc3] image...\n");
+		return 1;
+	}
+
+	CookedFormat format = COOKED_BC1;
+	bool automatic = true;
+	int failures = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-rgba") == 0 || strcmp(argv[i], "-bc1") == 0 || strcmp(argv[i], "-bc3") == 0)
+		{
+			format = argv[i][1] == 'r' ? COOKED_RGBA8 : argv[i][3] == '1' ? COOKED_BC1 : COOKED_BC3;
+			automatic = false;
+			continue;
+		}
+
+		std::string cookedPath = CookedTexture::GetCookedPath(argv[i]);
+		if (TextureCooker::CookFile(argv[i], cookedPath, format, automatic))
+		{
+			// Mapping it back the way the application will.
+			CookedTexture cooked;
+			if (cooked.Open(cookedPath))
+				printf("%s: %dx%d, %d levels\n", cookedPath.c_str(), cooked.GetWidth(), cooked.GetHeight(), cooked.GetLevelCount());
+			else
+				failures++;
+		}
+		else
+		{
+			failures++;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "../DefaultScene.h"
+#include "../SceneBlob.h"
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Offline baker of the default scene.												//
+// Runs the scene builders once and writes the result as SceneBlobData.h, which	//
+// the application embeds and loads instead of building the scene at startup.		//
+// Given any other path than a .h file, it writes a scene file instead, and maps	//
+// it back to check it loads.														//
+// Build it with the sources of the application except Main.cpp, and run it again	//
+// whenever the letters, the axes or the grid change.								//
+//////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	const char* path = argc > 1 ? argv[1] : "SceneBlobData.h";
+
+	// The builders upload their meshes, so they need a context, but nothing is shown.
+	if (!glfwInit())
+	{
+		printf("GLFW initialisation failed!\n");
+		return 1;
+	}
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+	GLFWwindow* window = glfwCreateWindow(64, 64, "SceneBaker", NULL, NULL);
+	if (window == NULL)
+	{
+		printf("GLFW window creation failed!\n");
+		glfwTerminate();
+		return 1;
+	}
+	glfwMakeContextCurrent(window);
+
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK)
+	{
+		printf("GLEW initialisation failed!\n");
+		glfwTerminate();
+		return 1;
+	}
+
+	std::vector<Mesh*> meshes;
+	std::vector<ComplexObject*> objects;
+	CreateDefaultScene(0, meshes, objects);
+
+	std::string output = path;
+	bool header = output.size() > 2 && output.compare(output.size() - 2, 2, ".h") == 0;
+
+	std::vector<unsigned char> blob = SceneBlob::Build(meshes, objects);
+	bool written = !blob.empty() && (header ? SceneBlob::WriteHeaderFile(blob, output) : SceneBlob::WriteFile(blob, output));
+	if (written)
+	{
+		printf("Baked the default scene into %s (%u bytes)\n", path, (unsigned int)blob.size());
+	}
+
+	if (written && !header)
+	{
+		std::vector<Mesh*> loadedMeshes;
+		std::vector<ComplexObject*> loadedObjects;
+		SceneBlob scene;
+
+		auto start = std::chrono::steady_clock::now();
+		written = scene.LoadFile(output, 0, 0, loadedMeshes, loadedObjects);
+		glFinish(); // Count the upload as well
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (written)
+		{
+			printf("Loaded it back in %.2f ms\n", milliseconds);
+		}
+		scene.Clear();
+	}
+
+	primitives.Clear();
+	glfwTerminate();
+	return written ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+// Transformation of every vertex shader. The locations are fixed where the driver allows it, so every variant of a
+// shader takes the model matrix at the same location, and meshes keep a single location for it.
+#ifdef GL_ARB_explicit_uniform_location
+layout (location = 0) uniform mat4 model;
+#else
+uniform mat4 model;
+#endif
+
+// The camera of the frame, written once for every program just before drawing (see CameraBuffer).
+layout (std140) uniform CameraBlock
+{
+	mat4 projection;
+	mat4 view;
+};